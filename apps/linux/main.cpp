@@ -0,0 +1,273 @@
+// CaravanOS Hub (Linux): Geräte aus der Konfiguration -> Geräte-Bus ->
+// Prioritäts-Lanes -> App-Bus (seq-Prüfung) -> Senken (Snapshot, Historie).
+//
+//   caravan_hub [-c devices.conf] [-s stats_ms] [-d duration_ms]
+//
+// Ohne -c läuft eine eingebaute Demo-Konfiguration gegen den simulierten
+// Modbus (hal_make_modbus, posix: DummyModbus), headless, z.B. für
+// End-to-End-Messungen. Die Hauptschleife schläft in poll() bis zur nächsten
+// Zustellung (eventfd) oder zum nächsten Bericht; die Bus-Stränge der
+// DeviceRegistry schlafen bis zum nächsten fälligen Gerät.
+// SIGTERM/SIGINT: Geräte anhalten, ausstehende Metriken zustellen,
+// Abschlussbericht, Exit-Code 0.
+#include <poll.h>
+#include <signal.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <core/columnar_snapshot.h>
+#include <core/metric_bus.h>
+#include <core/metric_history.h>
+#include <core/priority_lanes.h>
+#include <core/metric.h>
+
+#include "clock.h"
+#include "device_registry.h"
+#include "modbus.h"
+
+using namespace core;
+
+namespace {
+
+// zwei simulierte Busse, feste und adaptive Poll-Intervalle
+const char* kDemoConfig =
+    "# <type> <bus> <instance> [key=value ...]\n"
+    "wt901c rs485-0 1 addr=0x50 poll=20\n"
+    "wt901c rs485-0 2 addr=0x51 poll=50\n"
+    "wt901c rs485-0 3 addr=0x52 poll=100\n"
+    "wt901c rs485-0 4 addr=0x53 adaptive=1 poll_min=50 poll_max=500\n"
+    "wt901c rs485-1 5 addr=0x50 poll=20\n"
+    "wt901c rs485-1 6 addr=0x51 poll=50\n"
+    "wt901c rs485-1 7 addr=0x52 poll=100\n"
+    "wt901c rs485-1 8 addr=0x53 adaptive=1 poll_min=50 poll_max=500\n";
+
+struct Args {
+  std::string config;          // leer = Demo
+  uint32_t    stats_ms{5000};
+  uint32_t    duration_ms{0};  // 0 = bis SIGTERM
+};
+
+bool parse_args(int argc, char** argv, Args& a) {
+  for (int i = 1; i < argc; ++i) {
+    const bool has_val = i + 1 < argc;
+    if (!std::strcmp(argv[i], "-c") && has_val)      a.config      = argv[++i];
+    else if (!std::strcmp(argv[i], "-s") && has_val) a.stats_ms    = std::strtoul(argv[++i], nullptr, 10);
+    else if (!std::strcmp(argv[i], "-d") && has_val) a.duration_ms = std::strtoul(argv[++i], nullptr, 10);
+    else return false;
+  }
+  return a.stats_ms > 0;
+}
+
+// Geräte-Bus -> Lanes; weckt die Hauptschleife über das eventfd
+struct Intake {
+  LaneDispatcher&       lanes;
+  int                   efd;
+  std::atomic<uint64_t> total{0};
+  std::atomic<bool>     wake_pending{false};
+
+  void post(const Metric& m) {
+    lanes.post(m);
+    total.fetch_add(1, std::memory_order_relaxed);
+    // nur beim Übergang leer -> ausstehend wecken
+    if (!wake_pending.exchange(true)) {
+      const uint64_t one = 1;
+      (void)!write(efd, &one, sizeof(one));
+    }
+  }
+};
+
+// Lane-Statistik aller Lanes zusammengefasst (Histogramme addiert)
+LaneDispatcher::LaneStats merged(const LaneDispatcher& lanes) {
+  LaneDispatcher::LaneStats all;
+  for (std::size_t p = 0; p < kPriorityCount; ++p) {
+    const auto s = lanes.stats(static_cast<Priority>(p));
+    all.posted     += s.posted;
+    all.delivered  += s.delivered;
+    all.dropped    += s.dropped;
+    all.lat_sum_ns += s.lat_sum_ns;
+    all.lat_max_ns  = std::max(all.lat_max_ns, s.lat_max_ns);
+    for (std::size_t b = 0; b < all.lat_hist.size(); ++b) all.lat_hist[b] += s.lat_hist[b];
+  }
+  return all;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Args args;
+  if (!parse_args(argc, argv, args)) {
+    std::fprintf(stderr, "usage: %s [-c devices.conf] [-s stats_ms] [-d duration_ms]\n", argv[0]);
+    return 2;
+  }
+
+  std::string conf_text = kDemoConfig;
+  if (!args.config.empty()) {
+    std::ifstream f(args.config);
+    if (!f) {
+      std::fprintf(stderr, "cannot open %s\n", args.config.c_str());
+      return 1;
+    }
+    std::ostringstream ss;
+    ss << f.rdbuf();
+    conf_text = ss.str();
+  }
+
+  // Signale vor dem Start der Threads sperren (vererbt sich), Empfang über signalfd
+  sigset_t sigs;
+  sigemptyset(&sigs);
+  sigaddset(&sigs, SIGTERM);
+  sigaddset(&sigs, SIGINT);
+  pthread_sigmask(SIG_BLOCK, &sigs, nullptr);
+  const int sfd = signalfd(-1, &sigs, SFD_CLOEXEC);
+  const int efd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (sfd < 0 || efd < 0) {
+    std::perror("signalfd/eventfd");
+    return 1;
+  }
+
+  std::unique_ptr<IClock> clock = hal_make_clock();
+  if (!clock) {
+    std::fprintf(stderr, "no clock available\n");
+    return 1;
+  }
+
+  // Geräte-Bus (Stränge publizieren) -> Lanes -> App-Bus (Hauptschleife stellt zu)
+  MetricBus device_bus;
+  MetricBus::Options app_opt;
+  app_opt.track_seq = true;
+  MetricBus app_bus(app_opt);
+  LaneDispatcher lanes(app_bus);
+
+  // ein Zeiger als Capture (statisches Profil: CARAVAN_CALLBACK_BYTES)
+  Intake intake{lanes, efd};
+  auto feed = device_bus.subscribe([&intake](const Metric& m) { intake.post(m); });
+
+  uint64_t out_total = 0;
+  auto count = app_bus.subscribe([&out_total](const Metric&) { ++out_total; });
+  ColumnarSnapshot snapshot(app_bus);
+  MetricHistory    history(app_bus, MetricHistory::Config{});
+
+  // Busse aus der Konfiguration, je ein simulierter Modbus
+  devices::DeviceRegistry::Config reg_cfg;
+  reg_cfg.max_idle_ms = 1000;   // bis zum nächsten fälligen Gerät schlafen
+  devices::DeviceRegistry registry(device_bus, *clock, reg_cfg);
+  std::map<std::string, std::unique_ptr<IModbusClient>> buses;
+  {
+    std::istringstream in(conf_text);
+    std::string line;
+    while (std::getline(in, line)) {
+      const auto hash = line.find('#');
+      if (hash != std::string::npos) line.erase(hash);
+      devices::DeviceSpec spec;
+      if (!devices::DeviceRegistry::parse_spec(line, spec)) continue;   // Fehler meldet load_config
+      if (buses.count(spec.bus)) continue;
+      auto client = hal_make_modbus();
+      if (!client) {
+        std::fprintf(stderr, "no modbus backend for bus %s\n", spec.bus.c_str());
+        return 1;
+      }
+      registry.add_bus(spec.bus, *client);
+      buses.emplace(spec.bus, std::move(client));
+    }
+  }
+  std::string err;
+  std::istringstream in(conf_text);
+  if (!registry.load_config(in, &err)) {
+    std::fprintf(stderr, "%s: %s\n", args.config.empty() ? "demo config" : args.config.c_str(), err.c_str());
+    return 1;
+  }
+
+  std::printf("CaravanOS hub: %zu devices on %zu buses (%s), stats every %u ms\n",
+              registry.device_count(), buses.size(),
+              args.config.empty() ? "demo config" : args.config.c_str(), args.stats_ms);
+  std::fflush(stdout);
+
+  const uint64_t t0 = clock->millis64();
+  registry.start();
+
+  uint64_t next_stats = t0 + args.stats_ms;
+  uint64_t in_last = 0, out_last = 0, dropped_before = 0;
+  const auto report = [&](uint64_t now, uint64_t span_ms, bool final) {
+    const auto ls = merged(lanes);
+    const auto sq = app_bus.seq_stats();
+    const auto hs = history.stats();
+    const uint64_t in = intake.total.load(), out = out_total;
+    const double   s  = span_ms ? span_ms / 1000.0 : 1.0;
+    snapshot.commit();
+    std::printf("[%8.1fs] %sonline %zu/%zu  in %.0f/s  out %.0f/s  lane p50<=%.1fus p99<=%.1fus max %.1fus"
+                "  dropped %llu  seq lost %llu dup %llu  history %llu pts %.1f KiB\n",
+                (now - t0) / 1000.0, final ? "final " : "", registry.online_count(), registry.device_count(),
+                (in - in_last) / s, (out - out_last) / s,
+                ls.percentile_ns(0.50) / 1000.0, ls.percentile_ns(0.99) / 1000.0, ls.lat_max_ns / 1000.0,
+                static_cast<unsigned long long>(dropped_before + ls.dropped), static_cast<unsigned long long>(sq.lost),
+                static_cast<unsigned long long>(sq.duplicates), static_cast<unsigned long long>(hs.points),
+                hs.bytes / 1024.0);
+    std::fflush(stdout);
+    in_last  = in;
+    out_last = out;
+  };
+
+  // Ereignisschleife: schläft bis Zustellung, Signal oder nächstem Bericht
+  const char* reason = "duration elapsed";
+  for (;;) {
+    uint64_t now = clock->millis64();
+    if (args.duration_ms && now - t0 >= args.duration_ms) break;
+    if (now >= next_stats) {
+      report(now, args.stats_ms, false);
+      dropped_before += merged(lanes).dropped;
+      lanes.reset_stats();   // Latenz pro Intervall
+      next_stats += args.stats_ms;
+      continue;
+    }
+    uint64_t deadline = next_stats;
+    if (args.duration_ms) deadline = std::min(deadline, t0 + args.duration_ms);
+
+    pollfd fds[2] = {{sfd, POLLIN, 0}, {efd, POLLIN, 0}};
+    const int n = poll(fds, 2, static_cast<int>(deadline - now));
+    if (n < 0) continue;   // EINTR
+    if (fds[0].revents & POLLIN) {
+      signalfd_siginfo si;
+      (void)!read(sfd, &si, sizeof(si));
+      reason = si.ssi_signo == SIGTERM ? "SIGTERM" : "SIGINT";
+      break;
+    }
+    if (fds[1].revents & POLLIN) {
+      uint64_t v;
+      (void)!read(efd, &v, sizeof(v));
+      intake.wake_pending.store(false);   // vor drain(): spätere post() wecken erneut
+      lanes.drain();
+    }
+  }
+
+  // Abbau: keine neuen Metriken mehr, dann alles Ausstehende zustellen
+  std::printf("%s: stopping devices, draining %zu in-flight metrics\n", reason, lanes.pending());
+  registry.stop();
+  feed.unsubscribe();
+  std::size_t drained = 0;
+  while (lanes.pending()) drained += lanes.drain();
+
+  const uint64_t end = clock->millis64();
+  out_last = in_last = 0;
+  report(end, end - t0, true);
+  const auto sq = app_bus.seq_stats();
+  std::printf("drained %zu, delivered %llu of %llu, loss ratio %.4f\n", drained,
+              static_cast<unsigned long long>(out_total), static_cast<unsigned long long>(intake.total.load()),
+              sq.loss_ratio());
+
+  close(efd);
+  close(sfd);
+  return 0;
+}
@@ -0,0 +1,86 @@
+// Ganzzustands-Scans: letzter Wert pro Schlüssel als Metric-Objekte in einer
+// Hash-Map (bisheriger Weg für UI/Export) gegen ColumnarSnapshot-Frames.
+//   bench_columnar_snapshot [metrics] [rounds]
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_map>
+#include <vector>
+
+#include <core/columnar_snapshot.h>
+#include <core/metric_record.h>
+#include <core/metric.h>
+#include <core/enums.h>
+#include <core/ids.h>
+
+#include "bench_util.h"
+
+using namespace core;
+
+namespace {
+Metric mk(uint32_t inst, float v, uint64_t ts) {
+  Metric::PropMap p;
+  p.emplace(PropertyKey::Unit,    static_cast<uint8_t>(Unit::Celsius));
+  p.emplace(PropertyKey::Quality, static_cast<uint8_t>(Quality::Good));
+  return Metric::Make(inst, MetricID::Temperature, v, ts, 1, std::move(p));
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t metrics = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+  const std::size_t rounds  = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000;
+
+  std::unordered_map<uint32_t, Metric> last;
+  ColumnarSnapshot snap;
+  for (uint32_t i = 0; i < metrics; ++i) {
+    const Metric m = mk(i, float(i), 1000 + i);
+    last.insert_or_assign(i, m);
+    snap.update(m);
+  }
+  auto frame = snap.commit();
+  const uint64_t now = 1000 + metrics / 2 + 5000;
+
+  std::printf("Whole-state scans: %zu metrics, %zu rounds\n", metrics, rounds);
+
+  std::size_t hits = 0;
+  uint64_t t0 = bench::now_ns();
+  for (std::size_t r = 0; r < rounds; ++r)
+    for (auto const& [k, m] : last) hits += m.timestamp_ms() + 5000 < now;
+  uint64_t dt = bench::now_ns() - t0;
+  bench::row("count stale, map<Metric>", double(dt) / rounds, rounds * 1e9 / dt);
+
+  t0 = bench::now_ns();
+  for (std::size_t r = 0; r < rounds; ++r) hits += frame->count_stale(now, 5000);
+  dt = bench::now_ns() - t0;
+  bench::row("count stale, columnar", double(dt) / rounds, rounds * 1e9 / dt);
+
+  std::vector<MetricRecord> recs;
+  recs.reserve(metrics);
+  t0 = bench::now_ns();
+  for (std::size_t r = 0; r < rounds; ++r) {
+    recs.clear();
+    for (auto const& [k, m] : last) recs.push_back(to_record(m));
+  }
+  dt = bench::now_ns() - t0;
+  bench::row("export records, map<Metric>", double(dt) / rounds, rounds * 1e9 / dt);
+
+  t0 = bench::now_ns();
+  for (std::size_t r = 0; r < rounds; ++r) frame->to_records(recs);
+  dt = bench::now_ns() - t0;
+  bench::row("export records, columnar", double(dt) / rounds, rounds * 1e9 / dt);
+  frame.reset();
+
+  // Schreiberseite: 10 % der Werte ändern sich pro Runde, dann commit
+  const std::size_t changed = metrics / 10 + 1;
+  const Metric upd = mk(0, 1.0f, 2000);
+  t0 = bench::now_ns();
+  for (std::size_t r = 0; r < rounds; ++r) {
+    for (std::size_t i = 0; i < changed; ++i) snap.update(upd);
+    bench::keep(snap.commit());
+  }
+  dt = bench::now_ns() - t0;
+  bench::row("update 10% + commit", double(dt) / rounds, rounds * 1e9 / dt);
+
+  bench::keep(hits);
+  bench::keep(recs);
+  return 0;
+}
@@ -0,0 +1,108 @@
+// Socket-Gateway: viele Unix-Clients an einem Gateway-Thread.
+// Ein Leser-Thread bedient alle Client-Sockets per poll(); gemessen wird,
+// wie lange es dauert, bis jeder Client alle Records bekommen hat.
+//   bench_gateway [clients] [records]
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <ipc/gateway.h>
+#include <core/metric_bus.h>
+#include <core/metric.h>
+#include <core/ids.h>
+
+#include "bench_util.h"
+
+using namespace core;
+
+namespace {
+
+int connect_unix(const std::string& path) {
+  const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un a{};
+  a.sun_family = AF_UNIX;
+  std::strncpy(a.sun_path, path.c_str(), sizeof(a.sun_path) - 1);
+  if (::connect(fd, reinterpret_cast<sockaddr*>(&a), sizeof(a)) != 0) { ::close(fd); return -1; }
+  return fd;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t clients = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 256;
+  const uint32_t    records = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 20000;
+
+  MetricBus bus;
+  ipc::Gateway::Config cfg;
+  cfg.unix_path        = "/tmp/caravan_bench_gw_" + std::to_string(::getpid()) + ".sock";
+  cfg.max_clients      = clients;
+  cfg.out_buffer_bytes = 4 << 20;   // Messung ohne Disconnect/Conflation
+  cfg.max_latency_ms   = 2;
+  ipc::Gateway gw(bus, cfg);
+  std::string err;
+  if (!gw.start(&err)) { std::fprintf(stderr, "gateway: %s\n", err.c_str()); return 1; }
+  std::thread loop([&] { gw.run(); });
+
+  std::vector<pollfd> fds;
+  const auto filter = ipc::proto::encode_filter({{ipc::proto::kAnyMetric, 0, ipc::proto::kAnyInstance}});
+  for (std::size_t i = 0; i < clients; ++i) {
+    const int fd = connect_unix(cfg.unix_path);
+    if (fd < 0) { std::fprintf(stderr, "connect failed at client %zu\n", i); break; }
+    (void)!::send(fd, filter.data(), filter.size(), 0);
+    fds.push_back(pollfd{fd, POLLIN, 0});
+  }
+  while (gw.stats().clients < fds.size()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));   // Filter verarbeitet
+
+  // Nur Bytes zählen: alle Records sind gleich groß
+  const uint64_t want = uint64_t{records} * sizeof(MetricRecord);
+  std::vector<uint64_t> got(fds.size(), 0);
+  std::size_t done = 0;
+  std::thread reader([&] {
+    std::vector<uint8_t> buf(64 * 1024);
+    while (done < fds.size()) {
+      if (::poll(fds.data(), fds.size(), 1000) <= 0) break;
+      for (std::size_t i = 0; i < fds.size(); ++i) {
+        if (!(fds[i].revents & POLLIN)) continue;
+        const ssize_t r = ::recv(fds[i].fd, buf.data(), buf.size(), 0);
+        if (r <= 0) { fds[i].events = 0; continue; }
+        got[i] += static_cast<uint64_t>(r);
+      }
+      // Header mitgezählt: fertig, sobald mindestens alle Record-Bytes da sind
+      done = 0;
+      for (std::size_t i = 0; i < fds.size(); ++i) done += got[i] >= want;
+    }
+  });
+
+  const uint64_t t0 = bench::now_ns();
+  for (uint32_t i = 1; i <= records; ++i)
+    bus.publish(Metric::Make(i % 64, MetricID::Temperature, static_cast<float>(i), i, i, {}));
+  const uint64_t t_pub = bench::now_ns() - t0;
+  reader.join();
+  const uint64_t t_all = bench::now_ns() - t0;
+
+  const auto st = gw.stats();
+  std::printf("clients=%zu records=%u\n", fds.size(), records);
+  bench::row("publish (bus -> gateway inbox)", double(t_pub) / records, records * 1e9 / t_pub);
+  bench::row("fan-out (records x clients delivered)", double(t_all) / (double(records) * fds.size()),
+             double(records) * fds.size() * 1e9 / t_all);
+  std::printf("frames=%llu records_sent=%llu avg_batch=%.1f conflated=%llu slow_disconnects=%llu\n",
+              static_cast<unsigned long long>(st.frames_sent),
+              static_cast<unsigned long long>(st.records_sent),
+              st.frames_sent ? double(st.records_sent) / st.frames_sent : 0.0,
+              static_cast<unsigned long long>(st.conflated),
+              static_cast<unsigned long long>(st.slow_disconnects));
+
+  for (auto& p : fds) ::close(p.fd);
+  gw.stop();
+  loop.join();
+  return 0;
+}
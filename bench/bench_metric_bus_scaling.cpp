@@ -0,0 +1,67 @@
+// Publish-Durchsatz mit 1..N Publisher-Threads, ein Lock vs. Sharding.
+//   bench_metric_bus_scaling [publishes_per_thread] [max_threads]
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <core/metric_bus.h>
+#include <core/metric.h>
+#include <core/ids.h>
+
+#include "bench_util.h"
+
+using namespace core;
+
+namespace {
+
+thread_local uint64_t tl_received = 0;
+
+double run(MetricBus& bus, unsigned threads, std::size_t per_thread) {
+  std::atomic<unsigned> ready{0};
+  std::atomic<bool>     go{false};
+  std::vector<std::thread> pubs;
+  for (unsigned t = 0; t < threads; ++t) {
+    pubs.emplace_back([&, t] {
+      // jede Instanz gehört genau einem Thread (wie ein Device)
+      const Metric m = Metric::Make(1000 + t, MetricID::TiltAngle, 1.0f, 0, 1, {});
+      ready.fetch_add(1);
+      while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+      for (std::size_t i = 0; i < per_thread; ++i) bus.publish(m);
+    });
+  }
+  while (ready.load() != threads) std::this_thread::yield();
+  const uint64_t t0 = bench::now_ns();
+  go.store(true, std::memory_order_release);
+  for (auto& th : pubs) th.join();
+  const uint64_t dt = bench::now_ns() - t0;
+  return double(threads) * double(per_thread) * 1e9 / double(dt);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t per_thread = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200'000;
+  const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+  const unsigned max_threads = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : hw;
+
+  std::printf("MetricBus scaling: %zu publishes/thread, 4 subscribers, %u hw threads\n", per_thread, hw);
+  std::printf("%8s %18s %18s\n", "threads", "1 shard [Mpub/s]", "sharded [Mpub/s]");
+
+  for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+    MetricBus single;
+    MetricBus sharded(MetricBus::Options{0, MetricBus::ShardKey::Instance});
+    std::vector<Subscription> subs;
+    for (int i = 0; i < 4; ++i) {
+      subs.push_back(single.subscribe([](const Metric&) { ++tl_received; }));
+      subs.push_back(sharded.subscribe([](const Metric&) { ++tl_received; }));
+    }
+    const double a = run(single, threads, per_thread);
+    const double b = run(sharded, threads, per_thread);
+    std::printf("%8u %18.2f %18.2f\n", threads, a / 1e6, b / 1e6);
+    if (threads < max_threads && threads * 2 > max_threads) threads = max_threads / 2;
+  }
+  return 0;
+}
@@ -0,0 +1,128 @@
+// Kompression und Durchsatz der MetricHistory-Blöcke (Gorilla-Kodierung)
+// auf typischen Reihen: Polling mit Jitter, langsam veränderliche Werte.
+//   bench_metric_history [points] [csv]
+// csv (optional): aufgezeichnete Reihe "ts_ms,value" pro Zeile, wird als
+// weitere Reihe gemessen.
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <core/metric_history.h>
+#include <core/metric_record.h>
+#include <core/enums.h>
+
+#include "bench_util.h"
+
+using namespace core;
+
+namespace {
+
+struct Sample {
+  uint64_t ts_ms;
+  float    value;
+};
+
+struct Series {
+  std::string         name;
+  std::vector<Sample> samples;
+};
+
+// deterministischer Jitter (kein <random>, Zahlen sollen reproduzierbar sein)
+uint32_t lcg(uint32_t& s) { return s = s * 1664525u + 1013904223u; }
+
+std::vector<Series> synthetic(std::size_t n) {
+  std::vector<Series> out(4);
+  out[0].name = "water level % (1 s, 0.5 % steps)";
+  out[1].name = "gas level % (5 s, slow drain)";
+  out[2].name = "temperature C (1 s, 0.1 C noise)";
+  out[3].name = "voltage V (200 ms, ADC noise)";
+  uint32_t seed = 12345;
+  uint64_t ts[4] = {1'700'000'000'000ull, 1'700'000'000'000ull, 1'700'000'000'000ull, 1'700'000'000'000ull};
+  for (std::size_t i = 0; i < n; ++i) {
+    const auto jitter = [&](int span) { return static_cast<int>(lcg(seed) % (2 * span + 1)) - span; };
+    ts[0] += 1000 + jitter(3);
+    out[0].samples.push_back({ts[0], 0.5f * std::floor(120.0f + 40.0f * std::sin(i / 3000.0f))});
+    ts[1] += 5000 + jitter(10);
+    out[1].samples.push_back({ts[1], 80.0f - 0.001f * static_cast<float>(i / 10)});
+    ts[2] += 1000 + jitter(2);
+    out[2].samples.push_back({ts[2], std::round(10.0f * (21.0f + 2.0f * std::sin(i / 5000.0f))
+                                                 + static_cast<float>(jitter(1))) / 10.0f});
+    ts[3] += 200 + jitter(1);
+    out[3].samples.push_back({ts[3], 12.6f + 0.01f * static_cast<float>(jitter(4))});
+  }
+  return out;
+}
+
+bool load_csv(const char* path, Series& s) {
+  FILE* f = std::fopen(path, "r");
+  if (!f) return false;
+  s.name = path;
+  unsigned long long ts = 0;
+  float v = 0.0f;
+  char line[128];
+  while (std::fgets(line, sizeof(line), f)) {
+    if (std::sscanf(line, "%llu,%f", &ts, &v) == 2) s.samples.push_back({ts, v});
+  }
+  std::fclose(f);
+  return !s.samples.empty();
+}
+
+void run(const Series& s) {
+  // kodieren in 4-KiB-Blöcke wie MetricHistory
+  std::vector<std::vector<uint8_t>> blocks;
+  std::size_t bytes = 0;
+  const uint64_t t0 = bench::now_ns();
+  HistoryEncoder enc(DataType::Float);
+  for (const Sample& p : s.samples) {
+    if (!enc.append(p.ts_ms, p.value)) {
+      blocks.push_back(enc.bytes());
+      enc = HistoryEncoder(DataType::Float);
+      enc.append(p.ts_ms, p.value);
+    }
+  }
+  blocks.push_back(enc.bytes());
+  const uint64_t enc_ns = bench::now_ns() - t0;
+  for (const auto& b : blocks) bytes += b.size();
+
+  std::size_t decoded = 0;
+  double sum = 0.0;
+  const uint64_t t1 = bench::now_ns();
+  HistoryPoint hp;
+  for (const auto& b : blocks) {
+    HistoryDecoder dec(b);
+    while (dec.next(hp)) {
+      sum += std::get<float>(hp.value);
+      ++decoded;
+    }
+  }
+  const uint64_t dec_ns = bench::now_ns() - t1;
+  bench::keep(sum);
+
+  const double n   = static_cast<double>(s.samples.size());
+  const double bpp = static_cast<double>(bytes) / n;
+  std::printf("%s\n", s.name.c_str());
+  std::printf("  %zu points, %zu blocks, %.2f bytes/point: %.1fx vs MetricRecord (%zu B), %.1fx vs raw (12 B)%s\n",
+              s.samples.size(), blocks.size(), bpp, sizeof(MetricRecord) / bpp, sizeof(MetricRecord),
+              12.0 / bpp, decoded == s.samples.size() ? "" : "  DECODE MISMATCH");
+  bench::row("  encode", enc_ns / n, n * 1e9 / enc_ns);
+  bench::row("  decode", dec_ns / n, n * 1e9 / dec_ns);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t points = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+
+  std::vector<Series> all = synthetic(points);
+  if (argc > 2) {
+    Series rec;
+    if (load_csv(argv[2], rec)) all.push_back(std::move(rec));
+    else std::fprintf(stderr, "cannot read %s\n", argv[2]);
+  }
+
+  std::printf("Metric history compression (Float, %zu points per synthetic series)\n", points);
+  for (const Series& s : all) run(s);
+  return 0;
+}
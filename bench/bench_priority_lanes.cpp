@@ -0,0 +1,82 @@
+// Lane-Latenzen unter synthetischer Last: Tilt-Flut (Bulk), etwas Gas
+// (Normal), seltene Health-Metriken (High), langsamer Subscriber.
+//   bench_priority_lanes [duration_ms]
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include <core/priority_lanes.h>
+#include <core/metric_bus.h>
+#include <core/metric.h>
+#include <core/ids.h>
+
+#include "bench_util.h"
+
+using namespace core;
+
+namespace {
+
+void spin_ns(uint64_t ns) {
+  const uint64_t end = bench::now_ns() + ns;
+  while (bench::now_ns() < end) {}
+}
+
+void run(const char* title, LaneDispatcher::Config cfg, unsigned duration_ms) {
+  MetricBus target;
+  LaneDispatcher lanes(target, cfg);
+  auto slow = target.subscribe([](const Metric&) { spin_ns(2000); });   // ~2 µs pro Metric
+
+  std::atomic<bool> run{true};
+  std::thread producer([&] {
+    const Metric tilt   = Metric::Make(1, MetricID::TiltAngle, 1.0f, 0, 1, {});
+    const Metric gas    = Metric::Make(2, MetricID::GasLevelPercent, 50.0f, 0, 1, {});
+    const Metric health = Metric::Make(3, MetricID::Health, int32_t{0}, 0, 1, {});
+    for (uint64_t i = 0; run.load(std::memory_order_relaxed); ++i) {
+      lanes.post(tilt);
+      if (i % 100 == 0)  lanes.post(gas);
+      if (i % 1000 == 0) lanes.post(health);
+      spin_ns(500);   // ~2 MHz Angebot, mehr als der Consumer schafft
+    }
+  });
+  std::thread consumer([&] {
+    while (run.load(std::memory_order_relaxed)) {
+      if (!lanes.drain(64)) std::this_thread::yield();
+    }
+    lanes.drain();
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(duration_ms));
+  run.store(false);
+  producer.join();
+  consumer.join();
+
+  std::printf("%s\n", title);
+  std::printf("  %-7s %10s %10s %10s %10s %10s %12s\n",
+              "lane", "posted", "delivered", "dropped", "p50[us]", "p99[us]", "max[us]");
+  const char* names[] = {"High", "Normal", "Bulk"};
+  for (std::size_t l = 0; l < kPriorityCount; ++l) {
+    const auto st = lanes.stats(static_cast<Priority>(l));
+    std::printf("  %-7s %10llu %10llu %10llu %10.1f %10.1f %12.1f\n", names[l],
+                (unsigned long long)st.posted, (unsigned long long)st.delivered,
+                (unsigned long long)st.dropped,
+                st.percentile_ns(0.50) / 1e3, st.percentile_ns(0.99) / 1e3, st.lat_max_ns / 1e3);
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const unsigned duration_ms = argc > 1 ? static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10)) : 1000;
+
+  LaneDispatcher::Config lanes_on;
+  lanes_on.map.assign(0x1200, 0x12FF, Priority::Bulk);
+  run("priority lanes (Tilt = Bulk, Health = High)", lanes_on, duration_ms);
+
+  // Vergleich: alles in einer FIFO (wie eine einfache Queue)
+  LaneDispatcher::Config fifo;
+  fifo.map.assign(0x0000, 0xFFFF, Priority::Normal);
+  fifo.lanes[static_cast<std::size_t>(Priority::Normal)].capacity = 1024;
+  run("single FIFO (no lanes)", fifo, duration_ms);
+  return 0;
+}
@@ -0,0 +1,105 @@
+// Kosten der Regelauswertung pro Publish bei tausenden Regeln.
+//   bench_rule_engine [publishes]
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <core/rule_engine.h>
+#include <core/metric_bus.h>
+#include <core/metric.h>
+#include <core/ids.h>
+
+#include "bench_util.h"
+
+using namespace core;
+
+namespace {
+
+std::vector<Rule> make_rules(uint32_t n) {
+  std::vector<Rule> rules;
+  rules.reserve(n);
+  for (uint32_t i = 0; i < n; ++i) {
+    Rule r;
+    r.metric         = (i & 1) ? MetricID::Temperature : MetricID::GasLevelPercent;
+    r.instance       = i / 2;
+    r.op             = (i & 1) ? Rule::Op::Above : Rule::Op::Below;
+    r.threshold      = (i & 1) ? 60.0f : 10.0f;
+    r.hysteresis     = 1.0f;
+    r.debounce_ms    = 100;
+    r.alarm_instance = 100000 + i;
+    rules.push_back(r);
+  }
+  return rules;
+}
+
+std::vector<Metric> make_metrics(uint32_t rules, std::size_t n) {
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<uint32_t> inst(0, rules);   // ~1/rules Treffer ohne Regel
+  std::uniform_real_distribution<float>   val(0.0f, 100.0f);
+  std::vector<Metric> ms;
+  ms.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const MetricID id = (i & 1) ? MetricID::Temperature : MetricID::GasLevelPercent;
+    ms.push_back(Metric::Make(inst(rng) / 2, id, val(rng), i, static_cast<uint32_t>(i + 1), {}));
+  }
+  return ms;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t publishes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1'000'000;
+
+  std::printf("rule engine: %zu publishes per run\n", publishes);
+  for (uint32_t n_rules : {1'000u, 5'000u, 20'000u}) {
+    const auto metrics = make_metrics(n_rules, 4096);
+
+    MetricBus bus;
+    RuleEngine eng(bus);
+    eng.load(make_rules(n_rules));
+
+    // nur evaluate()
+    std::size_t evaluated = 0;
+    uint64_t t0 = bench::now_ns();
+    for (std::size_t i = 0; i < publishes; ++i) evaluated += eng.evaluate(metrics[i & 4095]);
+    uint64_t dt = bench::now_ns() - t0;
+    bench::keep(evaluated);
+    std::string name = "evaluate, " + std::to_string(n_rules) + " rules";
+    bench::row(name.c_str(), double(dt) / publishes, publishes * 1e9 / double(dt));
+
+    // über den Bus (inkl. Dispatch und Alarm-Publish)
+    t0 = bench::now_ns();
+    for (std::size_t i = 0; i < publishes; ++i) bus.publish(metrics[i & 4095]);
+    dt = bench::now_ns() - t0;
+    name = "bus.publish, " + std::to_string(n_rules) + " rules";
+    bench::row(name.c_str(), double(dt) / publishes, publishes * 1e9 / double(dt));
+  }
+
+#if !CARAVAN_STATIC
+  // Vergleich: jede Regel als eigener Subscriber (bisheriges Muster); im
+  // statischen Profil nicht möglich (CARAVAN_MAX_SUBSCRIBERS, Capture-Größe)
+  {
+    const uint32_t n_rules = 1'000;
+    const auto rules   = make_rules(n_rules);
+    const auto metrics = make_metrics(n_rules, 4096);
+    MetricBus bus;
+    std::vector<Subscription> subs;
+    std::size_t hits = 0;
+    for (auto& r : rules) {
+      subs.push_back(bus.subscribe([&hits, r](const Metric& m) {
+        if (m.metric_id() != r.metric || m.instance_id() != r.instance) return;
+        if (auto f = m.get_if<float>()) hits += (*f > r.threshold);
+      }));
+    }
+    const std::size_t n = publishes / 100;
+    const uint64_t t0 = bench::now_ns();
+    for (std::size_t i = 0; i < n; ++i) bus.publish(metrics[i & 4095]);
+    const uint64_t dt = bench::now_ns() - t0;
+    bench::keep(hits);
+    bench::row("subscriber per rule, 1000 rules", double(dt) / n, n * 1e9 / double(dt));
+  }
+#endif
+  return 0;
+}
@@ -0,0 +1,113 @@
+// Shared-Memory-Bridge: Durchsatz des Schreibers und End-to-End-Latenz
+// Hub-Bus -> Ring -> Leser-Prozess (fork) -> lokaler Bus.
+// Für die Messung trägt timestamp_ms hier steady_clock-Nanosekunden.
+//   bench_shm_bridge [records] [pace_ns]
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <ipc/shm_bridge.h>
+#include <core/metric_bus.h>
+#include <core/metric.h>
+#include <core/ids.h>
+
+#include "bench_util.h"
+
+using namespace core;
+
+namespace {
+
+struct ReaderResult {
+  uint64_t received;
+  uint64_t overruns;
+  uint64_t p50_ns, p99_ns, max_ns;
+  uint64_t elapsed_ns;
+};
+
+ReaderResult run_reader(const std::string& name, uint32_t records, int ready_fd) {
+  ReaderResult res{};
+  auto reader = ipc::ShmBridgeReader::open(name);
+  if (!reader) return res;
+  const char ok = 1;
+  (void)!::write(ready_fd, &ok, 1);
+
+  MetricBus local;
+  std::vector<uint64_t> lat;
+  lat.reserve(records);
+  uint32_t last_seq = 0;
+  auto sub = local.subscribe([&](const Metric& m) {
+    lat.push_back(bench::now_ns() - m.timestamp_ms());
+    last_seq = m.seq();
+  });
+  ipc::ShmBusAdapter adapter(*reader, local);
+
+  uint64_t t0 = 0;
+  while (last_seq < records) {
+    if (!adapter.pump(256)) { std::this_thread::yield(); continue; }
+    if (!t0) t0 = bench::now_ns();
+  }
+  res.elapsed_ns = bench::now_ns() - t0;
+  res.received   = reader->received();
+  res.overruns   = reader->overruns();
+  std::sort(lat.begin(), lat.end());
+  if (!lat.empty()) {
+    res.p50_ns = lat[lat.size() / 2];
+    res.p99_ns = lat[lat.size() * 99 / 100];
+    res.max_ns = lat.back();
+  }
+  return res;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t records = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 1'000'000;
+  const uint64_t pace_ns = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 0;
+
+  MetricBus hub;
+  std::string err;
+  const std::string name = "caravan_bench_" + std::to_string(::getpid());
+  auto writer = ipc::ShmBridgeWriter::create(hub, name, 1u << 16, &err);
+  if (!writer) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+
+  int ready[2], result[2];
+  if (::pipe(ready) != 0 || ::pipe(result) != 0) return 1;
+
+  const pid_t child = ::fork();
+  if (child == 0) {
+    const ReaderResult r = run_reader(name, records, ready[1]);
+    (void)!::write(result[1], &r, sizeof(r));
+    _exit(0);
+  }
+  char c;
+  if (::read(ready[0], &c, 1) != 1) return 1;
+
+  const uint64_t t0 = bench::now_ns();
+  for (uint32_t i = 1; i <= records; ++i) {
+    const uint64_t now = bench::now_ns();
+    hub.publish(Metric::Make(1, MetricID::TiltAngle, 1.0f, now, i, {}));
+    if (pace_ns) while (bench::now_ns() - now < pace_ns) {}
+  }
+  const uint64_t dt = bench::now_ns() - t0;
+
+  ReaderResult r{};
+  if (::read(result[0], &r, sizeof(r)) != sizeof(r)) return 1;
+  ::waitpid(child, nullptr, 0);
+
+  std::printf("shm bridge: %u records, ring %zu, pace %llu ns\n", records, writer->capacity(),
+              (unsigned long long)pace_ns);
+  bench::row("writer (bus.publish -> ring)", double(dt) / records, records * 1e9 / double(dt));
+  bench::row("reader (ring -> local bus)", double(r.elapsed_ns) / std::max<uint64_t>(r.received, 1),
+             r.received * 1e9 / double(std::max<uint64_t>(r.elapsed_ns, 1)));
+  std::printf("reader received %llu, overruns %llu\n",
+              (unsigned long long)r.received, (unsigned long long)r.overruns);
+  std::printf("end-to-end latency: p50 %.2f us, p99 %.2f us, max %.2f us\n",
+              r.p50_ns / 1e3, r.p99_ns / 1e3, r.max_ns / 1e3);
+  return 0;
+}
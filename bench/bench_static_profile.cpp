@@ -0,0 +1,90 @@
+// Speicherbedarf und Zeit des Hot Paths (Metric bauen + publish) im
+// aktuellen Profil. Für den Vergleich einmal normal und einmal mit
+// -DCARAVAN_STATIC=ON bauen; gezählt werden auch Heap-Allokationen.
+//   bench_static_profile [iterations]
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include <core/metric_bus.h>
+#include <core/metric.h>
+#include <core/enums.h>
+#include <core/ids.h>
+#include <core/static_config.h>
+#include "modbus.h"
+
+#include "bench_util.h"
+
+using namespace core;
+
+namespace {
+std::atomic<uint64_t> g_allocs{0};
+}
+void* operator new(std::size_t n) {
+  g_allocs.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(n ? n : 1)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+Metric mk(uint32_t seq) {
+  Metric::PropMap p;
+  p.emplace(PropertyKey::Unit,    static_cast<uint8_t>(Unit::Degree));
+  p.emplace(PropertyKey::Quality, static_cast<uint8_t>(Quality::Good));
+  return Metric::Make(7, MetricID::TiltAngle, float(seq) * 0.01f, seq, seq, std::move(p));
+}
+
+template<typename Fn>
+void run(const char* label, std::size_t iters, Fn&& fn) {
+  const uint64_t a0 = g_allocs.load();
+  const uint64_t t0 = bench::now_ns();
+  for (std::size_t i = 0; i < iters; ++i) fn(static_cast<uint32_t>(i));
+  const uint64_t dt = bench::now_ns() - t0;
+  const double allocs = double(g_allocs.load() - a0) / double(iters);
+  bench::row(label, double(dt) / iters, iters * 1e9 / dt);
+  std::printf("%-44s %10.2f allocs/op\n", "", allocs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t iters = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1'000'000;
+
+  std::printf("Profile: %s\n", caps::kStatic ? "static (CARAVAN_STATIC=1)" : "dynamic");
+  if (caps::kStatic) {
+    std::printf("  max subscribers %zu, props %zu, devices %zu, regs %zu, callback bytes %zu\n",
+                caps::kMaxSubscribers, caps::kMaxProps, caps::kMaxDevices, caps::kMaxRegs,
+                caps::kCallbackBytes);
+  }
+  std::printf("  sizeof(Metric)            %5zu B\n", sizeof(Metric));
+  std::printf("  sizeof(Metric::PropMap)   %5zu B\n", sizeof(Metric::PropMap));
+  std::printf("  sizeof(MetricBus)         %5zu B (%s)\n", sizeof(MetricBus),
+              caps::kStatic ? "incl. all shards" : "shards on the heap");
+  std::printf("  sizeof(MetricBus::Callback) %3zu B\n", sizeof(MetricBus::Callback));
+  std::printf("  sizeof(ModbusRegs)        %5zu B\n", sizeof(ModbusRegs));
+
+  MetricBus bus;
+  float sum = 0.0f;
+  std::vector<Subscription> subs;
+  for (int i = 0; i < 4; ++i) subs.push_back(bus.subscribe([&sum](const Metric& m) { sum += *m.get_if<float>(); }));
+  const Metric fixed = mk(1);
+  bus.publish(fixed);   // erster publish() pro Thread (thread_local-Setup)
+
+  run("Metric::Make with 2 props", iters, [](uint32_t i) { Metric m = mk(i); bench::keep(m); });
+  run("publish, 4 subscribers", iters, [&](uint32_t) { bus.publish(fixed); });
+  run("Make + publish, 4 subscribers", iters, [&](uint32_t i) { bus.publish(mk(i)); });
+  ModbusRegs regs;
+  run("ModbusRegs fill 8 registers", iters, [&](uint32_t i) {
+    regs.clear();
+    for (uint16_t r = 0; r < 8; ++r) regs.push_back(static_cast<uint16_t>(i + r));
+    bench::keep(regs);
+  });
+
+  bench::keep(sum);
+  return 0;
+}
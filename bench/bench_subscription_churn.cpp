@@ -0,0 +1,56 @@
+// Kurzlebige Subscriptions (UI-Seiten, One-Shot-Waits) neben vielen
+// langlebigen: Kosten für subscribe+unsubscribe und für publish danach.
+//   bench_subscription_churn [long_lived] [cycles]
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <core/metric_bus.h>
+#include <core/metric.h>
+#include <core/ids.h>
+
+#include "bench_util.h"
+
+using namespace core;
+
+int main(int argc, char** argv) {
+  const std::size_t long_lived = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+  const std::size_t cycles     = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200'000;
+
+  MetricBus bus;
+  uint64_t hits = 0;
+  std::vector<Subscription> subs;
+  for (std::size_t i = 0; i < long_lived; ++i)
+    subs.push_back(bus.subscribe(MetricID::Temperature, [&hits](const Metric&) { ++hits; }));
+
+  std::printf("MetricBus churn: %zu long-lived subscribers, %zu cycles\n", long_lived, cycles);
+
+  // subscribe + sofort unsubscribe (LIFO)
+  uint64_t t0 = bench::now_ns();
+  for (std::size_t i = 0; i < cycles; ++i) {
+    auto s = bus.subscribe([&hits](const Metric&) { ++hits; });
+    bench::keep(s);
+  }
+  uint64_t dt = bench::now_ns() - t0;
+  bench::row("subscribe+unsubscribe (LIFO)", double(dt) / cycles, cycles * 1e9 / dt);
+
+  // Fenster aus 64 Subscriptions, älteste zuerst abmelden (FIFO)
+  std::vector<Subscription> window(64);
+  t0 = bench::now_ns();
+  for (std::size_t i = 0; i < cycles; ++i)
+    window[i % window.size()] = bus.subscribe([&hits](const Metric&) { ++hits; });
+  dt = bench::now_ns() - t0;
+  bench::row("subscribe+unsubscribe (FIFO window 64)", double(dt) / cycles, cycles * 1e9 / dt);
+  window.clear();
+
+  // Publish an die langlebigen Subscriber nach dem Churn
+  const Metric m = Metric::Make(1, MetricID::Temperature, 21.5f, 0, 1, {});
+  const std::size_t pubs = cycles / 10 + 1;
+  t0 = bench::now_ns();
+  for (std::size_t i = 0; i < pubs; ++i) bus.publish(m);
+  dt = bench::now_ns() - t0;
+  bench::row("publish after churn", double(dt) / pubs, pubs * 1e9 / dt);
+
+  bench::keep(hits);
+  return 0;
+}
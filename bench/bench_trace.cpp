@@ -0,0 +1,64 @@
+// Kosten der Tracing-Spans: Makro aus (Aufzeichnung gestoppt) gegen an, und
+// MetricBus::publish mit 4 Subscribern in beiden Zuständen. Zum Vergleich
+// mit -DCARAVAN_TRACE=OFF bauen (Makros leer).
+//   bench_trace [iterations]
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <core/metric_bus.h>
+#include <core/metric.h>
+#include <core/ids.h>
+#include <core/trace.h>
+
+#include "bench_util.h"
+
+using namespace core;
+
+namespace {
+
+void run_span(const char* label, std::size_t iters) {
+  const uint64_t t0 = bench::now_ns();
+  for (std::size_t i = 0; i < iters; ++i) {
+    CARAVAN_TRACE_SCOPE("bench.span");
+    bench::keep(i);
+  }
+  const uint64_t dt = bench::now_ns() - t0;
+  bench::row(label, double(dt) / iters, iters * 1e9 / dt);
+}
+
+void run_publish(const char* label, MetricBus& bus, std::size_t iters) {
+  const Metric m = Metric::Make(1, MetricID::Temperature, 21.5f, 0, 1, {});
+  const uint64_t t0 = bench::now_ns();
+  for (std::size_t i = 0; i < iters; ++i) bus.publish(m);
+  const uint64_t dt = bench::now_ns() - t0;
+  bench::row(label, double(dt) / iters, iters * 1e9 / dt);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t iters = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2'000'000;
+
+#if CARAVAN_TRACE
+  std::printf("Tracing compiled in (CARAVAN_TRACE=1), %zu iterations\n", iters);
+#else
+  std::printf("Tracing compiled out, %zu iterations\n", iters);
+#endif
+
+  MetricBus bus;
+  uint64_t hits = 0;
+  std::vector<Subscription> subs;
+  for (int i = 0; i < 4; ++i) subs.push_back(bus.subscribe([&hits](const Metric&) { ++hits; }));
+
+  run_span("span, not recording", iters);
+  run_publish("publish 4 subs, not recording", bus, iters);
+
+  trace::start(1 << 16);
+  run_span("span, recording", iters);
+  run_publish("publish 4 subs, recording", bus, iters);
+  trace::stop();
+
+  bench::keep(hits);
+  return 0;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+inline uint64_t now_ns() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+}
+
+// Verhindert, dass der Compiler Ergebnisse wegoptimiert
+template <typename T>
+inline void keep(T const& v) {
+#if defined(__GNUC__)
+  asm volatile("" : : "g"(&v) : "memory");
+#else
+  static volatile const void* sink; sink = &v;
+#endif
+}
+
+inline void row(const char* name, double ns_per_op, double ops_per_s) {
+  std::printf("%-44s %10.1f ns/op %14.0f ops/s\n", name, ns_per_op, ops_per_s);
+}
+
+} // namespace bench
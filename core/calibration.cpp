@@ -0,0 +1,203 @@
+#include "core/calibration.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CORE_CALIB_X86 1
+#include <immintrin.h>
+#endif
+
+namespace core {
+
+namespace {
+
+constexpr uint8_t kGood = static_cast<uint8_t>(Quality::Good);
+constexpr uint8_t kBad  = static_cast<uint8_t>(Quality::Bad);
+
+template <typename Raw>
+inline void convert_scalar(const Raw* raw, const float* scale, const float* offset,
+                           const float* min, const float* max,
+                           float* out, uint8_t* q, std::size_t n) noexcept {
+  for (std::size_t i = 0; i < n; ++i) {
+    const float v = static_cast<float>(raw[i]) * scale[i] + offset[i];
+    const bool  bad = v < min[i] || v > max[i];
+    out[i] = std::min(std::max(v, min[i]), max[i]);
+    q[i]   = bad ? kBad : kGood;
+  }
+}
+
+#if defined(CORE_CALIB_X86)
+
+// 4 Werte: v -> clamp + Quality-Bytes
+inline void finish_sse2(__m128 v, const float* min, const float* max,
+                        float* out, uint8_t* q) noexcept {
+  const __m128 lo = _mm_loadu_ps(min);
+  const __m128 hi = _mm_loadu_ps(max);
+  const int bad = _mm_movemask_ps(_mm_or_ps(_mm_cmplt_ps(v, lo), _mm_cmpgt_ps(v, hi)));
+  _mm_storeu_ps(out, _mm_min_ps(_mm_max_ps(v, lo), hi));
+  for (int k = 0; k < 4; ++k) q[k] = (bad >> k) & 1 ? kBad : kGood;
+}
+
+template <bool Signed>
+void convert_sse2(const void* raw_v, const float* scale, const float* offset,
+                  const float* min, const float* max,
+                  float* out, uint8_t* q, std::size_t n) noexcept {
+  const auto* raw = static_cast<const uint16_t*>(raw_v);
+  const __m128i zero = _mm_setzero_si128();
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(raw + i));
+    __m128i lo32, hi32;
+    if (Signed) {
+      lo32 = _mm_srai_epi32(_mm_unpacklo_epi16(r, r), 16);
+      hi32 = _mm_srai_epi32(_mm_unpackhi_epi16(r, r), 16);
+    } else {
+      lo32 = _mm_unpacklo_epi16(r, zero);
+      hi32 = _mm_unpackhi_epi16(r, zero);
+    }
+    const __m128 a = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(lo32), _mm_loadu_ps(scale + i)),
+                                _mm_loadu_ps(offset + i));
+    const __m128 b = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(hi32), _mm_loadu_ps(scale + i + 4)),
+                                _mm_loadu_ps(offset + i + 4));
+    finish_sse2(a, min + i,     max + i,     out + i,     q + i);
+    finish_sse2(b, min + i + 4, max + i + 4, out + i + 4, q + i + 4);
+  }
+  if (Signed)
+    convert_scalar(reinterpret_cast<const int16_t*>(raw) + i, scale + i, offset + i,
+                   min + i, max + i, out + i, q + i, n - i);
+  else
+    convert_scalar(raw + i, scale + i, offset + i, min + i, max + i, out + i, q + i, n - i);
+}
+
+#if defined(__GNUC__)
+template <bool Signed>
+__attribute__((target("avx2")))
+void convert_avx2(const void* raw_v, const float* scale, const float* offset,
+                  const float* min, const float* max,
+                  float* out, uint8_t* q, std::size_t n) noexcept {
+  const auto* raw = static_cast<const uint16_t*>(raw_v);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m128i r   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(raw + i));
+    const __m256i r32 = Signed ? _mm256_cvtepi16_epi32(r) : _mm256_cvtepu16_epi32(r);
+    const __m256  v   = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(r32), _mm256_loadu_ps(scale + i)),
+                                      _mm256_loadu_ps(offset + i));
+    const __m256 lo = _mm256_loadu_ps(min + i);
+    const __m256 hi = _mm256_loadu_ps(max + i);
+    const int bad = _mm256_movemask_ps(_mm256_or_ps(_mm256_cmp_ps(v, lo, _CMP_LT_OQ),
+                                                    _mm256_cmp_ps(v, hi, _CMP_GT_OQ)));
+    _mm256_storeu_ps(out + i, _mm256_min_ps(_mm256_max_ps(v, lo), hi));
+    for (int k = 0; k < 8; ++k) q[i + k] = (bad >> k) & 1 ? kBad : kGood;
+  }
+  if (Signed)
+    convert_scalar(reinterpret_cast<const int16_t*>(raw) + i, scale + i, offset + i,
+                   min + i, max + i, out + i, q + i, n - i);
+  else
+    convert_scalar(raw + i, scale + i, offset + i, min + i, max + i, out + i, q + i, n - i);
+}
+#endif
+
+#endif // CORE_CALIB_X86
+
+using KernelFn = void (*)(const void*, const float*, const float*, const float*,
+                          const float*, float*, uint8_t*, std::size_t) noexcept;
+
+struct Kernels {
+  KernelFn    u16;
+  KernelFn    i16;
+  const char* name;
+};
+
+#if !defined(CORE_CALIB_X86)
+template <bool Signed>
+void convert_plain(const void* raw, const float* scale, const float* offset,
+                   const float* min, const float* max,
+                   float* out, uint8_t* q, std::size_t n) noexcept {
+  if (Signed)
+    convert_scalar(static_cast<const int16_t*>(raw), scale, offset, min, max, out, q, n);
+  else
+    convert_scalar(static_cast<const uint16_t*>(raw), scale, offset, min, max, out, q, n);
+}
+#endif
+
+// Auswahl einmalig beim ersten Aufruf
+const Kernels& kernels() noexcept {
+  static const Kernels k = [] {
+#if defined(CORE_CALIB_X86)
+#if defined(__GNUC__)
+    if (__builtin_cpu_supports("avx2"))
+      return Kernels{&convert_avx2<false>, &convert_avx2<true>, "avx2"};
+#endif
+    return Kernels{&convert_sse2<false>, &convert_sse2<true>, "sse2"};
+#else
+    return Kernels{&convert_plain<false>, &convert_plain<true>, "scalar"};
+#endif
+  }();
+  return k;
+}
+
+} // namespace
+
+namespace calib {
+
+void convert_u16(const uint16_t* raw, const float* scale, const float* offset,
+                 const float* min, const float* max,
+                 float* out, uint8_t* q, std::size_t n) noexcept {
+  kernels().u16(raw, scale, offset, min, max, out, q, n);
+}
+
+void convert_i16(const int16_t* raw, const float* scale, const float* offset,
+                 const float* min, const float* max,
+                 float* out, uint8_t* q, std::size_t n) noexcept {
+  kernels().i16(raw, scale, offset, min, max, out, q, n);
+}
+
+const char* kernel_name() noexcept { return kernels().name; }
+
+} // namespace calib
+
+// ---- CalibrationTable ----
+
+CalibrationTable::CalibrationTable(std::size_t channels) { resize(channels); }
+
+void CalibrationTable::resize(std::size_t channels) {
+  const ChannelCalib d{};
+  scale_.resize(channels, d.scale);
+  offset_.resize(channels, d.offset);
+  min_.resize(channels, d.min);
+  max_.resize(channels, d.max);
+}
+
+void CalibrationTable::set(std::size_t ch, const ChannelCalib& c) {
+  if (ch >= channels()) resize(ch + 1);
+  scale_[ch]  = c.scale;
+  offset_[ch] = c.offset;
+  min_[ch]    = c.min;
+  max_[ch]    = c.max;
+}
+
+ChannelCalib CalibrationTable::get(std::size_t ch) const {
+  return ChannelCalib{scale_.at(ch), offset_.at(ch), min_.at(ch), max_.at(ch)};
+}
+
+void CalibrationTable::apply(const uint16_t* raw, float* out, Quality* q) const noexcept {
+  calib::convert_u16(raw, scale_.data(), offset_.data(), min_.data(), max_.data(),
+                     out, reinterpret_cast<uint8_t*>(q), channels());
+}
+
+void CalibrationTable::apply(const int16_t* raw, float* out, Quality* q) const noexcept {
+  calib::convert_i16(raw, scale_.data(), offset_.data(), min_.data(), max_.data(),
+                     out, reinterpret_cast<uint8_t*>(q), channels());
+}
+
+bool CalibrationTable::apply(const std::vector<uint16_t>& raw, std::vector<float>& out,
+                             std::vector<Quality>& q, bool is_signed) const {
+  if (raw.size() < channels()) return false;
+  out.resize(channels());
+  q.resize(channels());
+  if (is_signed) apply(reinterpret_cast<const int16_t*>(raw.data()), out.data(), q.data());
+  else           apply(raw.data(), out.data(), q.data());
+  return true;
+}
+
+} // namespace core
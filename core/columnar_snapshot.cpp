@@ -0,0 +1,239 @@
+#include "core/columnar_snapshot.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace core {
+
+namespace {
+
+inline float as_float(const Metric& m) noexcept {
+  if (auto f = m.get_if<float>())   return *f;
+  if (auto i = m.get_if<int32_t>()) return static_cast<float>(*i);
+  if (auto b = m.get_if<bool>())    return *b ? 1.0f : 0.0f;
+  return 0.0f;
+}
+
+inline uint32_t float_bits(float v) noexcept {
+  uint32_t b;
+  static_assert(sizeof(b) == sizeof(v), "float must be 32 bit");
+  std::memcpy(&b, &v, sizeof(b));
+  return b;
+}
+
+} // namespace
+
+// --- Frame: Scans -----------------------------------------------------------
+
+std::size_t ColumnarSnapshot::Frame::count_stale(uint64_t now_ms, uint64_t max_age_ms) const noexcept {
+  // ohne Verzweigung, damit der Compiler vektorisieren kann
+  const uint64_t* ts = ts_ms.data();
+  const std::size_t n = ts_ms.size();
+  std::size_t stale = 0;
+  for (std::size_t i = 0; i < n; ++i) stale += (ts[i] + max_age_ms < now_ms);
+  return stale;
+}
+
+bool ColumnarSnapshot::Frame::any_stale(uint64_t now_ms, uint64_t max_age_ms) const noexcept {
+  // blockweise, damit der innere Block vektorisierbar bleibt
+  constexpr std::size_t kBlock = 64;
+  const uint64_t* ts = ts_ms.data();
+  const std::size_t n = ts_ms.size();
+  for (std::size_t base = 0; base < n; base += kBlock) {
+    const std::size_t end = base + kBlock < n ? base + kBlock : n;
+    unsigned hit = 0;
+    for (std::size_t i = base; i < end; ++i) hit |= (ts[i] + max_age_ms < now_ms);
+    if (hit) return true;
+  }
+  return false;
+}
+
+void ColumnarSnapshot::Frame::stale_slots(uint64_t now_ms, uint64_t max_age_ms,
+                                          std::vector<uint32_t>& out) const {
+  out.clear();
+  for (std::size_t i = 0; i < ts_ms.size(); ++i)
+    if (ts_ms[i] + max_age_ms < now_ms) out.push_back(static_cast<uint32_t>(i));
+}
+
+std::size_t ColumnarSnapshot::Frame::count_quality(Quality q) const noexcept {
+  const uint8_t want = static_cast<uint8_t>(q);
+  std::size_t n = 0;
+  for (uint8_t v : quality) n += (v == want);
+  return n;
+}
+
+void ColumnarSnapshot::Frame::to_records(std::vector<MetricRecord>& out) const {
+  // Props-Slots wie in to_record(): Key k -> props[k-1], Typ 1 = uint8
+  constexpr unsigned kUnitSlot    = static_cast<unsigned>(PropertyKey::Unit) - 1;
+  constexpr unsigned kQualitySlot = static_cast<unsigned>(PropertyKey::Quality) - 1;
+  constexpr uint16_t kPropTypes   = (1u << (2 * kUnitSlot)) | (1u << (2 * kQualitySlot));
+
+  MetricRecord tmpl{};
+  tmpl.prop_types = kPropTypes;
+  out.assign(size(), tmpl);
+  MetricRecord* r = out.data();
+  for (std::size_t i = 0; i < size(); ++i) {
+    r[i].timestamp_ms = ts_ms[i];
+    r[i].instance_id  = instance[i];
+    r[i].metric_id    = metric[i];
+    r[i].datatype     = datatype[i];
+    r[i].props[kUnitSlot]    = unit[i];
+    r[i].props[kQualitySlot] = quality[i];
+    r[i].value        = float_bits(value[i]);
+  }
+  // seltene Nicht-Float-Werte nachträglich umkodieren
+  for (std::size_t i = 0; i < size(); ++i) {
+    if (datatype[i] == static_cast<uint8_t>(DataType::Int32)) {
+      const int32_t v = static_cast<int32_t>(value[i]);
+      std::memcpy(&r[i].value, &v, sizeof(v));
+    } else if (datatype[i] == static_cast<uint8_t>(DataType::Bool)) {
+      r[i].value = value[i] != 0.0f ? 1u : 0u;
+    }
+  }
+}
+
+// --- Schreiber / Leser --------------------------------------------------------
+
+ColumnarSnapshot::ColumnarSnapshot()
+: recycler_(std::make_shared<Recycler>())
+{
+  back_  = wrap_(std::make_unique<Frame>());
+  front_ = wrap_(std::make_unique<Frame>());
+}
+
+ColumnarSnapshot::ColumnarSnapshot(MetricBus& bus)
+: ColumnarSnapshot()
+{
+  sub_ = bus.subscribe([this](const Metric& m) { update(m); });
+}
+
+void ColumnarSnapshot::mark_dirty_(uint32_t slot) {
+  if (dirty_flag_[slot]) return;
+  dirty_flag_[slot] = 1;
+  dirty_.push_back(slot);
+}
+
+void ColumnarSnapshot::update(const Metric& m) {
+  const uint8_t q = m.try_get_prop<uint8_t>(PropertyKey::Quality).value_or(static_cast<uint8_t>(Quality::Good));
+  const uint8_t u = m.try_get_prop<uint8_t>(PropertyKey::Unit).value_or(static_cast<uint8_t>(Unit::None));
+  const float   v = as_float(m);
+
+  std::lock_guard<std::mutex> lk(wmtx_);
+  Frame& f = *back_;
+  auto [it, inserted] = index_.try_emplace(key_of(m.instance_id(), m.metric_id()),
+                                           static_cast<uint32_t>(f.size()));
+  const uint32_t slot = it->second;
+  if (inserted) {
+    f.instance.push_back(m.instance_id());
+    f.metric.push_back(static_cast<uint16_t>(m.metric_id()));
+    f.value.push_back(v);
+    f.ts_ms.push_back(m.timestamp_ms());
+    f.quality.push_back(q);
+    f.unit.push_back(u);
+    f.datatype.push_back(static_cast<uint8_t>(m.datatype()));
+    dirty_flag_.push_back(0);
+  } else {
+    f.value[slot]    = v;
+    f.ts_ms[slot]    = m.timestamp_ms();
+    f.quality[slot]  = q;
+    f.unit[slot]     = u;
+    f.datatype[slot] = static_cast<uint8_t>(m.datatype());
+  }
+  mark_dirty_(slot);
+}
+
+void ColumnarSnapshot::copy_slot(Frame& dst, const Frame& src, uint32_t slot) {
+  dst.instance[slot] = src.instance[slot];
+  dst.metric[slot]   = src.metric[slot];
+  dst.value[slot]    = src.value[slot];
+  dst.ts_ms[slot]    = src.ts_ms[slot];
+  dst.quality[slot]  = src.quality[slot];
+  dst.unit[slot]     = src.unit[slot];
+  dst.datatype[slot] = src.datatype[slot];
+}
+
+std::shared_ptr<ColumnarSnapshot::Frame> ColumnarSnapshot::wrap_(std::unique_ptr<Frame> f) {
+  // letzter Halter (Leser oder wir) gibt den Frame an den Recycler zurück;
+  // die Übergabe per Mutex ordnet die Lesezugriffe vor das Überschreiben
+  return std::shared_ptr<Frame>(f.release(), [rec = recycler_](Frame* p) {
+    std::unique_ptr<Frame> owned(p);
+    std::lock_guard<std::mutex> lk(rec->mtx);
+    if (rec->spare.size() < Recycler::kMaxSpare) rec->spare.push_back(std::move(owned));
+  });
+}
+
+ColumnarSnapshot::FramePtr ColumnarSnapshot::commit() {
+  std::lock_guard<std::mutex> lk(wmtx_);
+  ++back_->version;
+  std::shared_ptr<Frame> old;
+  {
+    std::lock_guard<std::mutex> flk(fmtx_);
+    old    = std::move(front_);
+    front_ = back_;
+  }
+  // nach dem Tausch kann kein Leser den alten Frame mehr neu erwerben
+  old.reset();
+  const Frame& pub = *front_;
+
+  std::unique_ptr<Frame> next;
+  {
+    std::lock_guard<std::mutex> rlk(recycler_->mtx);
+    auto& spare = recycler_->spare;
+    auto it = std::find_if(spare.begin(), spare.end(),
+                           [&](const std::unique_ptr<Frame>& f) { return f->version + 1 == pub.version; });
+    if (it == spare.end() && !spare.empty()) it = spare.end() - 1;
+    if (it != spare.end()) {
+      next = std::move(*it);
+      spare.erase(it);
+    }
+  }
+
+  if (next && next->version + 1 == pub.version) {
+    // der vorige Frame: ihm fehlen genau die Änderungen seit dem letzten commit
+    const std::size_t n = pub.size();
+    next->instance.resize(n);
+    next->metric.resize(n);
+    next->value.resize(n);
+    next->ts_ms.resize(n);
+    next->quality.resize(n);
+    next->unit.resize(n);
+    next->datatype.resize(n);
+    for (uint32_t slot : dirty_) copy_slot(*next, pub, slot);
+    next->version = pub.version;
+  } else {
+    // vorigen Frame hält noch ein Leser -> vollständige Kopie (Kapazität wiederverwendet)
+    if (next) *next = pub;
+    else      next = std::make_unique<Frame>(pub);
+    ++full_copies_;
+  }
+  back_ = wrap_(std::move(next));
+
+  for (uint32_t slot : dirty_) dirty_flag_[slot] = 0;
+  dirty_.clear();
+  return front_;
+}
+
+ColumnarSnapshot::FramePtr ColumnarSnapshot::current() const {
+  std::lock_guard<std::mutex> lk(fmtx_);
+  return front_;
+}
+
+std::optional<uint32_t> ColumnarSnapshot::slot_of(Metric::InstanceId instance, MetricID metric) const {
+  std::lock_guard<std::mutex> lk(wmtx_);
+  auto it = index_.find(key_of(instance, metric));
+  if (it == index_.end()) return std::nullopt;
+  return it->second;
+}
+
+std::size_t ColumnarSnapshot::slot_count() const {
+  std::lock_guard<std::mutex> lk(wmtx_);
+  return index_.size();
+}
+
+uint64_t ColumnarSnapshot::full_copies() const {
+  std::lock_guard<std::mutex> lk(wmtx_);
+  return full_copies_;
+}
+
+} // namespace core
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "core/enums.h"
+
+namespace core {
+
+// Kalibrierung laut COMMUNICATION_SPEC: physical = raw * Scale + Offset,
+// danach Clamping auf [Min, Max]. Werte außerhalb -> Quality::Bad.
+struct ChannelCalib {
+  float scale {1.0f};
+  float offset{0.0f};
+  float min   {-std::numeric_limits<float>::infinity()};
+  float max   { std::numeric_limits<float>::infinity()};
+};
+
+// Kalibriertabelle für einen Registerblock: Kanal i <-> Register i.
+// Intern Struct-of-Arrays, damit die Kernel (SSE2/AVX2 auf dem Host,
+// skalar auf ESP32) ganze Blöcke am Stück umrechnen.
+class CalibrationTable {
+public:
+  explicit CalibrationTable(std::size_t channels = 0);
+
+  void resize(std::size_t channels);
+  void set(std::size_t ch, const ChannelCalib& c);
+  ChannelCalib get(std::size_t ch) const;
+  std::size_t channels() const noexcept { return scale_.size(); }
+
+  // Rechnet channels() Register um. out/q müssen channels() Plätze haben.
+  void apply(const uint16_t* raw, float* out, Quality* q) const noexcept;
+  void apply(const int16_t*  raw, float* out, Quality* q) const noexcept;
+
+  // Komfort für Modbus-Puffer; false, wenn raw zu kurz ist
+  bool apply(const std::vector<uint16_t>& raw, std::vector<float>& out,
+             std::vector<Quality>& q, bool is_signed = false) const;
+
+private:
+  std::vector<float> scale_;
+  std::vector<float> offset_;
+  std::vector<float> min_;
+  std::vector<float> max_;
+};
+
+namespace calib {
+
+// Rohe Kernel, n beliebig (Rest wird skalar verarbeitet).
+// q erhält static_cast<uint8_t>(Quality::Good|Bad).
+void convert_u16(const uint16_t* raw, const float* scale, const float* offset,
+                 const float* min, const float* max,
+                 float* out, uint8_t* q, std::size_t n) noexcept;
+void convert_i16(const int16_t* raw, const float* scale, const float* offset,
+                 const float* min, const float* max,
+                 float* out, uint8_t* q, std::size_t n) noexcept;
+
+// Name des zur Laufzeit gewählten Kernels ("avx2", "sse2", "scalar")
+const char* kernel_name() noexcept;
+
+} // namespace calib
+
+} // namespace core
@@ -0,0 +1,103 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "core/metric_bus.h"
+#include "core/metric.h"
+#include "core/metric_record.h"
+#include "core/enums.h"
+#include "core/ids.h"
+
+namespace core {
+
+// Aktueller Systemzustand spaltenweise (Struct-of-Arrays): ein dichter Slot
+// pro (instance, metric), parallele Arrays für Schlüssel, Wert, Zeitstempel,
+// Quality und Unit. Ganzzustands-Operationen (Stale-Scan, Export) laufen als
+// enge Schleifen über zusammenhängenden Speicher statt über Metric-Objekte.
+//
+// Schreiber (Bus-Callback) aktualisieren inkrementell einen Back-Buffer;
+// commit() veröffentlicht ihn als unveränderlichen Frame. Leser halten den
+// Frame per shared_ptr so lange sie wollen; hält niemand mehr den vorigen
+// Frame, wird er zum nächsten Back-Buffer (nur geänderte Slots kopiert).
+class ColumnarSnapshot {
+public:
+  struct Frame {
+    std::vector<uint32_t> instance;
+    std::vector<uint16_t> metric;
+    std::vector<float>    value;     // int32/bool als float
+    std::vector<uint64_t> ts_ms;
+    std::vector<uint8_t>  quality;   // Quality, fehlt -> Good
+    std::vector<uint8_t>  unit;      // Unit, fehlt -> None
+    std::vector<uint8_t>  datatype;  // ursprünglicher DataType
+    uint64_t version{0};             // Anzahl commits
+
+    std::size_t size() const noexcept { return value.size(); }
+
+    // Slots, deren letzter Wert älter als max_age_ms ist
+    std::size_t count_stale(uint64_t now_ms, uint64_t max_age_ms) const noexcept;
+    bool        any_stale(uint64_t now_ms, uint64_t max_age_ms) const noexcept;
+    void        stale_slots(uint64_t now_ms, uint64_t max_age_ms, std::vector<uint32_t>& out) const;
+    std::size_t count_quality(Quality q) const noexcept;
+
+    // Gesamter Zustand als Records (Unit/Quality als Props), z.B. für IPC/UI
+    void to_records(std::vector<MetricRecord>& out) const;
+  };
+  using FramePtr = std::shared_ptr<const Frame>;
+
+  ColumnarSnapshot();
+  // abonniert den Bus; Slots entstehen beim ersten Auftreten eines Schlüssels
+  explicit ColumnarSnapshot(MetricBus& bus);
+
+  ColumnarSnapshot(const ColumnarSnapshot&) = delete;
+  ColumnarSnapshot& operator=(const ColumnarSnapshot&) = delete;
+
+  // Schreiberseite (thread-safe)
+  void update(const Metric& m);
+  // Back-Buffer veröffentlichen; liefert den neuen Frame
+  FramePtr commit();
+
+  // Leserseite (thread-safe, blockiert Schreiber nicht)
+  FramePtr current() const;
+
+  // Slots sind stabil (append-only) und gelten für alle späteren Frames
+  std::optional<uint32_t> slot_of(Metric::InstanceId instance, MetricID metric) const;
+  std::size_t slot_count() const;
+  // Frames, die wegen noch gehaltener Leser-Referenz neu angelegt wurden
+  uint64_t full_copies() const;
+
+private:
+  static uint64_t key_of(Metric::InstanceId instance, MetricID metric) noexcept {
+    return (uint64_t{instance} << 16) | static_cast<uint16_t>(metric);
+  }
+  // freigegebene Frames, von den shared_ptr-Deletern befüllt
+  struct Recycler {
+    static constexpr std::size_t kMaxSpare = 2;
+    std::mutex mtx;
+    std::vector<std::unique_ptr<Frame>> spare;
+  };
+
+  static void copy_slot(Frame& dst, const Frame& src, uint32_t slot);
+  void mark_dirty_(uint32_t slot);
+  std::shared_ptr<Frame> wrap_(std::unique_ptr<Frame> f);
+
+  std::shared_ptr<Recycler> recycler_;   // überlebt den Snapshot, solange Leser Frames halten
+
+  mutable std::mutex wmtx_;   // Schreiber: back_, index_, dirty_
+  std::unordered_map<uint64_t, uint32_t> index_;
+  std::shared_ptr<Frame> back_;
+  std::vector<uint32_t>  dirty_;        // seit letztem commit geänderte Slots
+  std::vector<uint8_t>   dirty_flag_;
+  uint64_t               full_copies_{0};
+
+  mutable std::mutex fmtx_;   // nur der Zeiger auf den aktuellen Frame
+  std::shared_ptr<Frame> front_;
+
+  Subscription sub_;
+};
+
+} // namespace core
@@ -7,18 +7,33 @@
 namespace core
 {
 
-  template <typename SpecTag>
-  class DeviceBase
+  // Nicht-templatierte Schnittstelle, damit Registry/Runtime Geräte mit
+  // unterschiedlichen SpecTags gemeinsam verwalten können
+  class IDevice
   {
   public:
     using InstanceId = Metric::InstanceId;
 
+    virtual ~IDevice() = default;
+
+    virtual InstanceId instance_id() const noexcept = 0;
+    virtual void tick(uint64_t ts) = 0;
+    // Erster Kontakt: true, sobald das Gerät antwortet. Darf bereits die
+    // erste Metric publizieren. Default: kein Probe nötig.
+    virtual bool probe(uint64_t ts) { (void)ts; return true; }
+    // Nächster Zeitpunkt (ms, Zeitbasis von tick), zu dem tick() etwas zu
+    // tun hat; 0 = unbekannt. Erlaubt Schleifen, bis dahin zu schlafen.
+    virtual uint64_t next_due_ms() const { return 0; }
+  };
+
+  template <typename SpecTag>
+  class DeviceBase : public IDevice
+  {
+  public:
     DeviceBase(MetricBus &bus, InstanceId id) : bus_(bus), id_(id) {}
-    virtual ~DeviceBase() = default;
 
-    InstanceId instance_id() const noexcept { return id_; }
+    InstanceId instance_id() const noexcept override { return id_; }
     MetricBus &bus() noexcept { return bus_; }
-    virtual void tick(uint64_t ts) = 0;
   protected:
     // compile-time Enforcement: nur erlaubte MetricIDs
     template <MetricID ID>
@@ -0,0 +1,82 @@
+#pragma once
+// Kleine Map mit fester Kapazität (lineare Suche, Einfügereihenfolge).
+// Ersetzt std::unordered_map für Metric::PropMap im statischen Profil; die
+// Schnittstelle deckt find/emplace/Iteration ab. emplace() auf eine volle
+// Map liefert {end(), false}.
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <tuple>
+#include <utility>
+
+#include "core/static_vector.h"
+
+namespace core {
+
+template<typename K, typename V, std::size_t N>
+class FlatMap {
+public:
+  using key_type       = K;
+  using mapped_type    = V;
+  using value_type     = std::pair<K, V>;
+  using size_type      = std::size_t;
+  using iterator       = value_type*;
+  using const_iterator = const value_type*;
+
+  FlatMap() = default;
+  FlatMap(std::initializer_list<value_type> il) {
+    for (const auto& kv : il) emplace(kv.first, kv.second);
+  }
+
+  static constexpr size_type capacity() noexcept { return N; }
+  size_type size()  const noexcept { return items_.size(); }
+  bool      empty() const noexcept { return items_.empty(); }
+
+  iterator       begin()       noexcept { return items_.begin(); }
+  iterator       end()         noexcept { return items_.end(); }
+  const_iterator begin() const noexcept { return items_.begin(); }
+  const_iterator end()   const noexcept { return items_.end(); }
+
+  iterator find(const K& k) noexcept {
+    return std::find_if(begin(), end(), [&](const value_type& kv) { return kv.first == k; });
+  }
+  const_iterator find(const K& k) const noexcept {
+    return std::find_if(begin(), end(), [&](const value_type& kv) { return kv.first == k; });
+  }
+  size_type count(const K& k) const noexcept { return find(k) != end() ? 1 : 0; }
+
+  // wie std::unordered_map: vorhandener Schlüssel wird nicht überschrieben
+  template<typename... Args>
+  std::pair<iterator, bool> emplace(const K& k, Args&&... args) {
+    if (auto it = find(k); it != end()) return {it, false};
+    if (!items_.emplace_back(std::piecewise_construct, std::forward_as_tuple(k),
+                             std::forward_as_tuple(std::forward<Args>(args)...))) {
+      return {end(), false};
+    }
+    return {end() - 1, true};
+  }
+
+  size_type erase(const K& k) {
+    auto it = find(k);
+    if (it == end()) return 0;
+    items_.erase(it);
+    return 1;
+  }
+  void clear() noexcept { items_.clear(); }
+
+  // unabhängig von der Einfügereihenfolge
+  friend bool operator==(const FlatMap& a, const FlatMap& b) {
+    if (a.size() != b.size()) return false;
+    for (const auto& kv : a) {
+      auto it = b.find(kv.first);
+      if (it == b.end() || !(it->second == kv.second)) return false;
+    }
+    return true;
+  }
+  friend bool operator!=(const FlatMap& a, const FlatMap& b) { return !(a == b); }
+
+private:
+  StaticVector<value_type, N> items_;
+};
+
+} // namespace core
@@ -18,6 +18,7 @@ enum class MetricID : uint16_t {
 
   // Tilt/IMU (0x120x)
   TiltAngle    = 0x1201,
+  TiltAngleSmoothed = 0x1202,  // abgeleitet (stream::DerivedMetric)
 
   // Generic (0x200x)
   Temperature  = 0x2001,
@@ -25,6 +26,7 @@ enum class MetricID : uint16_t {
 
   // Health (0xF0xx)
   Health       = 0xFF01,
+  Alarm        = 0xFF02,  // bool, Zustand einer Alarm-Regel (RuleEngine)
 };
 
 } // namespace core
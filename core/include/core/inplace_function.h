@@ -0,0 +1,84 @@
+#pragma once
+// Funktionsobjekt wie std::function, aber ohne Heap: das Callable liegt in
+// einem Puffer von Bytes Bytes im Objekt. Ein zu großes Callable ist ein
+// Compile-Fehler (static_assert), keine Allokation. Für MetricBus::Callback
+// im statischen Profil (CARAVAN_CALLBACK_BYTES).
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace core {
+
+template<typename Sig, std::size_t Bytes>
+class InplaceFunction;
+
+template<typename R, typename... Args, std::size_t Bytes>
+class InplaceFunction<R(Args...), Bytes> {
+public:
+  InplaceFunction() noexcept = default;
+  InplaceFunction(std::nullptr_t) noexcept {}
+
+  template<typename F, typename D = std::decay_t<F>,
+           typename = std::enable_if_t<!std::is_same_v<D, InplaceFunction> &&
+                                       std::is_invocable_r_v<R, D&, Args...>>>
+  InplaceFunction(F&& f) {
+    static_assert(sizeof(D) <= Bytes, "callable too large for InplaceFunction (raise CARAVAN_CALLBACK_BYTES)");
+    static_assert(alignof(D) <= alignof(std::max_align_t), "over-aligned callable");
+    ::new (static_cast<void*>(buf_)) D(std::forward<F>(f));
+    ops_ = &kOps<D>;
+  }
+
+  InplaceFunction(const InplaceFunction& o) : ops_(o.ops_) {
+    if (ops_) ops_->copy(buf_, o.buf_);
+  }
+  InplaceFunction(InplaceFunction&& o) noexcept : ops_(o.ops_) {
+    if (ops_) { ops_->move(buf_, o.buf_); o.reset_(); }
+  }
+  InplaceFunction& operator=(const InplaceFunction& o) {
+    if (this != &o) { reset_(); if (o.ops_) { o.ops_->copy(buf_, o.buf_); ops_ = o.ops_; } }
+    return *this;
+  }
+  InplaceFunction& operator=(InplaceFunction&& o) noexcept {
+    if (this != &o) {
+      reset_();
+      if (o.ops_) { o.ops_->move(buf_, o.buf_); ops_ = o.ops_; o.reset_(); }
+    }
+    return *this;
+  }
+  InplaceFunction& operator=(std::nullptr_t) noexcept { reset_(); return *this; }
+  ~InplaceFunction() { reset_(); }
+
+  explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+  R operator()(Args... args) const {
+    return ops_->call(const_cast<unsigned char*>(buf_), std::forward<Args>(args)...);
+  }
+
+private:
+  struct Ops {
+    R    (*call)(void*, Args&&...);
+    void (*copy)(void* dst, const void* src);
+    void (*move)(void* dst, void* src) noexcept;
+    void (*destroy)(void*) noexcept;
+  };
+
+  template<typename D>
+  static inline const Ops kOps{
+    [](void* p, Args&&... a) -> R { return (*static_cast<D*>(p))(std::forward<Args>(a)...); },
+    [](void* dst, const void* src) { ::new (dst) D(*static_cast<const D*>(src)); },
+    [](void* dst, void* src) noexcept {
+      ::new (dst) D(std::move(*static_cast<D*>(src)));
+    },
+    [](void* p) noexcept { static_cast<D*>(p)->~D(); },
+  };
+
+  void reset_() noexcept {
+    if (ops_) { ops_->destroy(buf_); ops_ = nullptr; }
+  }
+
+  alignas(std::max_align_t) unsigned char buf_[Bytes];
+  const Ops* ops_{nullptr};
+};
+
+} // namespace core
@@ -7,6 +7,8 @@
 #include "core/enums.h"
 #include "core/ids.h"
 #include "core/enum_hash.hpp"
+#include "core/flat_map.h"
+#include "core/static_config.h"
 
 namespace core {
 
@@ -16,7 +18,12 @@ public:
 
   using Value     = std::variant<float, int32_t, bool>;
   using PropValue = std::variant<uint8_t, int32_t, float>;
+#if CARAVAN_STATIC
+  // feste Kapazität im Objekt (CARAVAN_MAX_PROPS), keine Allokation
+  using PropMap   = FlatMap<PropertyKey, PropValue, caps::kMaxProps>;
+#else
   using PropMap   = std::unordered_map<PropertyKey, PropValue, detail::enum_hash<PropertyKey>>;
+#endif
 
   // Fabrik
   static Metric Make(InstanceId id, MetricID metric_id, Value v,
@@ -46,8 +53,9 @@ public:
     return std::nullopt;
   }
 
-  // Props
-  void set_prop(PropertyKey k, PropValue v);
+  // Props; vorhandener Schlüssel bleibt. false nur, wenn die PropMap voll ist
+  // (statisches Profil)
+  bool set_prop(PropertyKey k, PropValue v);
   template<typename T>
   std::optional<T> try_get_prop(PropertyKey k) const {
     auto it = props_.find(k);
@@ -1,5 +1,7 @@
 #pragma once
+#include <array>
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -7,6 +9,12 @@
 #include <vector>
 
 #include "core/metric.h"
+#include "core/seq_tracker.h"
+#include "core/static_config.h"
+#if CARAVAN_STATIC
+#include "core/inplace_function.h"
+#include "core/static_vector.h"
+#endif
 
 namespace core {
 
@@ -14,28 +22,173 @@ class Subscription;
 
 class MetricBus {
 public:
+#if CARAVAN_STATIC
+  // Captures bis CARAVAN_CALLBACK_BYTES, sonst Compile-Fehler
+  using Callback = InplaceFunction<void(const Metric&), caps::kCallbackBytes>;
+#else
   using Callback = std::function<void(const Metric&)>;
+#endif
 
-  MetricBus() = default;
+  // Partitionierung der Shards
+  enum class ShardKey : uint8_t {
+    Instance = 0,   // Shard = hash(instance_id)
+    Metric   = 1    // Shard = hash(metric_id)
+  };
+
+  // Verhalten bei publish() aus einem Callback desselben Busses
+  enum class Reentrancy : uint8_t {
+    Recursive = 0,   // sofort zustellen (Tiefensuche, wächst den Stack)
+    Deferred  = 1    // in die Queue des Threads; der äußerste publish() arbeitet
+                     // sie FIFO ab (Breitensuche, konstante Stacktiefe)
+  };
+
+  struct Options {
+    // Anzahl Shards; 1 = ein Lock wie bisher, 0 = std::thread::hardware_concurrency()
+    // (statisches Profil: höchstens CARAVAN_MAX_SHARDS)
+    std::size_t shards{1};
+    ShardKey    shard_by{ShardKey::Instance};
+    Reentrancy  reentrancy{Reentrancy::Recursive};
+    uint32_t    max_depth{32};     // verschachtelte Publishes (äußerster = 0), darüber verworfen
+    std::size_t max_queue{1024};   // nur Deferred: ausstehende Metriken pro Thread
+                                   // (statisches Profil: höchstens CARAVAN_MAX_DEFERRED)
+    // seq pro Instanz prüfen (SeqTracker) und Duplikate vor dem Fan-out
+    // verwerfen; für Busse hinter Queues/Bridges/Replay
+    bool        track_seq{false};
+    std::size_t seq_instances{64}; // pro Shard (statisches Profil: insgesamt,
+                                   // höchstens CARAVAN_MAX_SEQ_INSTANCES)
+  };
+
+  MetricBus() : MetricBus(Options{}) {}
+  explicit MetricBus(Options opt);
   ~MetricBus() = default;
 
-  // Anmelden; Rückgabe: RAII-Subscription (destructor -> unsubscribe)
+  MetricBus(const MetricBus&)            = delete;
+  MetricBus& operator=(const MetricBus&) = delete;
+
+  // Anmelden; Rückgabe: RAII-Subscription (destructor -> unsubscribe).
+  // Statisches Profil: bei CARAVAN_MAX_SUBSCRIBERS aktiven Subscriptions
+  // leere Subscription (!sub) und capacity_overflows() + 1.
   Subscription subscribe(Callback cb);
+  // Nur Metriken mit dieser MetricID. Bei ShardKey::Metric wird nur im
+  // zuständigen Shard registriert.
+  Subscription subscribe(MetricID id, Callback cb);
+  // O(1) pro Shard; veraltete Handles (Slot inzwischen neu vergeben) -> false
   bool unsubscribe(uint64_t id);
-
-  // Verteilt by-value an alle aktiven Subscriber
+  std::size_t subscriber_count() const;
+
+  // Verteilt by-value an alle aktiven Subscriber.
+  // Sperrt nur den Shard der Metric; ein Schlüssel (instance, metric) liegt
+  // immer im selben Shard und wird synchron im Thread des Publishers
+  // zugestellt -> Reihenfolge pro Schlüssel bleibt erhalten.
+  // Mit Options::track_seq werden Duplikate (gleiche oder bereits gesehene
+  // seq derselben Instanz) vorher verworfen und gezählt.
+  // Re-entrante Publishes werden je nach Options::reentrancy direkt oder
+  // über die Thread-Queue zugestellt; über max_depth/max_queue -> verworfen
+  // und in reentrancy_overflows() gezählt.
   void publish(const Metric& m);
 
+  uint64_t reentrancy_overflows() const noexcept {
+    return overflows_.load(std::memory_order_relaxed);
+  }
+  // Statisches Profil: abgelehnte subscribe() und publish(), deren
+  // Thread bereits CARAVAN_MAX_NESTED_BUSES Busse zustellt; sonst immer 0
+  uint64_t capacity_overflows() const noexcept {
+    return capacity_overflows_.load(std::memory_order_relaxed);
+  }
+
+  // Options::track_seq: Summe über alle Shards (Lücken, Duplikate, ...);
+  // sonst leer
+  SeqTracker::Stats seq_stats() const;
+
+  std::size_t shard_count() const noexcept { return n_shards_; }
+  std::size_t shard_of(const Metric& m) const noexcept {
+    return shard_of_(shard_by_ == ShardKey::Instance
+                       ? m.instance_id()
+                       : static_cast<uint32_t>(m.metric_id()));
+  }
+
 private:
-  struct Subscriber {
-    uint64_t id;
-    Callback cb;
-    bool     active;
+  // Slot-Map: Handle = (Generation << 32) | (Index + 1). Ein freigegebener
+  // Slot bekommt eine neue Generation -> alte Handles laufen ins Leere.
+  struct Slot {
+    uint32_t gen{1};
+    uint32_t next_free{0};   // Index + 1, 0 = Ende der Freiliste
+    bool     live{false};
+  };
+
+  // dichter Eintrag pro Shard, wird von publish() linear gelesen
+  struct Entry {
+    Callback cb;          // leer = Grabstein (wird lazy kompaktiert)
+    uint32_t slot;
+    bool     filtered;
+    MetricID filter;
+  };
+
+  // eigene Cache-Line pro Shard, damit Publisher sich nicht gegenseitig stören
+  struct alignas(64) Shard {
+    std::mutex            mtx;
+#if CARAVAN_STATIC
+    StaticVector<Entry, caps::kMaxSubscribers>   dense;
+    std::array<uint32_t, caps::kMaxSubscribers> where{};
+#else
+    std::vector<Entry>    dense;   // Registrierungsreihenfolge
+    std::vector<uint32_t> where;   // Slot-Index -> Position in dense + 1 (0 = nicht hier)
+#endif
+    std::size_t           dead{0};
   };
 
-  std::mutex mtx_;
-  std::vector<std::shared_ptr<Subscriber>> subs_;
-  std::atomic<uint64_t> next_id_{1};
+  // SeqTracker pro Shard, nach instance_id verteilt (unabhängig von
+  // shard_by, damit eine Instanz immer im selben Tracker landet).
+  // Statisches Profil: ein Tracker für alle Shards (Speicher vor Parallelität)
+  struct alignas(64) SeqStripe {
+    mutable std::mutex mtx;
+    SeqTracker         tracker;
+  };
+
+  std::size_t seq_stripes_() const noexcept { return caps::kStatic ? 1 : n_shards_; }
+  std::size_t seq_stripe_(uint32_t instance) const noexcept {
+    return caps::kStatic ? 0 : shard_of_(instance);
+  }
+
+  std::size_t shard_of_(uint32_t k) const noexcept {
+    // Fibonacci-Hashing, damit benachbarte IDs verteilt werden
+    return n_shards_ == 1 ? 0
+         : static_cast<std::size_t>((k * 0x9E3779B97F4A7C15ull) >> 32) % n_shards_;
+  }
+  Subscription subscribe_(Callback cb, bool filtered, MetricID filter);
+  void publish_deferred_(const Metric& m);
+  void dispatch_(const Metric& m);
+  static void link_(Shard& sh, uint32_t idx, const Entry& e);
+  static void unlink_(Shard& sh, uint32_t idx);
+  static void compact_(Shard& sh);
+
+  std::size_t              n_shards_{1};
+  ShardKey                 shard_by_{ShardKey::Instance};
+  Reentrancy               reentrancy_{Reentrancy::Recursive};
+  uint32_t                 max_depth_{32};
+  std::size_t              max_queue_{1024};
+#if CARAVAN_STATIC
+  std::array<Shard, caps::kMaxShards> shards_;
+#else
+  std::unique_ptr<Shard[]> shards_;
+#endif
+#if CARAVAN_STATIC
+  std::array<SeqStripe, 1> seq_;
+#else
+  std::unique_ptr<SeqStripe[]> seq_;   // nur mit track_seq
+#endif
+  bool                     track_seq_{false};
+  std::atomic<uint64_t>    overflows_{0};
+  std::atomic<uint64_t>    capacity_overflows_{0};
+
+  mutable std::mutex pool_mtx_;
+#if CARAVAN_STATIC
+  StaticVector<Slot, caps::kMaxSubscribers> slots_;
+#else
+  std::vector<Slot>  slots_;
+#endif
+  uint32_t           free_head_{0};   // Index + 1, 0 = leer
+  std::size_t        live_{0};
 
   friend class Subscription;
 };
@@ -55,6 +208,9 @@ public:
   Subscription& operator=(const Subscription&) = delete;
 
   void unsubscribe();
+  uint64_t id() const noexcept { return id_; }
+  // false für leere/abgemeldete Subscriptions (auch: abgelehnt, Kapazität voll)
+  explicit operator bool() const noexcept { return id_ != 0; }
 
 private:
   Subscription(MetricBus* bus, uint64_t id) : bus_(bus), id_(id) {}
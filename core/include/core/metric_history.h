@@ -0,0 +1,174 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "core/metric_bus.h"
+#include "core/metric.h"
+#include "core/enums.h"
+#include "core/ids.h"
+
+namespace core {
+
+// Komprimierte Langzeit-Historie nach dem Gorilla-Verfahren: pro Serie
+// (instance, metric) append-only Blöcke mit Delta-of-Delta-Zeitstempeln und
+// XOR-kodierten Werten (32 Bit: float, int32 oder bool). Regelmäßig
+// gepollte, langsam veränderliche Werte brauchen so 1-2 Byte pro Punkt
+// statt eines 64-Byte-MetricRecord.
+//
+// Blockformat (little endian): [version:1][datatype:1][count:4], danach
+// der Bitstrom (MSB zuerst):
+//   erster Punkt: ts 64 Bit, Wert 32 Bit, Quality 2 Bit
+//   weitere:      ts  '0' | '10'+7 | '110'+9 | '1110'+12 | '1111'+64 Bit (dod)
+//                 Wert '0' (gleich) | '10'+Bits im vorigen Fenster
+//                      | '11'+5 Bit führende Nullen+5 Bit (Länge-1)+Bits
+//                 Quality '0' (gleich) | '1'+2 Bit
+struct HistoryPoint {
+  uint64_t      ts_ms{0};
+  Metric::Value value{};
+  Quality       quality{Quality::Good};
+};
+
+class HistoryEncoder {
+public:
+  static constexpr std::size_t kHeaderBytes = 6;
+
+  explicit HistoryEncoder(DataType type = DataType::Float, std::size_t max_bytes = 4096);
+
+  // false (nichts geschrieben): Zeitstempel kleiner als der letzte, Wert vom
+  // falschen Typ, oder der Block hat keinen Platz mehr für einen Punkt
+  bool append(uint64_t ts_ms, const Metric::Value& v, Quality q = Quality::Good);
+
+  DataType    type()        const noexcept { return type_; }
+  uint32_t    count()       const noexcept { return count_; }
+  std::size_t size_bytes()  const noexcept { return bytes_.size(); }
+  uint64_t    first_ts_ms() const noexcept { return first_ts_; }
+  uint64_t    last_ts_ms()  const noexcept { return prev_ts_; }
+  // vollständiger Block (Header + Bitstrom), jederzeit dekodierbar
+  const std::vector<uint8_t>& bytes() const noexcept { return bytes_; }
+
+private:
+  void put_(uint64_t bits, unsigned n);
+
+  DataType             type_;
+  std::size_t          max_bytes_;
+  std::vector<uint8_t> bytes_;
+  unsigned             free_bits_{0};   // ungenutzte Bits im letzten Byte
+  uint32_t             count_{0};
+  uint64_t             first_ts_{0};
+  uint64_t             prev_ts_{0};
+  int64_t              prev_delta_{0};
+  uint32_t             prev_bits_{0};
+  uint8_t              prev_lead_{0xFF};   // 0xFF = noch kein Fenster
+  uint8_t              prev_trail_{0};
+  Quality              prev_q_{Quality::Good};
+};
+
+// Streaming-Dekoder über einen Block; liest nie über size hinaus
+class HistoryDecoder {
+public:
+  HistoryDecoder(const uint8_t* data, std::size_t size);
+  explicit HistoryDecoder(const std::vector<uint8_t>& block) : HistoryDecoder(block.data(), block.size()) {}
+
+  // nächster Punkt; false am Ende oder bei defektem Block (dann !ok())
+  bool next(HistoryPoint& out);
+  bool     ok()    const noexcept { return ok_; }
+  uint32_t count() const noexcept { return count_; }
+  DataType type()  const noexcept { return type_; }
+
+private:
+  bool get_(unsigned n, uint64_t& out);
+  bool bit_(bool& out);
+
+  const uint8_t* data_;
+  std::size_t    size_;
+  std::size_t    pos_{0};   // Bitposition im Strom
+  bool           ok_{true};
+  DataType       type_{DataType::Float};
+  uint32_t       count_{0};
+  uint32_t       read_{0};
+  uint64_t       prev_ts_{0};
+  int64_t        prev_delta_{0};
+  uint32_t       prev_bits_{0};
+  uint8_t        prev_lead_{0xFF};
+  uint8_t        prev_trail_{0};
+  Quality        prev_q_{Quality::Good};
+};
+
+// Historie aller Serien, z.B. vom Bus gespeist. Volle Blöcke werden
+// versiegelt (unveränderlich, per shared_ptr an Leser gegeben); pro Serie
+// fallen die ältesten Blöcke weg, wenn max_bytes_per_series überschritten ist.
+class MetricHistory {
+public:
+  struct Config {
+    std::size_t block_bytes{4096};
+    std::size_t max_bytes_per_series{256 * 1024};
+  };
+
+  struct Block {
+    uint64_t             first_ts_ms{0};
+    uint64_t             last_ts_ms{0};
+    uint32_t             count{0};
+    std::vector<uint8_t> bytes;   // dekodierbar mit HistoryDecoder
+  };
+  using BlockPtr = std::shared_ptr<const Block>;
+
+  struct Stats {
+    std::size_t series{0};
+    std::size_t blocks{0};       // inkl. offener Blöcke
+    uint64_t    points{0};       // gespeichert (nach Verdrängung)
+    std::size_t bytes{0};
+    uint64_t    out_of_order{0}; // verworfen: älter als der letzte Punkt der Serie
+    uint64_t    evicted_blocks{0};
+  };
+
+  MetricHistory() : MetricHistory(Config{}) {}
+  explicit MetricHistory(Config cfg);
+  // abonniert den Bus; jede Metric wird an ihre Serie angehängt
+  MetricHistory(MetricBus& bus, Config cfg);
+
+  MetricHistory(const MetricHistory&)            = delete;
+  MetricHistory& operator=(const MetricHistory&) = delete;
+
+  // thread-safe; false bei Punkten außer der Reihe
+  bool append(const Metric& m);
+
+  // Punkte mit from_ms <= ts <= to_ms in Zeitreihenfolge; fn liefert false
+  // zum Abbrechen. Dekodiert ohne Lock auf Kopien/versiegelten Blöcken.
+  // Rückgabe: Anzahl gelieferter Punkte.
+  std::size_t query(Metric::InstanceId instance, MetricID metric, uint64_t from_ms, uint64_t to_ms,
+                    const std::function<bool(const HistoryPoint&)>& fn) const;
+
+  // Blöcke einer Serie (der offene als Kopie), z.B. zum Persistieren
+  std::vector<BlockPtr> blocks(Metric::InstanceId instance, MetricID metric) const;
+
+  Stats stats() const;
+
+private:
+  static uint64_t key_of(Metric::InstanceId instance, MetricID metric) noexcept {
+    return (uint64_t{instance} << 16) | static_cast<uint16_t>(metric);
+  }
+  struct Series {
+    std::deque<BlockPtr> sealed;
+    HistoryEncoder       open;
+    std::size_t          sealed_bytes{0};
+    uint64_t             sealed_points{0};
+  };
+
+  void seal_(Series& s, DataType next_type);
+  static BlockPtr snapshot_(const HistoryEncoder& e);
+
+  Config cfg_;
+  mutable std::mutex mtx_;
+  std::unordered_map<uint64_t, Series> series_;
+  uint64_t out_of_order_{0};
+  uint64_t evicted_{0};
+  Subscription sub_;
+};
+
+} // namespace core
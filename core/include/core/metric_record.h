@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "core/metric.h"
+
+namespace core {
+
+// Feste, trivial kopierbare Darstellung einer Metric (64 Byte, Host-Byteorder)
+// für Shared Memory, Sockets und Puffer ohne Heap.
+// Props: ein 4-Byte-Slot pro PropertyKey (Key 1..8), Typ in prop_types
+// (2 Bit pro Slot: 0 = fehlt, 1 = uint8, 2 = int32, 3 = float).
+struct MetricRecord {
+  static constexpr std::size_t kPropSlots = 8;
+
+  uint64_t timestamp_ms;
+  uint32_t instance_id;
+  uint32_t seq;
+  uint16_t metric_id;
+  uint8_t  datatype;
+  uint8_t  reserved0;
+  uint16_t prop_types;
+  uint16_t reserved1;
+  uint32_t value;                  // Bitmuster von float/int32/bool
+  uint32_t props[kPropSlots];
+  uint32_t reserved2;
+};
+
+static_assert(std::is_trivially_copyable<MetricRecord>::value, "MetricRecord must be POD");
+static_assert(sizeof(MetricRecord) == 64, "MetricRecord must stay 64 bytes");
+
+// Metric -> Record. Props mit Key > 8 passen nicht und werden weggelassen.
+MetricRecord to_record(const Metric& m) noexcept;
+// Record -> Metric (Props wieder als PropMap)
+Metric from_record(const MetricRecord& r);
+
+} // namespace core
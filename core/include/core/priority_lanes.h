@@ -0,0 +1,112 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "core/metric_bus.h"
+#include "core/metric.h"
+#include "core/ids.h"
+
+namespace core {
+
+// Prioritätsklassen für gepufferte/überbrückte Zustellung (0 = höchste)
+enum class Priority : uint8_t {
+  High   = 0,   // Health, Alarme: nie verworfen
+  Normal = 1,
+  Bulk   = 2    // hochfrequente Telemetrie (z.B. Tilt-Samples)
+};
+constexpr std::size_t kPriorityCount = 3;
+
+// Zuordnung MetricID-Bereich -> Priority. Spätere assign() überschreiben frühere.
+// Default: 0xFF00..0xFFFF (Health/Diagnose) = High, alles andere Normal.
+class LaneMap {
+public:
+  LaneMap();
+
+  void assign(uint16_t first, uint16_t last, Priority p);
+  void assign(MetricID id, Priority p) {
+    assign(static_cast<uint16_t>(id), static_cast<uint16_t>(id), p);
+  }
+  Priority lane_of(MetricID id) const noexcept;
+
+private:
+  struct Range { uint16_t first, last; Priority p; };
+  std::vector<Range> ranges_;
+};
+
+// Gepufferte Zustellung in Prioritäts-Lanes an einen Ziel-Bus.
+// post() ist thread-safe; drain() liefert immer zuerst aus der höchsten
+// nicht-leeren Lane (auch neu eingetroffene High-Metriken überholen wartende
+// Bulk-Metriken). Die High-Lane ist von der Drop-Policy ausgenommen.
+class LaneDispatcher {
+public:
+  enum class DropPolicy : uint8_t { DropOldest, DropNewest };
+
+  struct LaneConfig {
+    std::size_t capacity{1024};
+    DropPolicy  drop{DropPolicy::DropOldest};
+  };
+
+  struct Config {
+    LaneMap map{};
+    std::array<LaneConfig, kPriorityCount> lanes{{
+      {0,    DropPolicy::DropOldest},   // High: unbegrenzt
+      {1024, DropPolicy::DropOldest},
+      {256,  DropPolicy::DropOldest},
+    }};
+  };
+
+  // Latenz post() -> Zustellung, Histogramm in Zweierpotenzen (ns)
+  struct LaneStats {
+    uint64_t posted{0};
+    uint64_t delivered{0};
+    uint64_t dropped{0};
+    uint64_t lat_max_ns{0};
+    uint64_t lat_sum_ns{0};
+    std::array<uint64_t, 64> lat_hist{};
+
+    double   mean_ns() const noexcept { return delivered ? double(lat_sum_ns) / double(delivered) : 0.0; }
+    // Obergrenze des Buckets, in dem das Perzentil liegt
+    uint64_t percentile_ns(double p) const noexcept;
+  };
+
+  explicit LaneDispatcher(MetricBus& target) : LaneDispatcher(target, Config{}) {}
+  LaneDispatcher(MetricBus& target, Config cfg);
+
+  LaneDispatcher(const LaneDispatcher&)            = delete;
+  LaneDispatcher& operator=(const LaneDispatcher&) = delete;
+
+  // Einreihen; false, wenn genau diese Metric verworfen wurde (DropNewest)
+  bool post(const Metric& m);
+
+  // Leitet alles von `source` in die Lanes (Bridge Bus -> Lanes -> target)
+  Subscription feed_from(MetricBus& source);
+
+  // Stellt bis zu max Metriken zu, höchste Lane zuerst. Rückgabe: Anzahl.
+  std::size_t drain(std::size_t max = SIZE_MAX);
+
+  std::size_t pending() const;
+  std::size_t pending(Priority p) const;
+  LaneStats   stats(Priority p) const;
+  void        reset_stats();
+  Priority    lane_of(MetricID id) const noexcept { return cfg_.map.lane_of(id); }
+
+private:
+  struct Entry {
+    Metric   m;
+    uint64_t enq_ns;
+  };
+
+  static uint64_t now_ns_() noexcept;
+
+  MetricBus&         target_;
+  Config             cfg_;
+  mutable std::mutex mtx_;
+  std::array<std::deque<Entry>, kPriorityCount> lanes_;
+  std::array<LaneStats, kPriorityCount>         stats_;
+};
+
+} // namespace core
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core/metric_bus.h"
+#include "core/metric.h"
+#include "core/ids.h"
+
+namespace core {
+
+// Alarm-Regel auf genau einen Schlüssel (metric, instance).
+// Zustandswechsel werden als MetricID::Alarm (bool) unter alarm_instance publiziert.
+struct Rule {
+  enum class Op : uint8_t { Above, Below, Equal, NotEqual };
+
+  MetricID           metric{MetricID::Health};
+  Metric::InstanceId instance{0};
+  Op                 op{Op::Above};
+  float              threshold{0.0f};
+  float              hysteresis{0.0f};   // Abstand der Rücksetzschwelle (Above/Below)
+  uint32_t           debounce_ms{0};     // Bedingung muss so lange anstehen (beide Richtungen)
+  Metric::InstanceId alarm_instance{0};
+};
+
+// Tabellengetriebene Regelauswertung beim Publish.
+// load() kompiliert die Regeln in flache Tabellen: Regeln sortiert nach
+// Schlüssel (zusammenhängend), dazu ein Open-Addressing-Index
+// Schlüssel -> [first, first+count). Pro Publish wird nur der Index
+// abgefragt und die Regeln dieses Schlüssels ausgewertet.
+class RuleEngine {
+public:
+  explicit RuleEngine(MetricBus& bus);
+
+  RuleEngine(const RuleEngine&)            = delete;
+  RuleEngine& operator=(const RuleEngine&) = delete;
+
+  // Ersetzt alle Regeln (Alarmzustände werden zurückgesetzt).
+  // Regeln auf MetricID::Alarm sind nicht erlaubt (die Engine wertet eigene
+  // Ausgaben nicht aus): false, err gesetzt, geladene Regeln bleiben unverändert.
+  // Mehrere Regeln dürfen sich eine alarm_instance teilen; der Alarm ist aktiv,
+  // solange mindestens eine davon aktiv ist (eine seq-Folge pro alarm_instance).
+  bool load(std::vector<Rule> rules, std::string* err = nullptr);
+
+  // Textformat, eine Regel pro Zeile, '#' = Kommentar:
+  //   <metric> <instance> <op> <threshold> [hysteresis] [debounce_ms] <alarm_instance>
+  // metric: Name (z.B. GasLevelPercent) oder Zahl (0x1101); op: > < == !=
+  // Bei Fehler: false, err enthält Zeile und Grund; geladene Regeln bleiben unverändert.
+  bool load_config(std::istream& in, std::string* err = nullptr);
+  bool load_file(const std::string& path, std::string* err = nullptr);
+
+  // Wertet die Regeln für m aus (wird vom Bus-Callback aufgerufen).
+  // Rückgabe: Anzahl ausgewerteter Regeln.
+  std::size_t evaluate(const Metric& m);
+
+  std::size_t rule_count() const noexcept { return rules_.size(); }
+  bool alarm_active(Metric::InstanceId alarm_instance) const;
+
+  static bool parse_rule(const std::string& line, Rule& out, std::string* err = nullptr);
+
+private:
+  struct Compiled {
+    Rule     rule;
+    bool     active{false};
+    bool     pending{false};    // Wechsel steht an, Debounce läuft
+    uint64_t pending_since{0};
+    uint32_t out{0};            // Index in outputs_
+  };
+  // publizierter Zustand pro alarm_instance (ODER der zugehörigen Regeln)
+  struct Output {
+    Metric::InstanceId instance{0};
+    uint32_t           active_rules{0};
+    uint32_t           seq{0};
+  };
+  struct Slot {
+    uint64_t key{0};
+    uint32_t first{0};
+    uint32_t count{0};           // 0 = leer
+  };
+
+  static uint64_t key_of(MetricID id, Metric::InstanceId inst) noexcept {
+    return (static_cast<uint64_t>(static_cast<uint16_t>(id)) << 32) | inst;
+  }
+  const Slot* find_(uint64_t key) const noexcept;
+  // Index von inst in outputs, sonst outputs.size()
+  static std::size_t output_of_(const std::vector<Output>& outputs, Metric::InstanceId inst) noexcept;
+
+  MetricBus&            bus_;
+  mutable std::mutex    mtx_;
+  std::vector<Compiled> rules_;
+  std::vector<Output>   outputs_;   // nach instance sortiert
+  std::vector<Slot>     index_;   // Größe 2^n
+  uint64_t              mask_{0};
+  Subscription          sub_;
+};
+
+} // namespace core
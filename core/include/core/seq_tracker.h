@@ -0,0 +1,99 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/metric.h"
+#include "core/static_config.h"
+
+namespace core {
+
+// Prüft Metric::seq pro Instanz (Spezifikation: monoton pro Instanz, Reset =
+// Neustart). Flache Tabelle mit offener Adressierung, eine Zeile pro
+// InstanceId; nach dem Konstruktor keine Allokation. Zählt Lücken (verlorene
+// seq), Duplikate, Nachzügler und Neustarts. Nicht thread-safe; MetricBus
+// hält eine Instanz pro Shard unter eigenem Lock (Options::track_seq).
+//
+// Einordnung einer seq relativ zur letzten (last) der Instanz:
+//   seq == 0                        -> Untracked (ohne Nummer, nicht geprüft)
+//   seq == last + 1                 -> InOrder
+//   seq >  last + 1                 -> Gap (seq - last - 1 verloren)
+//   seq == last, oder schon gesehen -> Duplicate (verwerfen)
+//   seq <  last, <= reset_below     -> Reset (Neustart der Quelle)
+//   seq <  last, bis 64 zurück      -> Late (Nachzügler, z.B. Prioritäts-Lanes;
+//                                      zählt nicht mehr als verloren)
+//   seq <  last, weiter zurück      -> Reset
+class SeqTracker {
+public:
+  using InstanceId = Metric::InstanceId;
+
+  enum class Verdict : uint8_t { Untracked, First, InOrder, Gap, Late, Duplicate, Reset };
+
+  struct Config {
+    // Instanzen pro Tabelle; darüber -> Untracked
+    // (statisches Profil: höchstens CARAVAN_MAX_SEQ_INSTANCES)
+    std::size_t max_instances{64};
+    uint32_t    reset_below{4};   // kleinere seq nach größerer = Neustart
+  };
+
+  // pro Instanz
+  struct Entry {
+    InstanceId instance{0};
+    uint32_t   last_seq{0};
+    uint64_t   seen{0};         // Bit i: last_seq - 1 - i angekommen
+    uint32_t   received{0};
+    uint32_t   lost{0};         // netto: Lücken minus Nachzügler
+    uint32_t   duplicates{0};
+    uint16_t   resets{0};
+    bool       used{false};
+  };
+
+  struct Stats {
+    std::size_t instances{0};
+    uint64_t    received{0};    // angenommen (alles außer Duplicate/Untracked)
+    uint64_t    gaps{0};        // Lücken-Ereignisse
+    uint64_t    lost{0};        // netto verlorene seq
+    uint64_t    late{0};
+    uint64_t    duplicates{0};
+    uint64_t    resets{0};
+    uint64_t    untracked{0};   // seq 0 oder Tabelle voll
+
+    double loss_ratio() const noexcept {
+      return received + lost ? double(lost) / double(received + lost) : 0.0;
+    }
+  };
+
+  SeqTracker() : SeqTracker(Config{}) {}
+  explicit SeqTracker(Config cfg);
+
+  Verdict observe(InstanceId instance, uint32_t seq) noexcept;
+  Verdict observe(const Metric& m) noexcept { return observe(m.instance_id(), m.seq()); }
+  // alles außer Duplicate wird zugestellt
+  static bool accept(Verdict v) noexcept { return v != Verdict::Duplicate; }
+
+  // nullptr, wenn die Instanz nicht (mehr) verfolgt wird
+  const Entry* find(InstanceId instance) const noexcept;
+  const Stats& stats() const noexcept { return stats_; }
+  void clear() noexcept;
+
+private:
+  Entry* slot_(InstanceId instance, bool insert) noexcept;
+
+  Config cfg_;
+  Stats  stats_;
+#if CARAVAN_STATIC
+  // Lastfaktor <= 1/2
+  static constexpr std::size_t kTable = [] {
+    std::size_t n = 1;
+    while (n < 2 * caps::kMaxSeqInstances) n <<= 1;
+    return n;
+  }();
+  std::array<Entry, kTable> table_{};
+#else
+  std::vector<Entry> table_;
+#endif
+  std::size_t mask_{0};
+};
+
+} // namespace core
@@ -0,0 +1,57 @@
+#pragma once
+// Statisches Kapazitätsprofil (ESP32): mit CARAVAN_STATIC=1 benutzen Metric,
+// MetricBus und die Modbus-Puffer Container fester Größe; Kapazitäten werden
+// zur Compile-Zeit über DEFINES gesetzt (-DCARAVAN_STATIC=ON, preset
+// host-static). Überlauf ist ein Fehler (false / leere Subscription /
+// Zähler), nie eine Allokation. Ohne CARAVAN_STATIC gelten die Werte nicht.
+#include <cstddef>
+
+#ifndef CARAVAN_STATIC
+#define CARAVAN_STATIC 0
+#endif
+#ifndef CARAVAN_MAX_SUBSCRIBERS
+#define CARAVAN_MAX_SUBSCRIBERS 16      // Subscriptions pro MetricBus
+#endif
+#ifndef CARAVAN_MAX_PROPS
+#define CARAVAN_MAX_PROPS 7             // Properties pro Metric (= Anzahl PropertyKeys)
+#endif
+#ifndef CARAVAN_MAX_DEVICES
+#define CARAVAN_MAX_DEVICES 16          // Geräte pro DeviceRegistry, Registerblöcke pro Cache
+#endif
+#ifndef CARAVAN_MAX_REGS
+#define CARAVAN_MAX_REGS 64             // Register pro Modbus-Read
+#endif
+#ifndef CARAVAN_CALLBACK_BYTES
+#define CARAVAN_CALLBACK_BYTES 32       // Captures eines Bus-Callbacks
+#endif
+#ifndef CARAVAN_MAX_SHARDS
+#define CARAVAN_MAX_SHARDS 4            // Shards pro MetricBus
+#endif
+#ifndef CARAVAN_MAX_DEFERRED
+#define CARAVAN_MAX_DEFERRED 8          // Reentrancy::Deferred: Queue pro publish() (Stack)
+#endif
+#ifndef CARAVAN_MAX_SEQ_INSTANCES
+#define CARAVAN_MAX_SEQ_INSTANCES 16    // Instanzen pro SeqTracker (MetricBus: einer für alle Shards)
+#endif
+#ifndef CARAVAN_MAX_NESTED_BUSES
+#define CARAVAN_MAX_NESTED_BUSES 4      // gleichzeitig zustellende Busse pro Thread
+#endif
+
+namespace core::caps {
+
+inline constexpr bool        kStatic          = CARAVAN_STATIC != 0;
+inline constexpr std::size_t kMaxSubscribers  = CARAVAN_MAX_SUBSCRIBERS;
+inline constexpr std::size_t kMaxProps        = CARAVAN_MAX_PROPS;
+inline constexpr std::size_t kMaxDevices      = CARAVAN_MAX_DEVICES;
+inline constexpr std::size_t kMaxRegs         = CARAVAN_MAX_REGS;
+inline constexpr std::size_t kCallbackBytes   = CARAVAN_CALLBACK_BYTES;
+inline constexpr std::size_t kMaxShards       = CARAVAN_MAX_SHARDS;
+inline constexpr std::size_t kMaxDeferred     = CARAVAN_MAX_DEFERRED;
+inline constexpr std::size_t kMaxNestedBuses  = CARAVAN_MAX_NESTED_BUSES;
+inline constexpr std::size_t kMaxSeqInstances = CARAVAN_MAX_SEQ_INSTANCES;
+
+static_assert(kMaxSubscribers > 0 && kMaxProps > 0 && kMaxRegs > 0 && kMaxShards > 0 &&
+              kMaxSeqInstances > 0,
+              "static capacities must be > 0");
+
+} // namespace core::caps
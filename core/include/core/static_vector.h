@@ -0,0 +1,129 @@
+#pragma once
+// Vektor mit fester Kapazität N im Objekt selbst (keine Allokation).
+// Schnittstelle wie std::vector, soweit im Projekt gebraucht; was die
+// Kapazität überschreiten würde, liefert false und ändert nichts
+// (resize/assign: auf N begrenzt). max_size() == N, damit generischer Code
+// (std::vector oder StaticVector) die Grenze vorab prüfen kann.
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace core {
+
+template<typename T, std::size_t N>
+class StaticVector {
+public:
+  using value_type      = T;
+  using size_type       = std::size_t;
+  using reference       = T&;
+  using const_reference = const T&;
+  using iterator        = T*;
+  using const_iterator  = const T*;
+
+  StaticVector() noexcept = default;
+  // überzählige Elemente werden verworfen
+  StaticVector(std::initializer_list<T> il) { assign(il.begin(), il.end()); }
+  StaticVector(size_type n, const T& v) { resize(n, v); }
+
+  StaticVector(const StaticVector& o) { for (const T& v : o) emplace_back(v); }
+  StaticVector(StaticVector&& o) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    for (T& v : o) emplace_back(std::move(v));
+    o.clear();
+  }
+  StaticVector& operator=(const StaticVector& o) {
+    if (this != &o) { clear(); for (const T& v : o) emplace_back(v); }
+    return *this;
+  }
+  StaticVector& operator=(StaticVector&& o) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    if (this != &o) {
+      clear();
+      for (T& v : o) emplace_back(std::move(v));
+      o.clear();
+    }
+    return *this;
+  }
+  ~StaticVector() { clear(); }
+
+  static constexpr size_type capacity() noexcept { return N; }
+  static constexpr size_type max_size() noexcept { return N; }
+  size_type size()  const noexcept { return size_; }
+  bool      empty() const noexcept { return size_ == 0; }
+  bool      full()  const noexcept { return size_ == N; }
+
+  T*       data()       noexcept { return std::launder(reinterpret_cast<T*>(buf_)); }
+  const T* data() const noexcept { return std::launder(reinterpret_cast<const T*>(buf_)); }
+
+  iterator       begin()       noexcept { return data(); }
+  iterator       end()         noexcept { return data() + size_; }
+  const_iterator begin() const noexcept { return data(); }
+  const_iterator end()   const noexcept { return data() + size_; }
+
+  T&       operator[](size_type i)       noexcept { return data()[i]; }
+  const T& operator[](size_type i) const noexcept { return data()[i]; }
+  T&       front()       noexcept { return data()[0]; }
+  const T& front() const noexcept { return data()[0]; }
+  T&       back()        noexcept { return data()[size_ - 1]; }
+  const T& back()  const noexcept { return data()[size_ - 1]; }
+
+  template<typename... Args>
+  bool emplace_back(Args&&... args) {
+    if (size_ == N) return false;
+    ::new (static_cast<void*>(data() + size_)) T(std::forward<Args>(args)...);
+    ++size_;
+    return true;
+  }
+  bool push_back(const T& v) { return emplace_back(v); }
+  bool push_back(T&& v)      { return emplace_back(std::move(v)); }
+  void pop_back() noexcept   { data()[--size_].~T(); }
+
+  void clear() noexcept {
+    while (size_) pop_back();
+  }
+
+  // false, wenn n > N (dann auf N begrenzt)
+  bool resize(size_type n) { return resize(n, T{}); }
+  bool resize(size_type n, const T& v) {
+    const size_type target = std::min(n, N);
+    while (size_ > target) pop_back();
+    while (size_ < target) emplace_back(v);
+    return n <= N;
+  }
+
+  bool assign(size_type n, const T& v) {
+    clear();
+    return resize(n, v);
+  }
+  template<typename It, typename = std::enable_if_t<!std::is_integral_v<It>>>
+  bool assign(It first, It last) {
+    clear();
+    for (; first != last; ++first) {
+      if (!emplace_back(*first)) return false;
+    }
+    return true;
+  }
+
+  // [first, last) entfernen, Reihenfolge bleibt erhalten
+  iterator erase(const_iterator first, const_iterator last) {
+    T* const dst = begin() + (first - begin());
+    T* const src = begin() + (last - begin());
+    T* const out = std::move(src, end(), dst);
+    while (end() != out) pop_back();
+    return dst;
+  }
+  iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+  friend bool operator==(const StaticVector& a, const StaticVector& b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+  }
+  friend bool operator!=(const StaticVector& a, const StaticVector& b) { return !(a == b); }
+
+private:
+  alignas(T) unsigned char buf_[sizeof(T) * N];
+  size_type size_{0};
+};
+
+} // namespace core
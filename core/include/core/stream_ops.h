@@ -0,0 +1,235 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "core/metric_bus.h"
+#include "core/metric.h"
+#include "core/enums.h"
+#include "core/ids.h"
+
+namespace core::stream {
+
+// Operatoren für abgeleitete Metriken.
+// Alle Operatoren haben dieselbe Signatur: float push(float x, uint64_t ts_ms)
+// -> liefert den neuen abgeleiteten Wert. Zustand wird im Konstruktor
+// vorallokiert, push() allokiert nie.
+
+// Gleitender Mittelwert über die letzten N Samples, O(1) pro Sample
+class MovingAverage {
+public:
+  explicit MovingAverage(std::size_t window);
+
+  float push(float x, uint64_t ts_ms = 0) noexcept;
+  void  reset() noexcept;
+  std::size_t window() const noexcept { return buf_.size(); }
+
+private:
+  std::vector<float> buf_;
+  std::size_t head_{0};
+  std::size_t count_{0};
+  double      sum_{0.0};
+};
+
+// Exponentiell gewichteter Mittelwert; erstes Sample initialisiert
+class Ewma {
+public:
+  explicit Ewma(float alpha) : alpha_(alpha) {}
+
+  float push(float x, uint64_t ts_ms = 0) noexcept;
+  void  reset() noexcept { init_ = false; }
+
+private:
+  float alpha_;
+  float state_{0.0f};
+  bool  init_{false};
+};
+
+// Minimum/Maximum über die letzten N Samples (monotone Queue im Ring),
+// amortisiert O(1) pro Sample
+template <typename Compare>
+class WindowExtremum {
+public:
+  explicit WindowExtremum(std::size_t window)
+  : window_(window ? window : 1), ring_(window_) {}
+
+  float push(float x, uint64_t /*ts_ms*/ = 0) noexcept {
+    // Eintrag vorne fällt mit dem neuen Sample aus dem Fenster
+    if (count_ && n_ - ring_[front_].n >= window_) { front_ = (front_ + 1) % window_; --count_; }
+    // Kandidaten verwerfen, die x nie mehr schlagen können
+    while (count_ && !cmp_(ring_[back_()].value, x)) --count_;
+    ring_[(front_ + count_) % window_] = Entry{n_, x};
+    ++count_;
+    ++n_;
+    return ring_[front_].value;
+  }
+  void reset() noexcept { front_ = 0; count_ = 0; n_ = 0; }
+
+private:
+  struct Entry { uint64_t n; float value; };
+  std::size_t back_() const noexcept { return (front_ + count_ - 1) % window_; }
+
+  std::size_t        window_;
+  std::vector<Entry> ring_;
+  std::size_t        front_{0};
+  std::size_t        count_{0};
+  uint64_t           n_{0};
+  Compare            cmp_{};
+};
+
+using WindowMin = WindowExtremum<std::less<float>>;
+using WindowMax = WindowExtremum<std::greater<float>>;
+
+// Änderungsrate in Einheiten pro Sekunde (benötigt ts_ms)
+class RateOfChange {
+public:
+  float push(float x, uint64_t ts_ms) noexcept;
+  void  reset() noexcept { init_ = false; rate_ = 0.0f; }
+
+private:
+  float    last_{0.0f};
+  uint64_t last_ts_{0};
+  float    rate_{0.0f};
+  bool     init_{false};
+};
+
+// Median über die letzten N Samples. Gedacht für kleine N (3..15):
+// sortiertes Fenster, Einfügen per memmove -> O(N) mit sehr kleiner Konstante
+class MedianFilter {
+public:
+  explicit MedianFilter(std::size_t window);
+
+  float push(float x, uint64_t ts_ms = 0) noexcept;
+  void  reset() noexcept { head_ = 0; count_ = 0; }
+
+private:
+  std::vector<float> ring_;
+  std::vector<float> sorted_;
+  std::size_t head_{0};
+  std::size_t count_{0};
+};
+
+// Verkettung mehrerer Operatoren, z.B. Chain<MedianFilter, Ewma>
+template <typename... Ops>
+class Chain {
+public:
+  explicit Chain(Ops... ops) : ops_(std::move(ops)...) {}
+
+  float push(float x, uint64_t ts_ms = 0) noexcept {
+    std::apply([&](auto&... op) { ((x = op.push(x, ts_ms)), ...); }, ops_);
+    return x;
+  }
+  void reset() noexcept {
+    std::apply([](auto&... op) { (op.reset(), ...); }, ops_);
+  }
+
+private:
+  std::tuple<Ops...> ops_;
+};
+
+// ---- Bus-Anbindung ----
+
+struct MetricKey {
+  Metric::InstanceId instance;
+  MetricID           metric;
+};
+
+// Abonniert (instance, metric) am Bus, schiebt jeden Wert durch Op und
+// publiziert das Ergebnis als eigene Metric unter `out`.
+// `out.instance` sollte eine eigene Instanz sein (eigener seq-Zähler).
+// Unit/Quality werden von der Eingangs-Metric übernommen.
+template <typename Op>
+class DerivedMetric {
+public:
+  DerivedMetric(MetricBus& bus, MetricKey in, MetricKey out, Op op)
+  : bus_(bus), in_(in), out_(out), op_(std::move(op)) {
+    sub_ = bus_.subscribe([this](const Metric& m) { on_metric_(m); });
+  }
+
+  DerivedMetric(const DerivedMetric&)            = delete;
+  DerivedMetric& operator=(const DerivedMetric&) = delete;
+
+private:
+  void on_metric_(const Metric& m) {
+    if (m.instance_id() != in_.instance || m.metric_id() != in_.metric) return;
+
+    float x;
+    if (auto f = m.get_if<float>())        x = *f;
+    else if (auto i = m.get_if<int32_t>()) x = static_cast<float>(*i);
+    else return;
+
+    Metric::PropMap p;
+    if (auto u = m.try_get_prop<uint8_t>(PropertyKey::Unit))    p.emplace(PropertyKey::Unit, *u);
+    if (auto q = m.try_get_prop<uint8_t>(PropertyKey::Quality)) p.emplace(PropertyKey::Quality, *q);
+
+    float    y;
+    uint32_t seq;
+    {
+      std::lock_guard<std::mutex> lk(mtx_);
+      y   = op_.push(x, m.timestamp_ms());
+      seq = ++seq_;
+    }
+    // außerhalb des Locks publizieren (re-entrant)
+    bus_.publish(Metric::Make(out_.instance, out_.metric, y, m.timestamp_ms(), seq, std::move(p)));
+  }
+
+  MetricBus&   bus_;
+  MetricKey    in_;
+  MetricKey    out_;
+  Op           op_;
+  std::mutex   mtx_;
+  uint32_t     seq_{0};
+  Subscription sub_;
+};
+
+// ---- Batch-Pfad: viele Kanäle pro Schritt (Struct-of-Arrays) ----
+// Die Schleifen sind bewusst einfache Index-Schleifen über zusammenhängende
+// float-Arrays, damit der Compiler sie vektorisiert.
+
+// EWMA für `channels` Kanäle, ein Update-Vektor pro Schritt
+class EwmaBank {
+public:
+  EwmaBank(std::size_t channels, float alpha);
+
+  // x: `channels()` Werte, gleiche Kanal-Reihenfolge wie values()
+  void update(const float* x) noexcept;
+  void reset() noexcept { init_ = false; }
+
+  std::size_t  channels() const noexcept { return state_.size(); }
+  const float* values()   const noexcept { return state_.data(); }
+
+private:
+  std::vector<float> state_;
+  float              alpha_;
+  bool               init_{false};
+};
+
+// Gleitender Mittelwert für `channels` Kanäle über je `window` Samples.
+// Laufende Summen in float; bei jedem Ringumlauf werden sie exakt neu
+// berechnet, damit sich kein Rundungsfehler aufsummiert.
+class MovingAverageBank {
+public:
+  MovingAverageBank(std::size_t channels, std::size_t window);
+
+  void update(const float* x) noexcept;
+  void reset() noexcept;
+
+  std::size_t  channels() const noexcept { return sums_.size(); }
+  std::size_t  window()   const noexcept { return window_; }
+  // Mittelwerte in out[0..channels)
+  void means(float* out) const noexcept;
+
+private:
+  std::size_t        window_;
+  std::vector<float> ring_;   // window_ Zeilen à channels Werte
+  std::vector<float> sums_;
+  std::size_t        head_{0};
+  std::size_t        count_{0};
+};
+
+} // namespace core::stream
@@ -0,0 +1,88 @@
+#pragma once
+// Span-/Counter-Tracing für Laufzeitanalyse (Device-Ticks, Modbus, publish,
+// einzelne Callbacks). Jeder Thread schreibt lock-frei in seinen eigenen
+// Ringpuffer (Flight-Recorder: die letzten N Events bleiben erhalten); bei
+// Bedarf als Chrome-Trace-JSON exportieren (chrome://tracing, ui.perfetto.dev).
+//
+// Instrumentierung nur über die Makros: ohne CARAVAN_TRACE (ESP32, oder
+// -DCARAVAN_TRACE=OFF) werden sie zu nichts. Mit CARAVAN_TRACE, aber nicht
+// gestartet, kostet ein Span ein Laden eines atomaren Flags.
+//
+//   CARAVAN_TRACE_SCOPE("wt901c.tick");
+//   CARAVAN_TRACE_SCOPE_ARG("modbus.read_holding", addr);
+//   CARAVAN_TRACE_COUNTER("bus.queue", n);
+//
+// Namen müssen statische Strings sein (es wird nur der Zeiger gespeichert).
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace core::trace {
+
+namespace detail {
+extern std::atomic<bool> g_enabled;
+} // namespace detail
+
+inline bool enabled() noexcept { return detail::g_enabled.load(std::memory_order_relaxed); }
+
+// Aufzeichnung starten; Ringe neuer Threads bekommen events_per_thread
+// Plätze (auf Zweierpotenz gerundet, einer bleibt als Puffer für den Export
+// frei). Vorhandene Events werden verworfen.
+void start(std::size_t events_per_thread = 8192);
+void stop();
+bool is_running();
+
+// Zeitbasis in ns; Default steady_clock. Auf Targets z.B. esp_timer/TSC.
+using TimeSource = uint64_t (*)();
+void     set_time_source(TimeSource fn);
+uint64_t now_ns();
+
+// Name des aufrufenden Threads in der Trace-Ansicht; belegt keinen Ring
+// (Ringe entstehen erst beim ersten Event während der Aufzeichnung)
+void set_thread_name(const std::string& name);
+
+// Low-Level (von den Makros benutzt)
+void complete(const char* name, uint64_t start_ns, uint64_t dur_ns, int64_t arg);
+void counter(const char* name, int64_t value);
+
+// Events aller Threads (auch beendeter), während die Aufzeichnung läuft möglich
+std::size_t event_count();
+void write_chrome_json(std::ostream& os);
+bool dump_chrome_json(const std::string& path, std::string* err = nullptr);
+
+// RAII-Span; misst nur, wenn beim Betreten aufgezeichnet wurde
+class Span {
+public:
+  explicit Span(const char* name, int64_t arg = 0) noexcept
+  : name_(name), arg_(arg), on_(enabled()), start_(on_ ? now_ns() : 0) {}
+  ~Span() {
+    if (on_) complete(name_, start_, now_ns() - start_, arg_);
+  }
+  Span(const Span&) = delete;
+  Span& operator=(const Span&) = delete;
+
+private:
+  const char* name_;
+  int64_t     arg_;
+  bool        on_;
+  uint64_t    start_;
+};
+
+} // namespace core::trace
+
+#if CARAVAN_TRACE
+#define CARAVAN_TRACE_CAT_(a, b) a##b
+#define CARAVAN_TRACE_CAT(a, b)  CARAVAN_TRACE_CAT_(a, b)
+#define CARAVAN_TRACE_SCOPE(name) \
+  ::core::trace::Span CARAVAN_TRACE_CAT(caravan_trace_span_, __LINE__){name}
+#define CARAVAN_TRACE_SCOPE_ARG(name, arg) \
+  ::core::trace::Span CARAVAN_TRACE_CAT(caravan_trace_span_, __LINE__){name, static_cast<int64_t>(arg)}
+#define CARAVAN_TRACE_COUNTER(name, value) \
+  do { if (::core::trace::enabled()) ::core::trace::counter(name, static_cast<int64_t>(value)); } while (0)
+#else
+#define CARAVAN_TRACE_SCOPE(name)          do {} while (0)
+#define CARAVAN_TRACE_SCOPE_ARG(name, arg) do { (void)sizeof(arg); } while (0)
+#define CARAVAN_TRACE_COUNTER(name, value) do { (void)sizeof(value); } while (0)
+#endif
@@ -27,8 +27,8 @@ Metric Metric::Make(InstanceId id, MetricID metric_id, Value v,
   return m;
 }
 
-void Metric::set_prop(PropertyKey k, PropValue v) {
-  props_.emplace(k, std::move(v));
+bool Metric::set_prop(PropertyKey k, PropValue v) {
+  return props_.emplace(k, std::move(v)).first != props_.end();
 }
 
 bool operator==(const Metric& a, const Metric& b) {
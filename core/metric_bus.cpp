@@ -1,46 +1,309 @@
 #include "core/metric_bus.h"
+#include "core/trace.h"
+
+#include <algorithm>
+#include <deque>
+#include <thread>
+#include <utility>
 
 namespace core {
 
+namespace {
+#if CARAVAN_STATIC
+using DeferredQueue = StaticVector<std::pair<Metric, uint32_t>, caps::kMaxDeferred>;
+#else
+using DeferredQueue = std::vector<std::pair<Metric, uint32_t>>;
+#endif
+
+// Laufende Zustellungen dieses Threads, eine pro Bus (äußerster publish()).
+// Index statt Zeiger: Callbacks können auf anderen Bussen publizieren.
+struct DispatchFrame {
+  const MetricBus* bus;
+  uint32_t         depth;   // Tiefe der gerade zugestellten Metric
+  DeferredQueue*   queue;   // nur Deferred: (Metric, Tiefe)
+  std::size_t      head;
+};
+#if CARAVAN_STATIC
+thread_local StaticVector<DispatchFrame, caps::kMaxNestedBuses> tl_frames;
+#else
+thread_local std::vector<DispatchFrame> tl_frames;
+#endif
+
+// Aufräumen beim Verlassen des Scopes, auch wenn ein Callback wirft: sonst
+// bliebe ein Frame (mit Zeiger auf die Deferred-Queue vom Stack) oder eine
+// erhöhte Ebene für den nächsten publish() dieses Threads stehen.
+template <class F>
+struct OnExit {
+  F fn;
+  ~OnExit() { fn(); }
+};
+template <class F>
+OnExit<F> on_exit(F fn) { return OnExit<F>{std::move(fn)}; }
+
+std::size_t shard_count_for(std::size_t requested) {
+  const std::size_t n = requested ? requested : std::max(1u, std::thread::hardware_concurrency());
+  return caps::kStatic ? std::min(n, caps::kMaxShards) : n;
+}
+
+inline uint64_t make_handle(uint32_t gen, uint32_t idx) {
+  return (static_cast<uint64_t>(gen) << 32) | (static_cast<uint64_t>(idx) + 1);
+}
+} // namespace
+
+MetricBus::MetricBus(Options opt)
+: n_shards_(shard_count_for(opt.shards))
+, shard_by_(opt.shard_by)
+, reentrancy_(opt.reentrancy)
+, max_depth_(opt.max_depth)
+, max_queue_(caps::kStatic ? std::min(opt.max_queue, caps::kMaxDeferred) : opt.max_queue)
+#if !CARAVAN_STATIC
+, shards_(new Shard[n_shards_])
+#endif
+, track_seq_(opt.track_seq)
+{
+  if (!track_seq_) return;
+  SeqTracker::Config sc;
+  sc.max_instances = opt.seq_instances;
+#if !CARAVAN_STATIC
+  seq_.reset(new SeqStripe[n_shards_]);
+#endif
+  for (std::size_t i = 0; i < seq_stripes_(); ++i) seq_[i].tracker = SeqTracker(sc);
+}
+
 Subscription MetricBus::subscribe(Callback cb) {
-  auto s   = std::make_shared<Subscriber>();
-  s->id    = next_id_.fetch_add(1, std::memory_order_relaxed);
-  s->cb    = std::move(cb);
-  s->active= true;
+  return subscribe_(std::move(cb), false, MetricID::Health);
+}
 
+Subscription MetricBus::subscribe(MetricID id, Callback cb) {
+  return subscribe_(std::move(cb), true, id);
+}
+
+Subscription MetricBus::subscribe_(Callback cb, bool filtered, MetricID filter) {
+  uint32_t idx = 0, gen = 0;
   {
-    std::lock_guard<std::mutex> lk(mtx_);
-    subs_.push_back(std::move(s));
+    std::lock_guard<std::mutex> lk(pool_mtx_);
+    if (free_head_) {
+      idx        = free_head_ - 1;
+      free_head_ = slots_[idx].next_free;
+    } else {
+#if CARAVAN_STATIC
+      if (slots_.full()) {
+        capacity_overflows_.fetch_add(1, std::memory_order_relaxed);
+        return Subscription();
+      }
+#endif
+      idx = static_cast<uint32_t>(slots_.size());
+      slots_.emplace_back();
+    }
+    slots_[idx].live = true;
+    gen = slots_[idx].gen;
+    ++live_;
+  }
+
+  const Entry e{std::move(cb), idx, filtered, filter};
+  if (filtered && shard_by_ == ShardKey::Metric) {
+    link_(shards_[shard_of_(static_cast<uint32_t>(filter))], idx, e);
+  } else {
+    // ungefiltert (oder Instanz-Sharding): in jedem Shard eintragen
+    for (std::size_t i = 0; i < n_shards_; ++i) link_(shards_[i], idx, e);
   }
-  return Subscription(this, subs_.back()->id);
+  return Subscription(this, make_handle(gen, idx));
 }
 
-bool MetricBus::unsubscribe(uint64_t id) {
-  std::lock_guard<std::mutex> lk(mtx_);
-  bool found = false;
-  for (auto& sp : subs_) {
-    if (sp && sp->id == id && sp->active) { sp->active = true ? false : false; found = true; break; }
+void MetricBus::link_(Shard& sh, uint32_t idx, const Entry& e) {
+  std::lock_guard<std::mutex> lk(sh.mtx);
+#if CARAVAN_STATIC
+  // Grabsteine belegen Plätze; aktive Einträge passen immer (<= Slots)
+  if (sh.dense.full()) compact_(sh);
+#else
+  if (sh.where.size() <= idx) sh.where.resize(idx + 1, 0);
+#endif
+  sh.dense.push_back(e);
+  sh.where[idx] = static_cast<uint32_t>(sh.dense.size());
+}
+
+void MetricBus::unlink_(Shard& sh, uint32_t idx) {
+  Callback dead;   // Destruktor (Captures) erst nach dem Unlock
+  std::lock_guard<std::mutex> lk(sh.mtx);
+  if (idx >= sh.where.size() || !sh.where[idx]) return;
+  dead = std::move(sh.dense[sh.where[idx] - 1].cb);
+  sh.dense[sh.where[idx] - 1].cb = nullptr;
+  sh.where[idx] = 0;
+
+  // Grabsteine erst kompaktieren, wenn sie die Hälfte ausmachen (amortisiert
+  // O(1)); die Registrierungsreihenfolge bleibt erhalten
+  if (++sh.dead * 2 < sh.dense.size()) return;
+  compact_(sh);
+}
+
+void MetricBus::compact_(Shard& sh) {
+  std::size_t out = 0;
+  for (std::size_t i = 0; i < sh.dense.size(); ++i) {
+    if (!sh.dense[i].cb) continue;
+    if (out != i) sh.dense[out] = std::move(sh.dense[i]);
+    sh.where[sh.dense[out].slot] = static_cast<uint32_t>(out + 1);
+    ++out;
   }
-  // opportunistic cleanup, damit die Liste nicht wächst
-  if (found && subs_.size() > 64) {
-    std::vector<std::shared_ptr<Subscriber>> tmp;
-    tmp.reserve(subs_.size());
-    for (auto& sp : subs_) if (sp && sp->active) tmp.push_back(std::move(sp));
-    subs_.swap(tmp);
+  sh.dense.resize(out);
+  sh.dead = 0;
+}
+
+bool MetricBus::unsubscribe(uint64_t id) {
+  const uint32_t gen = static_cast<uint32_t>(id >> 32);
+  const uint32_t low = static_cast<uint32_t>(id);
+  if (!low) return false;
+  const uint32_t idx = low - 1;
+
+  {
+    std::lock_guard<std::mutex> lk(pool_mtx_);
+    if (idx >= slots_.size()) return false;
+    Slot& s = slots_[idx];
+    if (!s.live || s.gen != gen) return false;   // veraltetes Handle
+    s.live = false;                              // ab hier gehört der Slot uns
   }
-  return found;
+
+  // erst aus allen Shards austragen, dann darf der Slot neu vergeben werden
+  for (std::size_t i = 0; i < n_shards_; ++i) unlink_(shards_[i], idx);
+
+  std::lock_guard<std::mutex> lk(pool_mtx_);
+  Slot& s = slots_[idx];
+  s.gen = (s.gen + 1) ? s.gen + 1 : 1;   // Generation 0 überspringen
+  s.next_free = free_head_;
+  free_head_  = idx + 1;
+  --live_;
+  return true;
+}
+
+std::size_t MetricBus::subscriber_count() const {
+  std::lock_guard<std::mutex> lk(pool_mtx_);
+  return live_;
 }
 
 void MetricBus::publish(const Metric& m) {
-  std::vector<Callback> cbs;
+  if (track_seq_) {
+    SeqStripe& st = seq_[seq_stripe_(m.instance_id())];
+    std::lock_guard<std::mutex> lk(st.mtx);
+    if (!SeqTracker::accept(st.tracker.observe(m))) return;
+  }
+
+  std::size_t f = tl_frames.size();
+  while (f && tl_frames[f - 1].bus != this) --f;
+
+  if (f) {
+    // re-entrant aus einem Callback dieses Busses
+    const uint32_t depth = tl_frames[f - 1].depth + 1;
+    if (depth > max_depth_) { overflows_.fetch_add(1, std::memory_order_relaxed); return; }
+    if (reentrancy_ == Reentrancy::Deferred) {
+      DispatchFrame& fr = tl_frames[f - 1];
+      DeferredQueue& q  = *fr.queue;
+#if CARAVAN_STATIC
+      // abgearbeitete Einträge freigeben, bevor die Queue als voll gilt
+      if (q.full() && fr.head) {
+        q.erase(q.begin(), q.begin() + fr.head);
+        fr.head = 0;
+      }
+#endif
+      if (q.size() - fr.head >= max_queue_) {
+        overflows_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      q.emplace_back(m, depth);
+      return;
+    }
+    tl_frames[f - 1].depth = depth;
+    const auto restore = on_exit([f, depth] { tl_frames[f - 1].depth = depth - 1; });
+    dispatch_(m);
+    return;
+  }
+
+#if CARAVAN_STATIC
+  if (tl_frames.full()) { capacity_overflows_.fetch_add(1, std::memory_order_relaxed); return; }
+#endif
+  // äußerster publish(): Frame anlegen
+  if (reentrancy_ != Reentrancy::Deferred) {
+    tl_frames.push_back(DispatchFrame{this, 0, nullptr, 0});
+    const auto pop = on_exit([] { tl_frames.pop_back(); });
+    dispatch_(m);
+    return;
+  }
+  publish_deferred_(m);
+}
+
+void MetricBus::publish_deferred_(const Metric& m) {
+  // Die Queue ist vom Frame aus erreichbar; der äußerste publish() arbeitet
+  // sie FIFO ab. Statisches Profil: CARAVAN_MAX_DEFERRED Einträge auf dem Stack.
+  DeferredQueue queue;
+  tl_frames.push_back(DispatchFrame{this, 0, &queue, 0});
+  const auto pop = on_exit([] { tl_frames.pop_back(); });
+  const std::size_t self = tl_frames.size() - 1;
+  dispatch_(m);
+  while (tl_frames[self].head < queue.size()) {
+    std::pair<Metric, uint32_t> next = std::move(queue[tl_frames[self].head++]);
+    tl_frames[self].depth = next.second;
+    dispatch_(next.first);
+  }
+}
+
+void MetricBus::dispatch_(const Metric& m) {
+  CARAVAN_TRACE_SCOPE_ARG("bus.publish", static_cast<uint16_t>(m.metric_id()));
+  // Callbacks unter dem Shard-Lock kopieren, danach ohne Lock aufrufen.
+  // Ein Puffer pro Verschachtelungsebene (re-entrante Publishes); die
+  // Kapazität bleibt erhalten, im eingeschwungenen Zustand keine Allokation.
+#if CARAVAN_STATIC
+  // statisches Profil: auf dem Stack, aktive Einträge <= CARAVAN_MAX_SUBSCRIBERS
+  StaticVector<Callback, caps::kMaxSubscribers> cbs;
+#else
+  thread_local std::deque<std::vector<Callback>> scratch;
+  thread_local std::size_t level = 0;
+  if (scratch.size() <= level) scratch.emplace_back();
+  std::vector<Callback>& cbs = scratch[level];
+  const auto release = on_exit([&cbs] { cbs.clear(); });
+#endif
+
+  Shard& sh = shards_[shard_of(m)];
   {
-    std::lock_guard<std::mutex> lk(mtx_);
-    cbs.reserve(subs_.size());
-    for (auto const& sp : subs_) if (sp && sp->active) cbs.push_back(sp->cb);
+    std::lock_guard<std::mutex> lk(sh.mtx);
+    for (const Entry& e : sh.dense) {
+      if (!e.cb) continue;
+      if (e.filtered && e.filter != m.metric_id()) continue;
+      cbs.push_back(e.cb);
+    }
   }
+
+#if !CARAVAN_STATIC
+  ++level;
+  const auto leave = on_exit([] { --level; });
+#endif
+#if CARAVAN_TRACE
+  // Flag einmal pro publish prüfen, nicht pro Callback
+  if (trace::enabled()) {
+    for (std::size_t i = 0; i < cbs.size(); ++i) {
+      CARAVAN_TRACE_SCOPE_ARG("bus.callback", i);
+      cbs[i](m);
+    }
+  } else
+#endif
   for (auto& cb : cbs) cb(m);
 }
 
+SeqTracker::Stats MetricBus::seq_stats() const {
+  SeqTracker::Stats sum;
+  if (!track_seq_) return sum;
+  for (std::size_t i = 0; i < seq_stripes_(); ++i) {
+    std::lock_guard<std::mutex> lk(seq_[i].mtx);
+    const SeqTracker::Stats& s = seq_[i].tracker.stats();
+    sum.instances  += s.instances;
+    sum.received   += s.received;
+    sum.gaps       += s.gaps;
+    sum.lost       += s.lost;
+    sum.late       += s.late;
+    sum.duplicates += s.duplicates;
+    sum.resets     += s.resets;
+    sum.untracked  += s.untracked;
+  }
+  return sum;
+}
+
 void Subscription::unsubscribe() {
   if (bus_ && id_) {
     bus_->unsubscribe(id_);
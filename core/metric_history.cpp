@@ -0,0 +1,365 @@
+#include "core/metric_history.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace core {
+
+namespace {
+
+constexpr uint8_t kVersion = 1;
+// schlechtester Fall eines Folgepunkts: 4+64 (ts) + 2+5+5+32 (Wert) + 3 (Quality) Bit
+constexpr std::size_t kMaxPointBytes = 15;
+
+int value_index(DataType t) noexcept {
+  switch (t) {
+    case DataType::Float: return 0;
+    case DataType::Int32: return 1;
+    case DataType::Bool:  return 2;
+  }
+  return -1;
+}
+
+uint32_t to_bits(const Metric::Value& v) noexcept {
+  uint32_t bits = 0;
+  if (auto f = std::get_if<float>(&v))        std::memcpy(&bits, f, sizeof(bits));
+  else if (auto i = std::get_if<int32_t>(&v)) std::memcpy(&bits, i, sizeof(bits));
+  else if (auto b = std::get_if<bool>(&v))    bits = *b ? 1u : 0u;
+  return bits;
+}
+
+Metric::Value from_bits(DataType t, uint32_t bits) noexcept {
+  switch (t) {
+    case DataType::Float: { float f;   std::memcpy(&f, &bits, sizeof(f)); return f; }
+    case DataType::Int32: { int32_t i; std::memcpy(&i, &bits, sizeof(i)); return i; }
+    case DataType::Bool:  return bits != 0;
+  }
+  return 0.0f;
+}
+
+void put_u32_le(uint8_t* p, uint32_t v) noexcept {
+  for (int i = 0; i < 4; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+Metric::Value value_of(const Metric& m) noexcept {
+  if (auto f = m.get_if<float>())   return *f;
+  if (auto i = m.get_if<int32_t>()) return *i;
+  if (auto b = m.get_if<bool>())    return *b;
+  return 0.0f;
+}
+
+uint32_t get_u32_le(const uint8_t* p) noexcept {
+  uint32_t v = 0;
+  for (int i = 0; i < 4; ++i) v |= uint32_t{p[i]} << (8 * i);
+  return v;
+}
+
+} // namespace
+
+// --- Encoder -----------------------------------------------------------------
+
+HistoryEncoder::HistoryEncoder(DataType type, std::size_t max_bytes)
+: type_(type), max_bytes_(std::max(max_bytes, kHeaderBytes + kMaxPointBytes))
+{
+  bytes_.reserve(std::min<std::size_t>(max_bytes_, 256));
+  bytes_.resize(kHeaderBytes, 0);
+  bytes_[0] = kVersion;
+  bytes_[1] = static_cast<uint8_t>(type);
+}
+
+void HistoryEncoder::put_(uint64_t bits, unsigned n) {
+  while (n) {
+    if (!free_bits_) {
+      bytes_.push_back(0);
+      free_bits_ = 8;
+    }
+    const unsigned take  = std::min(n, free_bits_);
+    const unsigned chunk = static_cast<unsigned>(bits >> (n - take)) & ((1u << take) - 1);
+    bytes_.back() |= static_cast<uint8_t>(chunk << (free_bits_ - take));
+    free_bits_ -= take;
+    n          -= take;
+  }
+}
+
+bool HistoryEncoder::append(uint64_t ts_ms, const Metric::Value& v, Quality q) {
+  if (static_cast<int>(v.index()) != value_index(type_)) return false;
+  if (count_ && ts_ms < prev_ts_) return false;
+  if (bytes_.size() + kMaxPointBytes > max_bytes_) return false;
+
+  const uint32_t bits = to_bits(v);
+  const uint8_t  qb   = static_cast<uint8_t>(q) & 0x3;
+
+  if (count_ == 0) {
+    put_(ts_ms, 64);
+    put_(bits, 32);
+    put_(qb, 2);
+    first_ts_ = ts_ms;
+  } else {
+    // Zeitstempel: Delta-of-Delta in Größenklassen
+    const int64_t delta = static_cast<int64_t>(ts_ms - prev_ts_);
+    const int64_t dod   = delta - prev_delta_;
+    if (dod == 0)                       put_(0b0, 1);
+    else if (dod >= -63 && dod <= 64)     { put_(0b10, 2);   put_(static_cast<uint64_t>(dod + 63), 7); }
+    else if (dod >= -255 && dod <= 256)   { put_(0b110, 3);  put_(static_cast<uint64_t>(dod + 255), 9); }
+    else if (dod >= -2047 && dod <= 2048) { put_(0b1110, 4); put_(static_cast<uint64_t>(dod + 2047), 12); }
+    else                                  { put_(0b1111, 4); put_(static_cast<uint64_t>(dod), 64); }
+    prev_delta_ = delta;
+
+    // Wert: XOR zum Vorgänger, nur die signifikanten Bits
+    const uint32_t x = bits ^ prev_bits_;
+    if (x == 0) {
+      put_(0b0, 1);
+    } else {
+      const uint8_t lead  = static_cast<uint8_t>(__builtin_clz(x));
+      const uint8_t trail = static_cast<uint8_t>(__builtin_ctz(x));
+      if (prev_lead_ != 0xFF && lead >= prev_lead_ && trail >= prev_trail_) {
+        put_(0b10, 2);
+        put_(x >> prev_trail_, 32u - prev_lead_ - prev_trail_);
+      } else {
+        const unsigned len = 32u - lead - trail;
+        put_(0b11, 2);
+        put_(lead, 5);
+        put_(len - 1, 5);
+        put_(x >> trail, len);
+        prev_lead_  = lead;
+        prev_trail_ = trail;
+      }
+    }
+
+    if (q == prev_q_) put_(0b0, 1);
+    else              { put_(0b1, 1); put_(qb, 2); }
+  }
+
+  prev_ts_   = ts_ms;
+  prev_bits_ = bits;
+  prev_q_    = q;
+  put_u32_le(&bytes_[2], ++count_);
+  return true;
+}
+
+// --- Decoder -----------------------------------------------------------------
+
+HistoryDecoder::HistoryDecoder(const uint8_t* data, std::size_t size)
+: data_(data), size_(size)
+{
+  if (!data || size < HistoryEncoder::kHeaderBytes || data[0] != kVersion || data[1] < 1 || data[1] > 3) {
+    ok_ = false;
+    return;
+  }
+  type_  = static_cast<DataType>(data[1]);
+  count_ = get_u32_le(data + 2);
+  pos_   = HistoryEncoder::kHeaderBytes * 8;
+}
+
+bool HistoryDecoder::get_(unsigned n, uint64_t& out) {
+  if (pos_ + n > size_ * 8) { ok_ = false; return false; }
+  uint64_t v = 0;
+  while (n) {
+    const unsigned off   = static_cast<unsigned>(pos_ & 7);
+    const unsigned avail = 8 - off;
+    const unsigned take  = std::min(n, avail);
+    const unsigned chunk = (data_[pos_ >> 3] >> (avail - take)) & ((1u << take) - 1);
+    v     = (v << take) | chunk;
+    pos_ += take;
+    n    -= take;
+  }
+  out = v;
+  return true;
+}
+
+bool HistoryDecoder::bit_(bool& out) {
+  uint64_t b = 0;
+  if (!get_(1, b)) return false;
+  out = b != 0;
+  return true;
+}
+
+bool HistoryDecoder::next(HistoryPoint& out) {
+  if (!ok_ || read_ == count_) return false;
+
+  uint64_t v = 0;
+  uint32_t bits = 0;
+  uint8_t  qb   = static_cast<uint8_t>(prev_q_);
+  if (read_ == 0) {
+    if (!get_(64, v)) return false;
+    prev_ts_ = v;
+    if (!get_(32, v)) return false;
+    bits = static_cast<uint32_t>(v);
+    if (!get_(2, v)) return false;
+    qb = static_cast<uint8_t>(v);
+  } else {
+    bool b = false;
+    int64_t dod = 0;
+    if (!bit_(b)) return false;
+    if (b) {
+      if (!bit_(b)) return false;
+      if (!b) { if (!get_(7, v)) return false; dod = static_cast<int64_t>(v) - 63; }
+      else {
+        if (!bit_(b)) return false;
+        if (!b) { if (!get_(9, v)) return false; dod = static_cast<int64_t>(v) - 255; }
+        else {
+          if (!bit_(b)) return false;
+          if (!b) { if (!get_(12, v)) return false; dod = static_cast<int64_t>(v) - 2047; }
+          else    { if (!get_(64, v)) return false; dod = static_cast<int64_t>(v); }
+        }
+      }
+    }
+    prev_delta_ += dod;
+    prev_ts_    += static_cast<uint64_t>(prev_delta_);
+
+    bits = prev_bits_;
+    if (!bit_(b)) return false;
+    if (b) {
+      if (!bit_(b)) return false;
+      if (!b) {
+        if (prev_lead_ == 0xFF) { ok_ = false; return false; }   // noch kein Fenster
+        if (!get_(32u - prev_lead_ - prev_trail_, v)) return false;
+        bits ^= static_cast<uint32_t>(v) << prev_trail_;
+      } else {
+        uint64_t lead = 0, len = 0;
+        if (!get_(5, lead) || !get_(5, len)) return false;
+        ++len;
+        if (lead + len > 32) { ok_ = false; return false; }
+        if (!get_(static_cast<unsigned>(len), v)) return false;
+        prev_lead_  = static_cast<uint8_t>(lead);
+        prev_trail_ = static_cast<uint8_t>(32 - lead - len);
+        bits ^= static_cast<uint32_t>(v) << prev_trail_;
+      }
+    }
+
+    if (!bit_(b)) return false;
+    if (b) {
+      if (!get_(2, v)) return false;
+      qb = static_cast<uint8_t>(v);
+    }
+  }
+
+  prev_bits_ = bits;
+  prev_q_    = static_cast<Quality>(qb);
+  ++read_;
+  out.ts_ms   = prev_ts_;
+  out.value   = from_bits(type_, bits);
+  out.quality = prev_q_;
+  return true;
+}
+
+// --- MetricHistory -------------------------------------------------------------
+
+MetricHistory::MetricHistory(Config cfg)
+: cfg_(cfg)
+{}
+
+MetricHistory::MetricHistory(MetricBus& bus, Config cfg)
+: MetricHistory(cfg)
+{
+  sub_ = bus.subscribe([this](const Metric& m) { (void)append(m); });
+}
+
+MetricHistory::BlockPtr MetricHistory::snapshot_(const HistoryEncoder& e) {
+  auto b = std::make_shared<Block>();
+  b->first_ts_ms = e.first_ts_ms();
+  b->last_ts_ms  = e.last_ts_ms();
+  b->count       = e.count();
+  b->bytes       = e.bytes();
+  return b;
+}
+
+void MetricHistory::seal_(Series& s, DataType next_type) {
+  if (s.open.count()) {
+    s.sealed.push_back(snapshot_(s.open));
+    s.sealed_bytes  += s.open.size_bytes();
+    s.sealed_points += s.open.count();
+  }
+  s.open = HistoryEncoder(next_type, cfg_.block_bytes);
+  // älteste Blöcke verdrängen
+  while (!s.sealed.empty() && s.sealed_bytes + s.open.size_bytes() > cfg_.max_bytes_per_series) {
+    s.sealed_bytes  -= s.sealed.front()->bytes.size();
+    s.sealed_points -= s.sealed.front()->count;
+    s.sealed.pop_front();
+    ++evicted_;
+  }
+}
+
+bool MetricHistory::append(const Metric& m) {
+  const auto q = static_cast<Quality>(m.try_get_prop<uint8_t>(PropertyKey::Quality).value_or(0));
+  const uint64_t ts = m.timestamp_ms();
+
+  std::lock_guard<std::mutex> lk(mtx_);
+  auto [it, inserted] = series_.try_emplace(key_of(m.instance_id(), m.metric_id()));
+  Series& s = it->second;
+  if (inserted) s.open = HistoryEncoder(m.datatype(), cfg_.block_bytes);
+
+  const uint64_t last = s.open.count() ? s.open.last_ts_ms()
+                      : s.sealed.empty() ? 0 : s.sealed.back()->last_ts_ms;
+  if (ts < last) {
+    ++out_of_order_;
+    return false;
+  }
+  if (s.open.type() != m.datatype()) seal_(s, m.datatype());
+
+  const Metric::Value v = value_of(m);
+  if (!s.open.append(ts, v, q)) {
+    // Block voll: versiegeln, im neuen Block geht es immer
+    seal_(s, m.datatype());
+    return s.open.append(ts, v, q);
+  }
+  return true;
+}
+
+std::size_t MetricHistory::query(Metric::InstanceId instance, MetricID metric, uint64_t from_ms, uint64_t to_ms,
+                                 const std::function<bool(const HistoryPoint&)>& fn) const {
+  if (from_ms > to_ms) return 0;
+  std::vector<BlockPtr> hit;
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    auto it = series_.find(key_of(instance, metric));
+    if (it == series_.end()) return 0;
+    const Series& s = it->second;
+    for (const BlockPtr& b : s.sealed) {
+      if (b->last_ts_ms >= from_ms && b->first_ts_ms <= to_ms) hit.push_back(b);
+    }
+    if (s.open.count() && s.open.last_ts_ms() >= from_ms && s.open.first_ts_ms() <= to_ms)
+      hit.push_back(snapshot_(s.open));
+  }
+
+  std::size_t n = 0;
+  HistoryPoint p;
+  for (const BlockPtr& b : hit) {
+    HistoryDecoder dec(b->bytes);
+    while (dec.next(p)) {
+      if (p.ts_ms < from_ms) continue;
+      if (p.ts_ms > to_ms) return n;
+      ++n;
+      if (!fn(p)) return n;
+    }
+  }
+  return n;
+}
+
+std::vector<MetricHistory::BlockPtr> MetricHistory::blocks(Metric::InstanceId instance, MetricID metric) const {
+  std::lock_guard<std::mutex> lk(mtx_);
+  std::vector<BlockPtr> out;
+  auto it = series_.find(key_of(instance, metric));
+  if (it == series_.end()) return out;
+  const Series& s = it->second;
+  out.assign(s.sealed.begin(), s.sealed.end());
+  if (s.open.count()) out.push_back(snapshot_(s.open));
+  return out;
+}
+
+MetricHistory::Stats MetricHistory::stats() const {
+  std::lock_guard<std::mutex> lk(mtx_);
+  Stats st;
+  st.series         = series_.size();
+  st.out_of_order   = out_of_order_;
+  st.evicted_blocks = evicted_;
+  for (const auto& [key, s] : series_) {
+    (void)key;
+    st.blocks += s.sealed.size() + (s.open.count() ? 1 : 0);
+    st.points += s.sealed_points + s.open.count();
+    st.bytes  += s.sealed_bytes + s.open.size_bytes();
+  }
+  return st;
+}
+
+} // namespace core
@@ -0,0 +1,75 @@
+#include "core/metric_record.h"
+
+#include <cstring>
+
+namespace core {
+
+namespace {
+
+template <typename T>
+inline uint32_t bits_of(T v) noexcept {
+  static_assert(sizeof(T) <= sizeof(uint32_t), "4-byte payload only");
+  uint32_t b = 0;
+  std::memcpy(&b, &v, sizeof(T));
+  return b;
+}
+
+template <typename T>
+inline T from_bits(uint32_t b) noexcept {
+  T v;
+  std::memcpy(&v, &b, sizeof(T));
+  return v;
+}
+
+} // namespace
+
+MetricRecord to_record(const Metric& m) noexcept {
+  MetricRecord r{};
+  r.timestamp_ms = m.timestamp_ms();
+  r.instance_id  = m.instance_id();
+  r.seq          = m.seq();
+  r.metric_id    = static_cast<uint16_t>(m.metric_id());
+  r.datatype     = static_cast<uint8_t>(m.datatype());
+
+  if (auto f = m.get_if<float>())        r.value = bits_of(*f);
+  else if (auto i = m.get_if<int32_t>()) r.value = bits_of(*i);
+  else if (auto b = m.get_if<bool>())    r.value = *b ? 1u : 0u;
+
+  for (auto const& [key, pv] : m.props()) {
+    const auto k = static_cast<unsigned>(key);
+    if (k < 1 || k > MetricRecord::kPropSlots) continue;
+    const unsigned slot = k - 1;
+    uint16_t type = 0;
+    if (auto u = std::get_if<uint8_t>(&pv))       { r.props[slot] = *u;           type = 1; }
+    else if (auto i = std::get_if<int32_t>(&pv))  { r.props[slot] = bits_of(*i);  type = 2; }
+    else if (auto f = std::get_if<float>(&pv))    { r.props[slot] = bits_of(*f);  type = 3; }
+    r.prop_types |= static_cast<uint16_t>(type << (2 * slot));
+  }
+  return r;
+}
+
+Metric from_record(const MetricRecord& r) {
+  Metric::Value v;
+  switch (static_cast<DataType>(r.datatype)) {
+    case DataType::Float: v = from_bits<float>(r.value);   break;
+    case DataType::Bool:  v = r.value != 0;                break;
+    case DataType::Int32:
+    default:              v = from_bits<int32_t>(r.value); break;
+  }
+
+  Metric::PropMap p;
+  for (unsigned slot = 0; slot < MetricRecord::kPropSlots; ++slot) {
+    const unsigned type = (r.prop_types >> (2 * slot)) & 0x3u;
+    if (!type) continue;
+    const auto key = static_cast<PropertyKey>(slot + 1);
+    switch (type) {
+      case 1: p.emplace(key, static_cast<uint8_t>(r.props[slot]));  break;
+      case 2: p.emplace(key, from_bits<int32_t>(r.props[slot]));    break;
+      case 3: p.emplace(key, from_bits<float>(r.props[slot]));      break;
+    }
+  }
+  return Metric::Make(r.instance_id, static_cast<MetricID>(r.metric_id), v,
+                      r.timestamp_ms, r.seq, std::move(p));
+}
+
+} // namespace core
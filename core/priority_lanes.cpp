@@ -0,0 +1,132 @@
+#include "core/priority_lanes.h"
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+
+namespace core {
+
+// ---- LaneMap ----
+
+LaneMap::LaneMap() {
+  ranges_.push_back(Range{0xFF00, 0xFFFF, Priority::High});
+}
+
+void LaneMap::assign(uint16_t first, uint16_t last, Priority p) {
+  ranges_.push_back(Range{first, last, p});
+}
+
+Priority LaneMap::lane_of(MetricID id) const noexcept {
+  const auto v = static_cast<uint16_t>(id);
+  // neueste Zuordnung gewinnt
+  for (auto it = ranges_.rbegin(); it != ranges_.rend(); ++it) {
+    if (v >= it->first && v <= it->last) return it->p;
+  }
+  return Priority::Normal;
+}
+
+// ---- LaneStats ----
+
+uint64_t LaneDispatcher::LaneStats::percentile_ns(double p) const noexcept {
+  if (!delivered) return 0;
+  const auto want = static_cast<uint64_t>(p * double(delivered) + 0.5);
+  uint64_t acc = 0;
+  for (std::size_t b = 0; b < lat_hist.size(); ++b) {
+    acc += lat_hist[b];
+    if (acc >= want && acc) return b >= 63 ? lat_max_ns : std::min(uint64_t{1} << b, lat_max_ns);
+  }
+  return lat_max_ns;
+}
+
+// ---- LaneDispatcher ----
+
+LaneDispatcher::LaneDispatcher(MetricBus& target, Config cfg)
+: target_(target), cfg_(std::move(cfg)) {}
+
+uint64_t LaneDispatcher::now_ns_() noexcept {
+  using namespace std::chrono;
+  return static_cast<uint64_t>(
+      duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+bool LaneDispatcher::post(const Metric& m) {
+  const auto lane = static_cast<std::size_t>(cfg_.map.lane_of(m.metric_id()));
+  const LaneConfig& lc = cfg_.lanes[lane];
+  const uint64_t now = now_ns_();
+
+  std::lock_guard<std::mutex> lk(mtx_);
+  auto& q = lanes_[lane];
+  auto& st = stats_[lane];
+  ++st.posted;
+
+  // High-Lane und capacity 0 sind unbegrenzt
+  const bool bounded = lane != static_cast<std::size_t>(Priority::High) && lc.capacity;
+  if (bounded && q.size() >= lc.capacity) {
+    ++st.dropped;
+    if (lc.drop == DropPolicy::DropNewest) return false;
+    q.pop_front();
+  }
+  q.push_back(Entry{m, now});
+  return true;
+}
+
+Subscription LaneDispatcher::feed_from(MetricBus& source) {
+  return source.subscribe([this](const Metric& m) { (void)post(m); });
+}
+
+std::size_t LaneDispatcher::drain(std::size_t max) {
+  std::size_t n = 0;
+  while (n < max) {
+    std::optional<Entry> e;
+    std::size_t lane = kPriorityCount;
+    {
+      std::lock_guard<std::mutex> lk(mtx_);
+      for (std::size_t l = 0; l < kPriorityCount; ++l) {
+        if (!lanes_[l].empty()) { lane = l; break; }
+      }
+      if (lane == kPriorityCount) break;
+      e.emplace(std::move(lanes_[lane].front()));
+      lanes_[lane].pop_front();
+    }
+
+    // außerhalb des Locks zustellen (Callbacks dürfen wieder post() aufrufen)
+    target_.publish(e->m);
+    ++n;
+
+    const uint64_t lat = now_ns_() - e->enq_ns;
+    std::size_t b = 0;
+    while (b < 63 && (uint64_t{1} << b) < lat) ++b;
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    auto& st = stats_[lane];
+    ++st.delivered;
+    st.lat_sum_ns += lat;
+    if (lat > st.lat_max_ns) st.lat_max_ns = lat;
+    ++st.lat_hist[b];
+  }
+  return n;
+}
+
+std::size_t LaneDispatcher::pending() const {
+  std::lock_guard<std::mutex> lk(mtx_);
+  std::size_t n = 0;
+  for (auto& q : lanes_) n += q.size();
+  return n;
+}
+
+std::size_t LaneDispatcher::pending(Priority p) const {
+  std::lock_guard<std::mutex> lk(mtx_);
+  return lanes_[static_cast<std::size_t>(p)].size();
+}
+
+LaneDispatcher::LaneStats LaneDispatcher::stats(Priority p) const {
+  std::lock_guard<std::mutex> lk(mtx_);
+  return stats_[static_cast<std::size_t>(p)];
+}
+
+void LaneDispatcher::reset_stats() {
+  std::lock_guard<std::mutex> lk(mtx_);
+  stats_ = {};
+}
+
+} // namespace core
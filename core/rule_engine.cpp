@@ -0,0 +1,268 @@
+#include "core/rule_engine.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include "core/enums.h"
+
+namespace core {
+
+namespace {
+
+struct MetricName { const char* name; MetricID id; };
+
+constexpr std::array<MetricName, 8> kMetricNames{{
+  {"WaterLevelPercent", MetricID::WaterLevelPercent},
+  {"GasLevelPercent",   MetricID::GasLevelPercent},
+  {"TiltAngle",         MetricID::TiltAngle},
+  {"TiltAngleSmoothed", MetricID::TiltAngleSmoothed},
+  {"Temperature",       MetricID::Temperature},
+  {"Electrical",        MetricID::Electrical},
+  {"Health",            MetricID::Health},
+  {"Alarm",             MetricID::Alarm},
+}};
+
+bool parse_metric(const std::string& s, MetricID& out) {
+  for (auto& n : kMetricNames) {
+    if (s == n.name) { out = n.id; return true; }
+  }
+  char* end = nullptr;
+  const unsigned long v = std::strtoul(s.c_str(), &end, 0);
+  if (end == s.c_str() || *end != '\0' || v > 0xFFFFul) return false;
+  out = static_cast<MetricID>(v);
+  return true;
+}
+
+bool parse_op(const std::string& s, Rule::Op& out) {
+  if (s == ">")  { out = Rule::Op::Above;    return true; }
+  if (s == "<")  { out = Rule::Op::Below;    return true; }
+  if (s == "==") { out = Rule::Op::Equal;    return true; }
+  if (s == "!=") { out = Rule::Op::NotEqual; return true; }
+  return false;
+}
+
+bool parse_u32(const std::string& s, uint32_t& out) {
+  char* end = nullptr;
+  const unsigned long v = std::strtoul(s.c_str(), &end, 0);
+  if (end == s.c_str() || *end != '\0' || v > 0xFFFFFFFFul) return false;
+  out = static_cast<uint32_t>(v);
+  return true;
+}
+
+bool parse_float(const std::string& s, float& out) {
+  char* end = nullptr;
+  out = std::strtof(s.c_str(), &end);
+  return end != s.c_str() && *end == '\0';
+}
+
+inline bool to_float(const Metric& m, float& x) {
+  if (auto f = m.get_if<float>())   { x = *f; return true; }
+  if (auto i = m.get_if<int32_t>()) { x = static_cast<float>(*i); return true; }
+  if (auto b = m.get_if<bool>())    { x = *b ? 1.0f : 0.0f; return true; }
+  return false;
+}
+
+// Soll der Alarm (bei aktuellem Zustand `active`) wechseln?
+inline bool wants_toggle(const Rule& r, bool active, float x) {
+  switch (r.op) {
+    case Rule::Op::Above:    return active ? x < r.threshold - r.hysteresis : x > r.threshold;
+    case Rule::Op::Below:    return active ? x > r.threshold + r.hysteresis : x < r.threshold;
+    case Rule::Op::Equal:    return active ? x != r.threshold : x == r.threshold;
+    case Rule::Op::NotEqual: return active ? x == r.threshold : x != r.threshold;
+  }
+  return false;
+}
+
+inline uint64_t mix(uint64_t k) noexcept {
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdull;
+  k ^= k >> 33;
+  return k;
+}
+
+} // namespace
+
+RuleEngine::RuleEngine(MetricBus& bus) : bus_(bus) {
+  sub_ = bus_.subscribe([this](const Metric& m) { (void)evaluate(m); });
+}
+
+bool RuleEngine::load(std::vector<Rule> rules, std::string* err) {
+  std::vector<Compiled> compiled;
+  std::vector<Output>   outputs;
+  compiled.reserve(rules.size());
+  for (auto& r : rules) {
+    if (r.metric == MetricID::Alarm) {
+      if (err) *err = "rules on Alarm not supported";
+      return false;
+    }
+    compiled.push_back(Compiled{r});
+    outputs.push_back(Output{r.alarm_instance});
+  }
+  std::sort(outputs.begin(), outputs.end(),
+            [](const Output& a, const Output& b) { return a.instance < b.instance; });
+  outputs.erase(std::unique(outputs.begin(), outputs.end(),
+                            [](const Output& a, const Output& b) { return a.instance == b.instance; }),
+                outputs.end());
+  for (auto& c : compiled) c.out = static_cast<uint32_t>(output_of_(outputs, c.rule.alarm_instance));
+  std::stable_sort(compiled.begin(), compiled.end(), [](const Compiled& a, const Compiled& b) {
+    return key_of(a.rule.metric, a.rule.instance) < key_of(b.rule.metric, b.rule.instance);
+  });
+
+  // Index mit Füllgrad <= 50%
+  std::size_t keys = 0;
+  for (std::size_t i = 0; i < compiled.size(); ++i) {
+    if (i == 0 || key_of(compiled[i].rule.metric, compiled[i].rule.instance)
+                  != key_of(compiled[i - 1].rule.metric, compiled[i - 1].rule.instance)) ++keys;
+  }
+  std::size_t cap = 8;
+  while (cap < keys * 2) cap <<= 1;
+
+  std::vector<Slot> index(cap);
+  const uint64_t mask = cap - 1;
+  for (std::size_t i = 0; i < compiled.size();) {
+    const uint64_t k = key_of(compiled[i].rule.metric, compiled[i].rule.instance);
+    std::size_t j = i;
+    while (j < compiled.size() && key_of(compiled[j].rule.metric, compiled[j].rule.instance) == k) ++j;
+    uint64_t h = mix(k) & mask;
+    while (index[h].count) h = (h + 1) & mask;
+    index[h] = Slot{k, static_cast<uint32_t>(i), static_cast<uint32_t>(j - i)};
+    i = j;
+  }
+
+  std::lock_guard<std::mutex> lk(mtx_);
+  rules_.swap(compiled);
+  outputs_.swap(outputs);
+  index_.swap(index);
+  mask_ = mask;
+  return true;
+}
+
+std::size_t RuleEngine::output_of_(const std::vector<Output>& outputs, Metric::InstanceId inst) noexcept {
+  const auto it = std::lower_bound(outputs.begin(), outputs.end(), inst,
+                                   [](const Output& o, Metric::InstanceId i) { return o.instance < i; });
+  return it != outputs.end() && it->instance == inst ? static_cast<std::size_t>(it - outputs.begin())
+                                                     : outputs.size();
+}
+
+const RuleEngine::Slot* RuleEngine::find_(uint64_t key) const noexcept {
+  if (index_.empty()) return nullptr;
+  uint64_t h = mix(key) & mask_;
+  while (index_[h].count) {
+    if (index_[h].key == key) return &index_[h];
+    h = (h + 1) & mask_;
+  }
+  return nullptr;
+}
+
+std::size_t RuleEngine::evaluate(const Metric& m) {
+  // eigene Alarme nicht erneut auswerten
+  if (m.metric_id() == MetricID::Alarm) return 0;
+  float x;
+  if (!to_float(m, x)) return 0;
+
+  struct Change { Metric::InstanceId inst; bool active; uint32_t seq; };
+  std::array<Change, 8> local;
+  std::vector<Change>   spill;
+  std::size_t n_changes = 0;
+
+  const uint64_t ts = m.timestamp_ms();
+  std::size_t evaluated = 0;
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    const Slot* s = find_(key_of(m.metric_id(), m.instance_id()));
+    if (!s) return 0;
+    evaluated = s->count;
+
+    for (uint32_t i = s->first; i < s->first + s->count; ++i) {
+      Compiled& c = rules_[i];
+      if (!wants_toggle(c.rule, c.active, x)) { c.pending = false; continue; }
+      // Zeit läuft zurück (Neustart der Quelle, Replay): Fenster neu beginnen
+      if (!c.pending || ts < c.pending_since) { c.pending = true; c.pending_since = ts; }
+      if (ts - c.pending_since < c.rule.debounce_ms) continue;
+
+      c.active  = !c.active;
+      c.pending = false;
+      // publiziert wird nur der Wechsel des ODER über alle Regeln der alarm_instance
+      Output& o = outputs_[c.out];
+      const bool was = o.active_rules != 0;
+      o.active_rules = c.active ? o.active_rules + 1 : o.active_rules - 1;
+      if ((o.active_rules != 0) == was) continue;
+      const Change ch{o.instance, !was, ++o.seq};
+      if (n_changes < local.size()) local[n_changes] = ch;
+      else                          spill.push_back(ch);
+      ++n_changes;
+    }
+  }
+
+  // außerhalb des Locks publizieren (re-entrant)
+  for (std::size_t i = 0; i < n_changes; ++i) {
+    const Change& ch = i < local.size() ? local[i] : spill[i - local.size()];
+    Metric::PropMap p;
+    p.emplace(PropertyKey::Unit,    static_cast<uint8_t>(Unit::None));
+    p.emplace(PropertyKey::Quality, static_cast<uint8_t>(Quality::Good));
+    bus_.publish(Metric::Make(ch.inst, MetricID::Alarm, ch.active, ts, ch.seq, std::move(p)));
+  }
+  return evaluated;
+}
+
+bool RuleEngine::alarm_active(Metric::InstanceId alarm_instance) const {
+  std::lock_guard<std::mutex> lk(mtx_);
+  const std::size_t i = output_of_(outputs_, alarm_instance);
+  return i < outputs_.size() && outputs_[i].active_rules != 0;
+}
+
+bool RuleEngine::parse_rule(const std::string& line, Rule& out, std::string* err) {
+  std::istringstream ss(line);
+  std::vector<std::string> tok;
+  for (std::string t; ss >> t;) tok.push_back(t);
+
+  auto fail = [&](const char* why) { if (err) *err = why; return false; };
+
+  // 5 Felder: ohne hysteresis/debounce, 6: ohne debounce, 7: vollständig
+  if (tok.size() < 5 || tok.size() > 7) return fail("expected 5..7 fields");
+
+  Rule r;
+  if (!parse_metric(tok[0], r.metric))              return fail("unknown metric");
+  if (r.metric == MetricID::Alarm)                  return fail("rules on Alarm not supported");
+  if (!parse_u32(tok[1], r.instance))               return fail("bad instance");
+  if (!parse_op(tok[2], r.op))                      return fail("bad operator");
+  if (!parse_float(tok[3], r.threshold))            return fail("bad threshold");
+  if (tok.size() >= 6 && !parse_float(tok[4], r.hysteresis)) return fail("bad hysteresis");
+  if (tok.size() == 7 && !parse_u32(tok[5], r.debounce_ms))  return fail("bad debounce_ms");
+  if (!parse_u32(tok.back(), r.alarm_instance))     return fail("bad alarm_instance");
+  out = r;
+  return true;
+}
+
+bool RuleEngine::load_config(std::istream& in, std::string* err) {
+  std::vector<Rule> rules;
+  std::string line;
+  for (std::size_t lineno = 1; std::getline(in, line); ++lineno) {
+    const auto hash = line.find('#');
+    if (hash != std::string::npos) line.erase(hash);
+    if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+    Rule r;
+    std::string why;
+    if (!parse_rule(line, r, &why)) {
+      if (err) *err = "line " + std::to_string(lineno) + ": " + why;
+      return false;
+    }
+    rules.push_back(r);
+  }
+  return load(std::move(rules), err);
+}
+
+bool RuleEngine::load_file(const std::string& path, std::string* err) {
+  std::ifstream f(path);
+  if (!f) {
+    if (err) *err = "cannot open " + path;
+    return false;
+  }
+  return load_config(f, err);
+}
+
+} // namespace core
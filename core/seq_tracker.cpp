@@ -0,0 +1,112 @@
+#include "core/seq_tracker.h"
+
+#include <algorithm>
+
+namespace core {
+
+namespace {
+constexpr uint32_t kWindow = 64;   // Bits in Entry::seen
+} // namespace
+
+SeqTracker::SeqTracker(Config cfg)
+: cfg_(cfg)
+{
+#if CARAVAN_STATIC
+  cfg_.max_instances = std::min(cfg_.max_instances, caps::kMaxSeqInstances);
+  mask_ = kTable - 1;
+#else
+  std::size_t n = 1;
+  while (n < 2 * std::max<std::size_t>(cfg_.max_instances, 1)) n <<= 1;
+  table_.resize(n);
+  mask_ = n - 1;
+#endif
+}
+
+SeqTracker::Entry* SeqTracker::slot_(InstanceId instance, bool insert) noexcept {
+  // Fibonacci-Hashing wie MetricBus, lineares Sondieren
+  std::size_t i = static_cast<std::size_t>((instance * 0x9E3779B97F4A7C15ull) >> 32) & mask_;
+  for (;; i = (i + 1) & mask_) {
+    Entry& e = table_[i];
+    if (e.used && e.instance == instance) return &e;
+    if (!e.used) {
+      if (!insert || stats_.instances >= cfg_.max_instances) return nullptr;
+      e          = Entry{};
+      e.instance = instance;
+      e.used     = true;
+      ++stats_.instances;
+      return &e;
+    }
+  }
+}
+
+SeqTracker::Verdict SeqTracker::observe(InstanceId instance, uint32_t seq) noexcept {
+  if (seq == 0) { ++stats_.untracked; return Verdict::Untracked; }
+
+  Entry* e = slot_(instance, false);
+  if (!e) {
+    e = slot_(instance, true);
+    if (!e) { ++stats_.untracked; return Verdict::Untracked; }
+    e->last_seq = seq;
+    ++e->received;
+    ++stats_.received;
+    return Verdict::First;
+  }
+
+  const uint32_t d = seq - e->last_seq;   // modulo 2^32
+  if (d == 0) {
+    ++e->duplicates;
+    ++stats_.duplicates;
+    return Verdict::Duplicate;
+  }
+
+  if (d < 0x80000000u) {
+    // vorwärts: Fenster verschieben, last selbst wird Bit d-1
+    e->seen     = d < kWindow ? (e->seen << d) | (1ull << (d - 1))
+                : d == kWindow ? (1ull << (kWindow - 1)) : 0;
+    e->last_seq = seq;
+    ++e->received;
+    ++stats_.received;
+    if (d == 1) return Verdict::InOrder;
+    e->lost      += d - 1;
+    stats_.lost  += d - 1;
+    ++stats_.gaps;
+    return Verdict::Gap;
+  }
+
+  // rückwärts
+  const uint32_t back = e->last_seq - seq;
+  if (seq > cfg_.reset_below && back <= kWindow) {
+    const uint64_t bit = 1ull << (back - 1);
+    if (e->seen & bit) {
+      ++e->duplicates;
+      ++stats_.duplicates;
+      return Verdict::Duplicate;
+    }
+    e->seen |= bit;
+    ++e->received;
+    ++stats_.received;
+    if (e->lost) --e->lost;
+    if (stats_.lost) --stats_.lost;
+    ++stats_.late;
+    return Verdict::Late;
+  }
+
+  e->last_seq = seq;
+  e->seen     = 0;
+  ++e->received;
+  ++e->resets;
+  ++stats_.received;
+  ++stats_.resets;
+  return Verdict::Reset;
+}
+
+const SeqTracker::Entry* SeqTracker::find(InstanceId instance) const noexcept {
+  return const_cast<SeqTracker*>(this)->slot_(instance, false);
+}
+
+void SeqTracker::clear() noexcept {
+  std::fill(table_.begin(), table_.end(), Entry{});
+  stats_ = Stats{};
+}
+
+} // namespace core
@@ -0,0 +1,131 @@
+#include "core/stream_ops.h"
+
+#include <cstring>
+
+namespace core::stream {
+
+// ---- MovingAverage ----
+
+MovingAverage::MovingAverage(std::size_t window)
+: buf_(window ? window : 1, 0.0f) {}
+
+float MovingAverage::push(float x, uint64_t) noexcept {
+  if (count_ == buf_.size()) sum_ -= buf_[head_];
+  else ++count_;
+  buf_[head_] = x;
+  sum_ += x;
+  head_ = (head_ + 1) % buf_.size();
+  return static_cast<float>(sum_ / static_cast<double>(count_));
+}
+
+void MovingAverage::reset() noexcept {
+  head_ = 0; count_ = 0; sum_ = 0.0;
+}
+
+// ---- Ewma ----
+
+float Ewma::push(float x, uint64_t) noexcept {
+  if (!init_) { state_ = x; init_ = true; }
+  else        state_ += alpha_ * (x - state_);
+  return state_;
+}
+
+// ---- RateOfChange ----
+
+float RateOfChange::push(float x, uint64_t ts_ms) noexcept {
+  if (init_ && ts_ms > last_ts_) {
+    rate_ = (x - last_) * 1000.0f / static_cast<float>(ts_ms - last_ts_);
+  }
+  // gleicher Zeitstempel -> letzte Rate beibehalten
+  if (!init_ || ts_ms > last_ts_) { last_ = x; last_ts_ = ts_ms; }
+  init_ = true;
+  return rate_;
+}
+
+// ---- MedianFilter ----
+
+MedianFilter::MedianFilter(std::size_t window)
+: ring_(window ? window : 1, 0.0f), sorted_(window ? window : 1, 0.0f) {}
+
+float MedianFilter::push(float x, uint64_t) noexcept {
+  const std::size_t n = ring_.size();
+  float* s = sorted_.data();
+
+  if (count_ == n) {
+    // ältesten Wert aus dem sortierten Fenster entfernen
+    const float old = ring_[head_];
+    float* pos = std::lower_bound(s, s + count_, old);
+    std::memmove(pos, pos + 1, static_cast<std::size_t>(s + count_ - pos - 1) * sizeof(float));
+    --count_;
+  }
+  float* pos = std::upper_bound(s, s + count_, x);
+  std::memmove(pos + 1, pos, static_cast<std::size_t>(s + count_ - pos) * sizeof(float));
+  *pos = x;
+  ++count_;
+
+  ring_[head_] = x;
+  head_ = (head_ + 1) % n;
+
+  if (count_ & 1u) return s[count_ / 2];
+  return 0.5f * (s[count_ / 2 - 1] + s[count_ / 2]);
+}
+
+// ---- EwmaBank ----
+
+EwmaBank::EwmaBank(std::size_t channels, float alpha)
+: state_(channels, 0.0f), alpha_(alpha) {}
+
+void EwmaBank::update(const float* x) noexcept {
+  const std::size_t n = state_.size();
+  float* s = state_.data();
+  if (!init_) {
+    for (std::size_t i = 0; i < n; ++i) s[i] = x[i];
+    init_ = true;
+    return;
+  }
+  const float a = alpha_;
+  for (std::size_t i = 0; i < n; ++i) s[i] += a * (x[i] - s[i]);
+}
+
+// ---- MovingAverageBank ----
+
+MovingAverageBank::MovingAverageBank(std::size_t channels, std::size_t window)
+: window_(window ? window : 1)
+, ring_(channels * (window ? window : 1), 0.0f)
+, sums_(channels, 0.0f) {}
+
+void MovingAverageBank::update(const float* x) noexcept {
+  const std::size_t n = sums_.size();
+  float* row = ring_.data() + head_ * n;
+  float* sum = sums_.data();
+
+  for (std::size_t i = 0; i < n; ++i) {
+    sum[i] += x[i] - row[i];
+    row[i]  = x[i];
+  }
+  if (count_ < window_) ++count_;
+  head_ = (head_ + 1) % window_;
+
+  if (head_ == 0) {
+    // exakte Neuberechnung einmal pro Umlauf (amortisiert O(channels))
+    for (std::size_t i = 0; i < n; ++i) sum[i] = 0.0f;
+    for (std::size_t r = 0; r < window_; ++r) {
+      const float* rr = ring_.data() + r * n;
+      for (std::size_t i = 0; i < n; ++i) sum[i] += rr[i];
+    }
+  }
+}
+
+void MovingAverageBank::reset() noexcept {
+  std::fill(ring_.begin(), ring_.end(), 0.0f);
+  std::fill(sums_.begin(), sums_.end(), 0.0f);
+  head_ = 0; count_ = 0;
+}
+
+void MovingAverageBank::means(float* out) const noexcept {
+  const std::size_t n = sums_.size();
+  const float inv = count_ ? 1.0f / static_cast<float>(count_) : 0.0f;
+  for (std::size_t i = 0; i < n; ++i) out[i] = sums_[i] * inv;
+}
+
+} // namespace core::stream
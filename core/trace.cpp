@@ -0,0 +1,304 @@
+#include "core/trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace core::trace {
+
+namespace detail {
+std::atomic<bool> g_enabled{false};
+} // namespace detail
+
+namespace {
+
+enum : uint8_t { kComplete = 0, kCounter = 1 };
+
+// Felder einzeln atomar (relaxed = normale Stores), damit ein Export während
+// der Aufzeichnung kein Data Race ist; Konsistenz über head (siehe snapshot_)
+struct Event {
+  std::atomic<uint64_t>    ts{0};
+  std::atomic<uint64_t>    dur{0};
+  std::atomic<const char*> name{nullptr};
+  std::atomic<int64_t>     arg{0};
+  std::atomic<uint8_t>     kind{kComplete};
+};
+
+struct Plain {
+  uint64_t    ts, dur;
+  const char* name;
+  int64_t     arg;
+  uint8_t     kind;
+};
+
+// Ein Schreiber (der besitzende Thread), beliebige Leser
+struct Ring {
+  Ring(std::size_t cap, uint32_t id) : mask(cap - 1), events(new Event[cap]), tid(id) {}
+
+  const std::size_t        mask;
+  std::unique_ptr<Event[]> events;
+  std::atomic<uint64_t>    head{0};    // nächster Schreibindex (monoton)
+  std::atomic<uint64_t>    floor{0};   // ältester gültiger Index seit start()
+  uint32_t                 tid;        // unter Registry::mtx (neu bei Wiederverwendung)
+  std::string              name;       // unter Registry::mtx
+  bool                     retired{false};   // Thread beendet, Ring in Registry::spare
+};
+
+struct Registry {
+  std::mutex                         mtx;
+  std::vector<std::shared_ptr<Ring>> rings;   // auch von beendeten Threads (Export)
+  std::vector<std::shared_ptr<Ring>> spare;   // von beendeten Threads, wiederverwendbar
+  std::size_t                        capacity{8192};
+  uint32_t                           next_tid{1};
+  bool                               running{false};
+};
+
+Registry& registry() {
+  static Registry r;
+  return r;
+}
+
+uint64_t steady_ns() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+std::atomic<TimeSource> g_time{&steady_ns};
+
+std::size_t round_pow2(std::size_t n) {
+  std::size_t p = 16;
+  while (p < n) p <<= 1;
+  return p;
+}
+
+// Ring und Name des Threads. Ein Ring wird erst beim ersten Event während
+// der Aufzeichnung belegt; beim Thread-Ende geht er an Registry::spare.
+struct LocalRing {
+  std::shared_ptr<Ring> ring;
+  std::string           name;
+
+  ~LocalRing() {
+    if (!ring) return;
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lk(r.mtx);
+    ring->retired = true;
+    r.spare.push_back(std::move(ring));
+  }
+};
+
+LocalRing& local() {
+  thread_local LocalRing l;
+  return l;
+}
+
+Ring* local_ring() {
+  LocalRing& l = local();
+  if (l.ring) return l.ring.get();
+  if (!enabled()) return nullptr;   // Span über stop() hinaus: verwerfen
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lk(r.mtx);
+  if (!r.spare.empty()) {
+    // Events des beendeten Threads verwerfen, neue Thread-ID
+    l.ring = std::move(r.spare.back());
+    r.spare.pop_back();
+    l.ring->floor.store(l.ring->head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    l.ring->tid     = r.next_tid++;
+    l.ring->retired = false;
+  } else {
+    l.ring = std::make_shared<Ring>(r.capacity, r.next_tid++);
+    r.rings.push_back(l.ring);
+  }
+  l.ring->name = l.name;
+  return l.ring.get();
+}
+
+inline void push(const char* name, uint64_t ts, uint64_t dur, int64_t arg, uint8_t kind) {
+  Ring* rp = local_ring();
+  if (!rp) return;
+  Ring& r = *rp;
+  const uint64_t idx = r.head.load(std::memory_order_relaxed);
+  Event& e = r.events[idx & r.mask];
+  e.ts.store(ts, std::memory_order_relaxed);
+  e.dur.store(dur, std::memory_order_relaxed);
+  e.name.store(name, std::memory_order_relaxed);
+  e.arg.store(arg, std::memory_order_relaxed);
+  e.kind.store(kind, std::memory_order_relaxed);
+  r.head.store(idx + 1, std::memory_order_release);
+}
+
+// gültige Events eines Rings kopieren (Seqlock-Muster über head)
+void snapshot_(const Ring& r, std::vector<Plain>& out) {
+  const uint64_t cap = r.mask + 1;
+  const uint64_t h1  = r.head.load(std::memory_order_acquire);
+  const uint64_t lo  = std::max(r.floor.load(std::memory_order_relaxed), h1 > cap ? h1 - cap : 0);
+  const std::size_t base = out.size();
+  for (uint64_t i = lo; i < h1; ++i) {
+    const Event& e = r.events[i & r.mask];
+    out.push_back(Plain{e.ts.load(std::memory_order_relaxed), e.dur.load(std::memory_order_relaxed),
+                        e.name.load(std::memory_order_relaxed), e.arg.load(std::memory_order_relaxed),
+                        e.kind.load(std::memory_order_relaxed)});
+  }
+  // inzwischen überschriebene Einträge verwerfen: Index i ist nur gültig,
+  // solange der Schreiber i + cap noch nicht begonnen hat
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const uint64_t h2 = r.head.load(std::memory_order_relaxed);
+  if (h2 >= cap && h2 - cap + 1 > lo) {
+    const uint64_t drop = std::min<uint64_t>(h2 - cap + 1 - lo, h1 - lo);
+    out.erase(out.begin() + static_cast<std::ptrdiff_t>(base),
+              out.begin() + static_cast<std::ptrdiff_t>(base + drop));
+  }
+}
+
+void write_escaped(std::ostream& os, const char* s) {
+  for (; s && *s; ++s) {
+    const char c = *s;
+    if (c == '"' || c == '\\') os << '\\' << c;
+    else if (static_cast<unsigned char>(c) < 0x20) os << ' ';
+    else os << c;
+  }
+}
+
+// ns -> µs mit drei Nachkommastellen, ohne Gleitkomma-Rundung
+void write_us(std::ostream& os, uint64_t ns) {
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%" PRIu64 ".%03" PRIu64, ns / 1000, ns % 1000);
+  os << buf;
+}
+
+} // namespace
+
+void start(std::size_t events_per_thread) {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lk(r.mtx);
+  r.capacity = round_pow2(events_per_thread);
+  // Ringe beendeter Threads freigeben (ihre Events werden ohnehin verworfen)
+  r.rings.erase(std::remove_if(r.rings.begin(), r.rings.end(),
+                               [](const std::shared_ptr<Ring>& ring) { return ring->retired; }),
+                r.rings.end());
+  r.spare.clear();
+  for (auto& ring : r.rings) ring->floor.store(ring->head.load(std::memory_order_acquire));
+  r.running = true;
+  detail::g_enabled.store(true, std::memory_order_relaxed);
+}
+
+void stop() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lk(r.mtx);
+  r.running = false;
+  detail::g_enabled.store(false, std::memory_order_relaxed);
+}
+
+bool is_running() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lk(r.mtx);
+  return r.running;
+}
+
+void set_time_source(TimeSource fn) {
+  g_time.store(fn ? fn : &steady_ns, std::memory_order_relaxed);
+}
+
+uint64_t now_ns() {
+  return g_time.load(std::memory_order_relaxed)();
+}
+
+void set_thread_name(const std::string& name) {
+  LocalRing& l = local();
+  l.name = name;
+  if (!l.ring) return;   // Ring erst bei Aufzeichnung
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lk(r.mtx);
+  l.ring->name = name;
+}
+
+void complete(const char* name, uint64_t start_ns, uint64_t dur_ns, int64_t arg) {
+  push(name, start_ns, dur_ns, arg, kComplete);
+}
+
+void counter(const char* name, int64_t value) {
+  push(name, now_ns(), 0, value, kCounter);
+}
+
+std::size_t event_count() {
+  Registry& r = registry();
+  std::vector<std::shared_ptr<Ring>> rings;
+  {
+    std::lock_guard<std::mutex> lk(r.mtx);
+    rings = r.rings;
+  }
+  std::size_t n = 0;
+  std::vector<Plain> tmp;
+  for (auto& ring : rings) {
+    tmp.clear();
+    snapshot_(*ring, tmp);
+    n += tmp.size();
+  }
+  return n;
+}
+
+void write_chrome_json(std::ostream& os) {
+  Registry& r = registry();
+  std::vector<std::shared_ptr<Ring>> rings;
+  std::vector<std::string> names;
+  std::vector<uint32_t> tids;
+  {
+    std::lock_guard<std::mutex> lk(r.mtx);
+    rings = r.rings;
+    for (auto& ring : rings) {
+      names.push_back(ring->name);
+      tids.push_back(ring->tid);
+    }
+  }
+
+  os << "{\"traceEvents\":[\n";
+  os << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"CaravanOS\"}}";
+  std::vector<Plain> evs;
+  for (std::size_t i = 0; i < rings.size(); ++i) {
+    const uint32_t tid = tids[i];
+    if (!names[i].empty()) {
+      os << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"name\":\"";
+      write_escaped(os, names[i].c_str());
+      os << "\"}}";
+    }
+    evs.clear();
+    snapshot_(*rings[i], evs);
+    for (const Plain& e : evs) {
+      os << ",\n{\"name\":\"";
+      write_escaped(os, e.name);
+      if (e.kind == kCounter) {
+        os << "\",\"ph\":\"C\",\"pid\":1,\"tid\":" << tid << ",\"ts\":";
+        write_us(os, e.ts);
+        os << ",\"args\":{\"value\":" << e.arg << "}}";
+      } else {
+        os << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid << ",\"ts\":";
+        write_us(os, e.ts);
+        os << ",\"dur\":";
+        write_us(os, e.dur);
+        os << ",\"args\":{\"arg\":" << e.arg << "}}";
+      }
+    }
+  }
+  os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+bool dump_chrome_json(const std::string& path, std::string* err) {
+  std::ofstream f(path);
+  if (!f) {
+    if (err) *err = "cannot open " + path;
+    return false;
+  }
+  write_chrome_json(f);
+  if (!f) {
+    if (err) *err = "write failed: " + path;
+    return false;
+  }
+  return true;
+}
+
+} // namespace core::trace
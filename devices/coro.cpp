@@ -0,0 +1,124 @@
+#include "coro.h"
+
+#include <algorithm>
+#include <new>
+
+#include <core/trace.h>
+
+namespace devices::coro {
+
+namespace {
+// Chunks ~16 KiB, mindestens 8 Blöcke
+constexpr std::size_t kChunkBytes = 16 * 1024;
+} // namespace
+
+FramePool& FramePool::local() {
+  thread_local FramePool pool;
+  return pool;
+}
+
+void FramePool::refill_(std::size_t cls) {
+  const std::size_t block = (cls + 1) * kGranule;
+  const std::size_t count = std::max<std::size_t>(8, kChunkBytes / block);
+  chunks_.push_back(std::make_unique<std::byte[]>(block * count));
+  std::byte* base = chunks_.back().get();
+  reserved_ += block * count;
+  for (std::size_t i = count; i-- > 0;) {
+    auto* node = reinterpret_cast<FreeNode*>(base + i * block);
+    node->next  = free_[cls];
+    free_[cls]  = node;
+  }
+}
+
+void* FramePool::allocate(std::size_t n) {
+  ++live_;
+  const std::size_t cls = (n + kGranule - 1) / kGranule - 1;
+  if (n == 0 || cls >= kClasses) {
+    ++heap_fallbacks_;
+    return ::operator new(n);
+  }
+  if (!free_[cls]) refill_(cls);
+  FreeNode* node = free_[cls];
+  free_[cls]     = node->next;
+  return node;
+}
+
+void FramePool::deallocate(void* p, std::size_t n) noexcept {
+  --live_;
+  const std::size_t cls = (n + kGranule - 1) / kGranule - 1;
+  if (n == 0 || cls >= kClasses) {
+    ::operator delete(p);
+    return;
+  }
+  auto* node = static_cast<FreeNode*>(p);
+  node->next = free_[cls];
+  free_[cls] = node;
+}
+
+namespace {
+inline bool later(const auto& a, const auto& b) {
+  return a.deadline_ms != b.deadline_ms ? a.deadline_ms > b.deadline_ms : a.seq > b.seq;
+}
+} // namespace
+
+Scheduler::~Scheduler() {
+  // Frames der Wurzeln (und damit verschachtelter Tasks) freigeben
+  roots_.clear();
+}
+
+void Scheduler::spawn(Task<> t) {
+  if (!t.valid()) return;
+  ready_.push_back({t.handle(), nullptr});
+  roots_.push_back(std::move(t));
+}
+
+void Scheduler::add_timer_(uint64_t deadline_ms, std::coroutine_handle<> h) {
+  timers_.push_back({deadline_ms, ++timer_seq_, h});
+  std::push_heap(timers_.begin(), timers_.end(), [](const Timer& a, const Timer& b) { return later(a, b); });
+}
+
+std::size_t Scheduler::run_once() {
+  const uint64_t now = now_ms();
+  const auto cmp = [](const Timer& a, const Timer& b) { return later(a, b); };
+  while (!timers_.empty() && timers_.front().deadline_ms <= now) {
+    std::pop_heap(timers_.begin(), timers_.end(), cmp);
+    ready_.push_back({timers_.back().h, nullptr});
+    timers_.pop_back();
+  }
+
+  // nur die bei Rundenbeginn bereiten Koroutinen; was währenddessen bereit
+  // wird (neue Transaktionen), kommt in dieselbe Runde hinten dran
+  std::size_t resumed = 0;
+  round_.clear();
+  round_.swap(ready_);
+  for (std::size_t i = 0; i < round_.size(); ++i) {
+    Ready r = round_[i];
+    if (r.io) {
+      ReadHoldingAwaiter& op = *r.io;
+      CARAVAN_TRACE_SCOPE_ARG("modbus.read_holding", op.addr);
+      op.ok = op.client.read_holding(op.addr, op.reg, op.n, op.out, op.timeout_ms);
+      ++transactions_;
+    }
+    r.h.resume();
+    ++resumed;
+    // Transaktionen sofort ausführen, statt eine Runde zu warten
+    for (auto it = ready_.begin(); it != ready_.end();) {
+      if (it->io) { round_.push_back(*it); it = ready_.erase(it); }
+      else ++it;
+    }
+  }
+  reap_();
+  return resumed;
+}
+
+uint64_t Scheduler::next_wakeup_ms() {
+  if (!ready_.empty()) return now_ms();
+  return timers_.empty() ? UINT64_MAX : timers_.front().deadline_ms;
+}
+
+void Scheduler::reap_() {
+  roots_.erase(std::remove_if(roots_.begin(), roots_.end(), [](const Task<>& t) { return t.done(); }),
+               roots_.end());
+}
+
+} // namespace devices::coro
@@ -0,0 +1,346 @@
+#include "device_registry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include <core/static_config.h>
+#include <core/trace.h>
+
+#include "tilt_wt901c.h"
+
+using namespace core;
+
+namespace devices {
+
+namespace {
+
+bool parse_u32(const std::string& s, uint32_t& out) {
+  char* end = nullptr;
+  const unsigned long v = std::strtoul(s.c_str(), &end, 0);
+  if (end == s.c_str() || *end != '\0' || v > 0xFFFFFFFFul) return false;
+  out = static_cast<uint32_t>(v);
+  return true;
+}
+
+// optionaler numerischer Parameter mit Bereichsprüfung
+bool param_u32(const DeviceSpec& spec, const char* key, uint32_t max, uint32_t& inout, std::string* err) {
+  const std::string* v = spec.param(key);
+  if (!v) return true;
+  uint32_t x = 0;
+  if (!parse_u32(*v, x) || x > max) {
+    if (err) *err = "bad value for " + std::string(key) + ": " + *v;
+    return false;
+  }
+  inout = x;
+  return true;
+}
+
+std::unique_ptr<IDevice> make_wt901c(MetricBus& bus, const DeviceSpec& spec,
+                                     BusContext& ctx, std::string* err) {
+  Wt901cDevice::Config cfg;
+  uint32_t addr = cfg.modbus_addr, reg = cfg.start_reg, count = cfg.reg_count;
+  uint32_t poll = cfg.poll_interval_ms, adaptive = 0;
+  // FC03-Limit; statisches Profil: Größe von ModbusRegs
+  constexpr uint32_t kMaxCount = caps::kStatic ? std::min<std::size_t>(125, caps::kMaxRegs) : 125;
+  if (!param_u32(spec, "addr", 247, addr, err) ||
+      !param_u32(spec, "reg", 0xFFFF, reg, err) ||
+      !param_u32(spec, "count", kMaxCount, count, err) ||
+      !param_u32(spec, "poll", 0xFFFFFFFFu, poll, err) ||
+      !param_u32(spec, "adaptive", 1, adaptive, err) ||
+      !param_u32(spec, "poll_min", 0xFFFFFFFFu, cfg.poll.min_interval_ms, err) ||
+      !param_u32(spec, "poll_max", 0xFFFFFFFFu, cfg.poll.max_interval_ms, err) ||
+      !param_u32(spec, "backoff_max", 0xFFFFFFFFu, cfg.poll.backoff_max_ms, err)) {
+    return nullptr;
+  }
+  if (cfg.poll.min_interval_ms > cfg.poll.max_interval_ms) {
+    if (err) *err = "poll_min > poll_max";
+    return nullptr;
+  }
+  if (count == 0) {
+    if (err) *err = "count must be > 0";
+    return nullptr;
+  }
+  cfg.modbus_addr      = static_cast<uint8_t>(addr);
+  cfg.start_reg        = static_cast<uint16_t>(reg);
+  cfg.reg_count        = static_cast<uint16_t>(count);
+  cfg.poll_interval_ms = poll;
+  cfg.adaptive         = adaptive != 0;
+  cfg.budget           = ctx.budget;
+  cfg.poll.seed        = spec.instance * 2654435761u + 1u;   // Jitter je Gerät verschieden
+  return std::make_unique<Wt901cDevice>(bus, spec.instance, ctx.client, cfg);
+}
+
+} // namespace
+
+const std::string* DeviceSpec::param(const std::string& key) const {
+  for (auto& kv : params) if (kv.first == key) return &kv.second;
+  return nullptr;
+}
+
+DeviceRegistry::DeviceRegistry(MetricBus& bus, IClock& clock)
+: DeviceRegistry(bus, clock, Config{})
+{}
+
+DeviceRegistry::DeviceRegistry(MetricBus& bus, IClock& clock, Config cfg)
+: bus_(bus), clock_(clock), cfg_(cfg)
+{
+  factories_["wt901c"] = make_wt901c;
+}
+
+DeviceRegistry::~DeviceRegistry() { stop(); }
+
+void DeviceRegistry::register_type(const std::string& type, Factory f) {
+  factories_[type] = std::move(f);
+}
+
+void DeviceRegistry::add_bus(const std::string& name, IModbusClient& client) {
+  Strand& s = strands_[name];
+  if (cfg_.block_cache_max_age_ms) {
+    RegisterBlockCache::Config cc;
+    cc.max_age_ms = cfg_.block_cache_max_age_ms;
+    s.cache  = std::make_unique<RegisterBlockCache>(client, clock_, cc);
+    s.client = s.cache.get();
+  } else {
+    s.cache.reset();
+    s.client = &client;
+  }
+  if (cfg_.bus_budget_per_s > 0.0f) {
+    s.budget = std::make_unique<BusBudget>(cfg_.bus_budget_per_s, cfg_.bus_budget_burst);
+  } else {
+    s.budget.reset();
+  }
+}
+
+RegisterBlockCache* DeviceRegistry::block_cache(const std::string& bus_name) {
+  auto it = strands_.find(bus_name);
+  return it == strands_.end() ? nullptr : it->second.cache.get();
+}
+
+bool DeviceRegistry::build_(const DeviceSpec& spec, std::unique_ptr<IDevice>& out, std::string* err) const {
+  if (running_.load()) {
+    if (err) *err = "registry already started";
+    return false;
+  }
+  auto f = factories_.find(spec.type);
+  if (f == factories_.end()) {
+    if (err) *err = "unknown device type: " + spec.type;
+    return false;
+  }
+  auto b = strands_.find(spec.bus);
+  if (b == strands_.end()) {
+    if (err) *err = "unknown bus: " + spec.bus;
+    return false;
+  }
+  for (auto& e : entries_) {
+    if (e->spec.instance == spec.instance) {
+      if (err) *err = "duplicate instance " + std::to_string(spec.instance);
+      return false;
+    }
+  }
+  if (caps::kStatic && entries_.size() >= caps::kMaxDevices) {
+    if (err) *err = "device limit reached (CARAVAN_MAX_DEVICES=" + std::to_string(caps::kMaxDevices) + ")";
+    return false;
+  }
+  BusContext ctx{*b->second.client, b->second.budget.get()};
+  out = f->second(bus_, spec, ctx, err);
+  return out != nullptr;
+}
+
+bool DeviceRegistry::add(const DeviceSpec& spec, std::string* err) {
+  std::unique_ptr<IDevice> dev;
+  if (!build_(spec, dev, err)) return false;
+  auto e  = std::make_unique<Entry>();
+  e->spec = spec;
+  e->dev  = std::move(dev);
+  strands_[spec.bus].devices.push_back(e.get());
+  entries_.push_back(std::move(e));
+  return true;
+}
+
+bool DeviceRegistry::parse_spec(const std::string& line, DeviceSpec& out, std::string* err) {
+  std::istringstream ss(line);
+  std::string inst;
+  DeviceSpec  spec;
+  if (!(ss >> spec.type >> spec.bus >> inst)) {
+    if (err) *err = "expected <type> <bus> <instance> [key=value ...]";
+    return false;
+  }
+  if (!parse_u32(inst, spec.instance)) {
+    if (err) *err = "bad instance: " + inst;
+    return false;
+  }
+  std::string kv;
+  while (ss >> kv) {
+    const auto eq = kv.find('=');
+    if (eq == std::string::npos || eq == 0 || eq + 1 == kv.size()) {
+      if (err) *err = "expected key=value: " + kv;
+      return false;
+    }
+    spec.params.emplace_back(kv.substr(0, eq), kv.substr(eq + 1));
+  }
+  out = std::move(spec);
+  return true;
+}
+
+bool DeviceRegistry::load_config(std::istream& in, std::string* err) {
+  std::vector<DeviceSpec> specs;
+  std::string line;
+  for (std::size_t lineno = 1; std::getline(in, line); ++lineno) {
+    const auto hash = line.find('#');
+    if (hash != std::string::npos) line.erase(hash);
+    if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+    DeviceSpec  spec;
+    std::string why;
+    std::unique_ptr<IDevice> check;
+    if (!parse_spec(line, spec, &why) || !build_(spec, check, &why)) {
+      if (err) *err = "line " + std::to_string(lineno) + ": " + why;
+      return false;
+    }
+    for (auto& s : specs) {
+      if (s.instance == spec.instance) {
+        if (err) *err = "line " + std::to_string(lineno) + ": duplicate instance " + std::to_string(spec.instance);
+        return false;
+      }
+    }
+    if (caps::kStatic && entries_.size() + specs.size() >= caps::kMaxDevices) {
+      if (err) *err = "line " + std::to_string(lineno) + ": device limit reached (CARAVAN_MAX_DEVICES="
+                    + std::to_string(caps::kMaxDevices) + ")";
+      return false;
+    }
+    specs.push_back(std::move(spec));
+  }
+  for (auto& s : specs) (void)add(s);
+  return true;
+}
+
+bool DeviceRegistry::load_file(const std::string& path, std::string* err) {
+  std::ifstream f(path);
+  if (!f) {
+    if (err) *err = "cannot open " + path;
+    return false;
+  }
+  return load_config(f, err);
+}
+
+void DeviceRegistry::start() {
+  if (running_.exchange(true)) return;
+  t_start_ms_ = clock_.millis64();
+  for (auto& kv : strands_) {
+    Strand& s = kv.second;
+    if (s.devices.empty()) continue;
+    s.th = std::thread([this, &s, name = kv.first] {
+      trace::set_thread_name("bus " + name);
+      run_strand_(s);
+    });
+  }
+}
+
+void DeviceRegistry::stop() {
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (!running_.exchange(false)) return;
+  }
+  cv_.notify_all();
+  for (auto& kv : strands_) {
+    if (kv.second.th.joinable()) kv.second.th.join();
+  }
+}
+
+void DeviceRegistry::notify_() {
+  { std::lock_guard<std::mutex> lk(mtx_); }
+  cv_.notify_all();
+}
+
+void DeviceRegistry::run_strand_(Strand& s) {
+  while (running_.load()) {
+    for (Entry* e : s.devices) {
+      if (!running_.load()) break;
+      const uint64_t now = clock_.millis64();
+      const State st = e->state.load();
+      if (st == State::Online) {
+        e->dev->tick(now);
+        continue;
+      }
+      if (now < e->next_probe_ms) continue;
+
+      const uint32_t n = e->attempts.fetch_add(1) + 1;
+      bool ok;
+      {
+        CARAVAN_TRACE_SCOPE_ARG("registry.probe", e->dev->instance_id());
+        ok = e->dev->probe(now);
+      }
+      if (ok) {
+        e->ttfm_ms.store(clock_.millis64() - t_start_ms_);
+        e->state.store(State::Online);
+        notify_();
+      } else {
+        e->next_probe_ms = clock_.millis64() + cfg_.probe_retry_ms;
+        if (st == State::Pending && n >= cfg_.absent_after) {
+          e->state.store(State::Absent);
+          notify_();
+        }
+      }
+    }
+    std::unique_lock<std::mutex> lk(mtx_);
+    cv_.wait_for(lk, std::chrono::milliseconds(sleep_ms_(s)), [this] { return !running_.load(); });
+  }
+}
+
+uint32_t DeviceRegistry::sleep_ms_(const Strand& s) const {
+  if (cfg_.max_idle_ms <= cfg_.idle_ms) return cfg_.idle_ms;
+  const uint64_t now  = clock_.millis64();
+  uint64_t       wake = now + cfg_.max_idle_ms;
+  for (const Entry* e : s.devices) {
+    uint64_t due = e->state.load() == State::Online ? e->dev->next_due_ms() : e->next_probe_ms;
+    if (due == 0) due = now + cfg_.idle_ms;   // Gerät ohne Termin
+    wake = std::min(wake, due);
+  }
+  // mindestens 1 ms: ein Termin, der nach der Runde noch fällig ist, darf
+  // den Strang nicht kreisen lassen
+  return static_cast<uint32_t>(wake > now ? wake - now : 1);
+}
+
+bool DeviceRegistry::wait_settled(uint32_t timeout_ms) {
+  std::unique_lock<std::mutex> lk(mtx_);
+  return cv_.wait_for(lk, std::chrono::milliseconds(timeout_ms), [this] {
+    for (auto& e : entries_) if (e->state.load() == State::Pending) return false;
+    return true;
+  });
+}
+
+std::size_t DeviceRegistry::online_count() const {
+  std::size_t n = 0;
+  for (auto& e : entries_) n += e->state.load() == State::Online;
+  return n;
+}
+
+std::vector<DeviceRegistry::DeviceStatus> DeviceRegistry::report() const {
+  std::vector<DeviceStatus> out;
+  out.reserve(entries_.size());
+  for (auto& e : entries_) {
+    DeviceStatus d;
+    d.type           = e->spec.type;
+    d.bus            = e->spec.bus;
+    d.instance       = e->spec.instance;
+    d.state          = e->state.load();
+    d.probe_attempts = e->attempts.load();
+    d.time_to_first_metric_ms = d.state == State::Online ? e->ttfm_ms.load() : 0;
+    out.push_back(std::move(d));
+  }
+  return out;
+}
+
+const char* DeviceRegistry::to_string(State s) {
+  switch (s) {
+    case State::Pending: return "pending";
+    case State::Online:  return "online";
+    case State::Absent:  return "absent";
+  }
+  return "?";
+}
+
+} // namespace devices
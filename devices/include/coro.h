@@ -0,0 +1,240 @@
+#pragma once
+// Optionale Koroutinen-API für Gerätetreiber (CMake: CARAVAN_COROUTINES=ON).
+// Ein Treiber schreibt seine Poll-Schleife als Koroutine und wartet per
+// co_await auf Modbus-Transaktionen und Timer; ein Scheduler pro Thread
+// (IClock-getrieben, single-threaded) setzt sie fort. Die C++17-Schnittstelle
+// (IDevice::tick) bleibt davon unberührt.
+#if __cplusplus < 202002L
+#error "coro.h requires C++20 (configure with -DCARAVAN_COROUTINES=ON)"
+#endif
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "clock.h"
+#include "modbus.h"
+
+namespace devices::coro {
+
+// Pool für Koroutinen-Frames: Größenklassen zu 64 Byte, Blöcke aus großen
+// Chunks, freigegebene Frames kommen in eine Freiliste und werden
+// wiederverwendet. Ein Pool pro Thread; Frames müssen auf dem Thread
+// freigegeben werden, der sie angelegt hat (Scheduler ist single-threaded).
+class FramePool {
+public:
+  static constexpr std::size_t kGranule = 64;
+  static constexpr std::size_t kClasses = 16;   // bis 1 KiB, größer -> Heap
+
+  static FramePool& local();
+
+  void* allocate(std::size_t n);
+  void  deallocate(void* p, std::size_t n) noexcept;
+
+  std::size_t live_frames()    const noexcept { return live_; }
+  std::size_t reserved_bytes() const noexcept { return reserved_; }
+  std::size_t heap_fallbacks() const noexcept { return heap_fallbacks_; }
+
+private:
+  struct FreeNode { FreeNode* next; };
+  void refill_(std::size_t cls);
+
+  FreeNode* free_[kClasses]{};
+  std::vector<std::unique_ptr<std::byte[]>> chunks_;
+  std::size_t live_{0};
+  std::size_t reserved_{0};
+  std::size_t heap_fallbacks_{0};
+};
+
+template <typename T = void> class Task;
+
+namespace detail {
+
+struct PromiseBase {
+  static void* operator new(std::size_t n) { return FramePool::local().allocate(n); }
+  static void  operator delete(void* p, std::size_t n) noexcept { FramePool::local().deallocate(p, n); }
+
+  struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+    template <typename P>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+      // verschachtelter Task: direkt beim Aufrufer weitermachen
+      auto c = h.promise().continuation;
+      return c ? c : std::noop_coroutine();
+    }
+    void await_resume() const noexcept {}
+  };
+
+  std::suspend_always initial_suspend() const noexcept { return {}; }
+  FinalAwaiter        final_suspend() const noexcept { return {}; }
+  // keine Exceptions im Projekt
+  void unhandled_exception() const noexcept { std::terminate(); }
+
+  std::coroutine_handle<> continuation;
+};
+
+template <typename T>
+struct Promise : PromiseBase {
+  Task<T> get_return_object() noexcept;
+  void return_value(T v) { value.emplace(std::move(v)); }
+  std::optional<T> value;
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+  Task<void> get_return_object() noexcept;
+  void return_void() const noexcept {}
+};
+
+} // namespace detail
+
+// Lazy gestartete Koroutine; besitzt ihren Frame. Als Wurzel per
+// Scheduler::spawn, verschachtelt per co_await (Ergebnis = return-Wert).
+template <typename T>
+class Task {
+public:
+  using promise_type = detail::Promise<T>;
+  using handle_type  = std::coroutine_handle<promise_type>;
+
+  Task() = default;
+  explicit Task(handle_type h) noexcept : h_(h) {}
+  Task(Task&& o) noexcept : h_(std::exchange(o.h_, {})) {}
+  Task& operator=(Task&& o) noexcept {
+    if (this != &o) { reset(); h_ = std::exchange(o.h_, {}); }
+    return *this;
+  }
+  Task(const Task&) = delete;
+  Task& operator=(const Task&) = delete;
+  ~Task() { reset(); }
+
+  bool valid() const noexcept { return static_cast<bool>(h_); }
+  bool done()  const noexcept { return !h_ || h_.done(); }
+  handle_type handle() const noexcept { return h_; }
+
+  void reset() noexcept {
+    if (h_) { h_.destroy(); h_ = {}; }
+  }
+
+  auto operator co_await() && noexcept {
+    struct Awaiter {
+      handle_type h;
+      bool await_ready() const noexcept { return !h || h.done(); }
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+        h.promise().continuation = caller;
+        return h;
+      }
+      T await_resume() {
+        if constexpr (!std::is_void_v<T>) return std::move(*h.promise().value);
+      }
+    };
+    return Awaiter{h_};
+  }
+
+private:
+  handle_type h_{};
+};
+
+namespace detail {
+template <typename T>
+inline Task<T> Promise<T>::get_return_object() noexcept {
+  return Task<T>{std::coroutine_handle<Promise<T>>::from_promise(*this)};
+}
+inline Task<void> Promise<void>::get_return_object() noexcept {
+  return Task<void>{std::coroutine_handle<Promise<void>>::from_promise(*this)};
+}
+} // namespace detail
+
+// Single-threaded Scheduler, Zeitbasis IClock. Der Host ruft run_once()
+// in seiner Schleife auf und schläft bis next_wakeup_ms().
+class Scheduler {
+public:
+  explicit Scheduler(IClock& clock) : clock_(clock) {}
+  ~Scheduler();
+  Scheduler(const Scheduler&) = delete;
+  Scheduler& operator=(const Scheduler&) = delete;
+
+  // Wurzel-Koroutine übernehmen; läuft ab dem nächsten run_once()
+  void spawn(Task<> t);
+
+  // Fällige Timer und alle bereiten Koroutinen (inkl. anstehender
+  // Modbus-Transaktionen) einmal abarbeiten. Liefert die Zahl der Resumes.
+  std::size_t run_once();
+  // Zeitpunkt des nächsten Timers; UINT64_MAX ohne Timer, now bei bereiten Koroutinen
+  uint64_t next_wakeup_ms();
+
+  // Koroutinen sehen stopping() und beenden ihre Schleife
+  void stop() noexcept { stopping_ = true; }
+  bool stopping() const noexcept { return stopping_; }
+
+  uint64_t    now_ms() { return clock_.millis64(); }
+  std::size_t task_count() const noexcept { return roots_.size(); }
+  uint64_t    transactions() const noexcept { return transactions_; }
+
+  // --- Awaitables -------------------------------------------------------
+
+  struct SleepAwaiter {
+    Scheduler& s;
+    uint64_t   deadline_ms;
+    bool await_ready() { return deadline_ms <= s.now_ms(); }
+    void await_suspend(std::coroutine_handle<> h) { s.add_timer_(deadline_ms, h); }
+    void await_resume() const noexcept {}
+  };
+
+  // Modbus-Transaktion als Schritt des Schedulers; liefert den Erfolg.
+  // Transaktionen laufen nacheinander in FIFO-Reihenfolge (ein Bus-Master).
+  struct ReadHoldingAwaiter {
+    Scheduler&             s;
+    IModbusClient&         client;
+    uint8_t                addr;
+    uint16_t               reg;
+    uint16_t               n;
+    ModbusRegs&            out;
+    uint32_t               timeout_ms;
+    bool                   ok{false};
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) { s.ready_.push_back({h, this}); }
+    bool await_resume() const noexcept { return ok; }
+  };
+
+  SleepAwaiter sleep_until(uint64_t deadline_ms) { return {*this, deadline_ms}; }
+  SleepAwaiter sleep_for(uint32_t ms) { return {*this, now_ms() + ms}; }
+  // an andere bereite Koroutinen abgeben (frühestens im nächsten run_once)
+  SleepAwaiter yield() { return {*this, now_ms() + 1}; }
+
+  ReadHoldingAwaiter read_holding(IModbusClient& client, uint8_t addr, uint16_t reg, uint16_t n,
+                                  ModbusRegs& out, uint32_t timeout_ms) {
+    return {*this, client, addr, reg, n, out, timeout_ms};
+  }
+
+private:
+  struct Ready {
+    std::coroutine_handle<> h;
+    ReadHoldingAwaiter*     io;   // nullptr = nur fortsetzen
+  };
+  struct Timer {
+    uint64_t                deadline_ms;
+    uint64_t                seq;
+    std::coroutine_handle<> h;
+  };
+
+  void add_timer_(uint64_t deadline_ms, std::coroutine_handle<> h);
+  void reap_();
+
+  IClock&             clock_;
+  std::vector<Task<>> roots_;
+  std::vector<Ready>  ready_;
+  std::vector<Ready>  round_;
+  std::vector<Timer>  timers_;   // Min-Heap nach (deadline, seq)
+  uint64_t            timer_seq_{0};
+  uint64_t            transactions_{0};
+  bool                stopping_{false};
+};
+
+} // namespace devices::coro
@@ -0,0 +1,158 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <core/device_base.hpp>
+#include <core/metric_bus.h>
+#include <core/metric.h>
+#include "clock.h"
+#include "modbus.h"
+#include "poll_policy.h"
+#include "register_block_cache.h"
+
+namespace devices {
+
+// Ein Gerät aus der Konfiguration
+struct DeviceSpec {
+  std::string              type;       // z.B. "wt901c"
+  std::string              bus;        // Name des physischen Busses (add_bus)
+  core::Metric::InstanceId instance{0};
+  std::vector<std::pair<std::string, std::string>> params;   // key=value
+
+  const std::string* param(const std::string& key) const;
+};
+
+// Was eine Factory vom physischen Bus eines Geräts bekommt
+struct BusContext {
+  IModbusClient& client;   // ggf. der RegisterBlockCache vor dem Bus
+  BusBudget*     budget;   // nullptr = kein Budget
+};
+
+// Baut Geräte aus einer Konfiguration und bringt sie beim Start online.
+//
+// Pro physischem Bus läuft ein Strang (Thread): er probt die Geräte dieses
+// Busses nacheinander (RS485 ist halbduplex) und pollt danach die bereits
+// antwortenden. Busse laufen parallel, start() kehrt sofort zurück. Ein
+// fehlendes Gerät kostet nur seinen eigenen Bus-Strang Zeit und wird im
+// Abstand probe_retry_ms weiter geprobt, bis es antwortet.
+class DeviceRegistry {
+public:
+  using Factory = std::function<std::unique_ptr<core::IDevice>(
+      core::MetricBus&, const DeviceSpec&, BusContext&, std::string* err)>;
+
+  enum class State : uint8_t {
+    Pending,   // noch nicht (erfolgreich) geprobt
+    Online,    // hat geantwortet, wird gepollt
+    Absent     // absent_after Fehlversuche; wird weiter geprobt
+  };
+
+  struct Config {
+    uint32_t probe_retry_ms{1000};
+    uint32_t absent_after{1};
+    uint32_t idle_ms{2};           // Pause eines Strangs zwischen zwei Runden
+    // > idle_ms: ein Strang schläft bis zum frühesten IDevice::next_due_ms()
+    // bzw. Probe-Termin seiner Geräte, höchstens max_idle_ms (Geräte ohne
+    // Termin: idle_ms). 0 = immer idle_ms.
+    uint32_t max_idle_ms{0};
+    // > 0: Geräte eines Busses lesen über einen gemeinsamen RegisterBlockCache
+    // mit dieser Frische (sollte unter dem kürzesten Poll-Intervall liegen)
+    uint32_t block_cache_max_age_ms{0};
+    // > 0: gemeinsames Transaktionsbudget pro Bus (für adaptive Geräte)
+    float    bus_budget_per_s{0.0f};
+    float    bus_budget_burst{8.0f};
+  };
+
+  struct DeviceStatus {
+    std::string              type;
+    std::string              bus;
+    core::Metric::InstanceId instance{0};
+    State                    state{State::Pending};
+    uint32_t                 probe_attempts{0};
+    uint64_t                 time_to_first_metric_ms{0};   // ab start(), nur bei Online
+  };
+
+  DeviceRegistry(core::MetricBus& bus, IClock& clock);
+  DeviceRegistry(core::MetricBus& bus, IClock& clock, Config cfg);
+  ~DeviceRegistry();
+
+  DeviceRegistry(const DeviceRegistry&)            = delete;
+  DeviceRegistry& operator=(const DeviceRegistry&) = delete;
+
+  // "wt901c" ist vorregistriert (Parameter: addr, reg, count, poll;
+  // adaptive=1 mit poll_min, poll_max, backoff_max in ms)
+  void register_type(const std::string& type, Factory f);
+  void add_bus(const std::string& name, IModbusClient& client);
+
+  // Baut das Gerät (ohne Bus-Zugriff). Nur vor start().
+  bool add(const DeviceSpec& spec, std::string* err = nullptr);
+
+  // Textformat, ein Gerät pro Zeile, '#' = Kommentar:
+  //   <type> <bus> <instance> [key=value ...]
+  // Bei Fehler: false, err enthält Zeile und Grund; es wird nichts hinzugefügt.
+  bool load_config(std::istream& in, std::string* err = nullptr);
+  bool load_file(const std::string& path, std::string* err = nullptr);
+  static bool parse_spec(const std::string& line, DeviceSpec& out, std::string* err = nullptr);
+
+  void start();
+  void stop();
+
+  // Wartet, bis jedes Gerät Online oder Absent ist; false bei Timeout
+  bool wait_settled(uint32_t timeout_ms);
+
+  std::size_t device_count() const noexcept { return entries_.size(); }
+  std::size_t online_count() const;
+  std::vector<DeviceStatus> report() const;
+  // nullptr, wenn der Bus unbekannt oder der Cache aus ist
+  RegisterBlockCache* block_cache(const std::string& bus_name);
+
+  static const char* to_string(State s);
+
+private:
+  struct Entry {
+    DeviceSpec                     spec;
+    std::unique_ptr<core::IDevice> dev;
+    std::atomic<State>             state{State::Pending};
+    std::atomic<uint32_t>          attempts{0};
+    std::atomic<uint64_t>          ttfm_ms{0};
+    uint64_t                       next_probe_ms{0};   // nur vom Strang benutzt
+  };
+
+  struct Strand {
+    IModbusClient*      client{nullptr};   // ggf. der Cache vor dem Bus
+    std::unique_ptr<RegisterBlockCache> cache;
+    std::unique_ptr<BusBudget>          budget;
+    std::vector<Entry*> devices;
+    std::thread         th;
+  };
+
+  bool build_(const DeviceSpec& spec, std::unique_ptr<core::IDevice>& out, std::string* err) const;
+  void run_strand_(Strand& s);
+  uint32_t sleep_ms_(const Strand& s) const;
+  void notify_();
+
+  core::MetricBus& bus_;
+  IClock&          clock_;
+  Config           cfg_;
+
+  std::map<std::string, Factory> factories_;
+  std::map<std::string, Strand>  strands_;
+  std::vector<std::unique_ptr<Entry>> entries_;
+
+  uint64_t                t_start_ms_{0};
+  std::atomic<bool>       running_{false};
+  mutable std::mutex      mtx_;
+  std::condition_variable cv_;
+};
+
+} // namespace devices
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+
+#include <core/enums.h>
+
+namespace devices {
+
+// Gemeinsames Transaktionsbudget eines physischen Busses (Token-Bucket).
+// Nicht thread-safe: ein Budget pro Bus-Strang.
+class BusBudget {
+public:
+  // rate_per_s Transaktionen/s im Mittel, burst = Eimergröße
+  BusBudget(float rate_per_s, float burst);
+
+  bool     try_acquire(uint64_t now_ms);
+  // Wartezeit bis zum nächsten Token (0 = sofort)
+  uint32_t ms_until_token(uint64_t now_ms);
+
+  uint64_t granted() const noexcept { return granted_; }
+  uint64_t denied()  const noexcept { return denied_; }
+
+private:
+  void refill_(uint64_t now_ms);
+
+  float    rate_per_ms_;
+  float    burst_;
+  float    tokens_;
+  uint64_t last_ms_{0};
+  bool     started_{false};
+  uint64_t granted_{0};
+  uint64_t denied_{0};
+};
+
+// Poll-Intervall, das sich an die beobachtete Änderungsrate anpasst:
+// bewegt sich der Wert (>= fast_rate_per_s), wird mit min_interval gepollt,
+// ist er stabil, wächst das Intervall schrittweise (growth) bis max_interval.
+// Lesefehler -> exponentielles Backoff mit Jitter; währenddessen liefert
+// quality() Uncertain, ab bad_after Fehlern in Folge Bad.
+class AdaptivePollPolicy {
+public:
+  struct Config {
+    uint32_t min_interval_ms{50};
+    uint32_t max_interval_ms{1000};
+    float    fast_rate_per_s{0.5f};   // Änderungsrate (Einheit/s), ab der schnell gepollt wird
+    float    growth{1.5f};            // Faktor pro stabilem Poll
+    uint32_t backoff_base_ms{100};
+    uint32_t backoff_max_ms{10000};
+    float    jitter{0.2f};            // +/- Anteil des Backoffs
+    uint32_t bad_after{3};            // Fehler in Folge bis Quality::Bad
+    uint32_t seed{0x9E3779B9u};
+  };
+
+  AdaptivePollPolicy();
+  explicit AdaptivePollPolicy(Config cfg);
+
+  bool due(uint64_t now_ms) const noexcept { return now_ms >= next_ms_; }
+  uint64_t next_due_ms() const noexcept { return next_ms_; }
+  uint32_t interval_ms() const noexcept { return interval_ms_; }
+  uint32_t failures() const noexcept { return failures_; }
+
+  void on_success(uint64_t now_ms, float value);
+  void on_failure(uint64_t now_ms);
+  // Poll nicht möglich (z.B. Busbudget erschöpft): später erneut, ohne Bewertung
+  void defer(uint64_t now_ms, uint32_t delay_ms);
+
+  core::Quality quality() const noexcept;
+
+private:
+  uint32_t next_random_() noexcept;
+
+  Config   cfg_;
+  uint32_t interval_ms_;
+  uint64_t next_ms_{0};
+  uint32_t failures_{0};
+  bool     have_last_{false};
+  float    last_value_{0.0f};
+  uint64_t last_ms_{0};
+  uint32_t rng_;
+};
+
+} // namespace devices
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <core/static_config.h>
+#include "clock.h"
+#include "modbus.h"
+
+namespace devices {
+
+// Register-Block-Cache vor einem IModbusClient.
+//
+// Mehrere logische Decoder auf demselben Slave (z.B. Winkel, Temperatur,
+// Beschleunigung beim WT901C) melden ihre Registerbereiche an. Überlappende
+// oder benachbarte Bereiche (Lücke <= max_gap) derselben Adresse werden zu
+// Blöcken zusammengefasst; pro Zyklus (max_age_ms) gibt es nur einen
+// Bulk-Read je Block, alle weiteren read_holding() innerhalb des Blocks
+// kommen aus dem Cache. Nicht angemeldete Bereiche gehen direkt durch
+// (mit learn = true werden sie für die folgenden Zyklen übernommen).
+class RegisterBlockCache : public IModbusClient {
+public:
+  struct Config {
+    uint32_t max_age_ms{20};   // so lange gilt ein Block als frisch
+    uint16_t max_gap{0};       // ungenutzte Register, die noch überbrückt werden
+    uint16_t max_block{125};   // Modbus-Limit für FC03 (statisches Profil: <= CARAVAN_MAX_REGS)
+    bool     learn{true};
+  };
+
+  struct Stats {
+    uint64_t requests{0};      // read_holding()-Aufrufe der Decoder
+    uint64_t transactions{0};  // tatsächliche Bus-Reads
+    uint64_t saved() const noexcept { return requests > transactions ? requests - transactions : 0; }
+  };
+
+  RegisterBlockCache(IModbusClient& inner, IClock& clock);
+  RegisterBlockCache(IModbusClient& inner, IClock& clock, Config cfg);
+
+  // Bereich anmelden; false bei n == 0, n > max_block oder (statisches
+  // Profil) mehr als CARAVAN_MAX_DEVICES Bereichen
+  bool add_range(uint8_t addr, uint16_t reg, uint16_t n);
+
+  bool read_holding(uint8_t addr, uint16_t reg, uint16_t n,
+                    ModbusRegs& out, uint32_t timeout_ms) override;
+
+  // Wie read_holding(), liefert zusätzlich den Zeitpunkt des Bulk-Reads
+  bool read_cached(uint8_t addr, uint16_t reg, uint16_t n,
+                   ModbusRegs& out, uint64_t& ts_ms, uint32_t timeout_ms);
+
+  // Alle Blöcke jetzt lesen (zyklischer Betrieb statt lazy); Anzahl Fehler
+  std::size_t refresh_all(uint32_t timeout_ms);
+
+  std::size_t block_count();
+  Stats stats() const;
+  // Stats seit dem letzten Aufruf (ein Poll-Zyklus) und zurücksetzen
+  Stats take_cycle_stats();
+
+private:
+  struct Range {
+    uint8_t  addr;
+    uint16_t reg;
+    uint16_t n;
+  };
+  struct Block {
+    uint8_t  addr{0};
+    uint16_t reg{0};
+    uint16_t n{0};
+    ModbusRegs data;
+    uint64_t ts_ms{0};       // letzter erfolgreicher Read
+    uint64_t fail_ms{0};     // letzter Fehlschlag (negativ gecacht)
+    bool     valid{false};
+    bool     failed{false};
+  };
+
+  void rebuild_();
+  Block* find_(uint8_t addr, uint16_t reg, uint16_t n);
+  bool fetch_(Block& b, uint64_t now, uint32_t timeout_ms);
+
+  IModbusClient& inner_;
+  IClock&        clock_;
+  Config         cfg_;
+
+  mutable std::mutex mtx_;
+#if CARAVAN_STATIC
+  core::StaticVector<Range, core::caps::kMaxDevices> ranges_;
+  core::StaticVector<Block, core::caps::kMaxDevices> blocks_;
+#else
+  std::vector<Range> ranges_;
+  std::vector<Block> blocks_;    // sortiert nach (addr, reg)
+#endif
+  bool               dirty_{false};
+  Stats              total_;
+  Stats              cycle_;
+};
+
+} // namespace devices
@@ -1,9 +1,11 @@
 #pragma once
 #include <cstdint>
 #include <functional>
+#include <optional>
 #include <vector>
 #include <memory>
 
+#include <core/calibration.h>
 #include <core/device_base.hpp>
 #include <core/metric.h>
 #include <core/enums.h>
@@ -11,6 +13,10 @@
 #include <core/spec_policy.h>
 #include "clock.h"
 #include "modbus.h"
+#include "poll_policy.h"
+#if CARAVAN_COROUTINES
+#include "coro.h"
+#endif
 
 namespace devices {
 
@@ -21,6 +27,13 @@ public:
     uint16_t start_reg{0};        // erster Holding-Register (wird vom Decoder interpretiert)
     uint16_t reg_count{4};        // Anzahl Register (minimal für Decoder)
     uint32_t poll_interval_ms{50};
+    // Winkel im 1. Register (int16): raw * 0.01 -> Grad
+    core::ChannelCalib angle{0.01f, 0.0f, -180.0f, 180.0f};
+    // adaptiv: Intervall aus der Änderungsrate, Backoff bei Fehlern
+    // (dann gilt poll_interval_ms nicht)
+    bool adaptive{false};
+    AdaptivePollPolicy::Config poll;
+    BusBudget* budget{nullptr};   // optional, gemeinsam für alle Geräte eines Busses
   };
 
   Wt901cDevice(core::MetricBus& bus,
@@ -29,14 +42,32 @@ public:
                Config cfg);
 
   void tick(uint64_t ts) override;
+  // Probe = erster regulärer Read; bei Erfolg ist die erste Metric schon publiziert
+  bool probe(uint64_t ts) override;
+  uint64_t next_due_ms() const override;
   bool read_once_and_publish(uint64_t ts);
 
+  const AdaptivePollPolicy& poll_policy() const noexcept { return policy_; }
+
+#if CARAVAN_COROUTINES
+  // Poll-Schleife als Koroutine statt tick(); endet nach Scheduler::stop().
+  // Das Gerät muss die Koroutine überleben.
+  coro::Task<> run(coro::Scheduler& sched);
+#endif
+
 private:
-  core::Metric mk_angle_metric_(float deg, uint64_t ts);
-  std::optional<float> decode (const std::vector<uint16_t>& data);
+  void tick_adaptive_(uint64_t ts);
+  bool acquire_budget_(uint64_t ts);
+  void on_adaptive_result_(bool ok, uint64_t ts);
+  bool publish_regs_(const ModbusRegs& regs, uint64_t ts);
+  core::Metric mk_angle_metric_(float deg, core::Quality q, uint64_t ts);
+  std::optional<float> decode (const ModbusRegs& data, core::Quality& q);
 
   IModbusClient& modbus_;
   Config         cfg_;
+  core::CalibrationTable calib_;
+  AdaptivePollPolicy     policy_;
+  std::optional<float>   last_angle_;
   uint64_t       last_poll_ms_{0};
   uint32_t       seq_{0};
 };
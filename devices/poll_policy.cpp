@@ -0,0 +1,97 @@
+#include "poll_policy.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace devices {
+
+BusBudget::BusBudget(float rate_per_s, float burst)
+: rate_per_ms_(rate_per_s / 1000.0f)
+, burst_(std::max(1.0f, burst))
+, tokens_(burst_)
+{}
+
+void BusBudget::refill_(uint64_t now_ms) {
+  if (!started_) { started_ = true; last_ms_ = now_ms; return; }
+  if (now_ms <= last_ms_) return;
+  tokens_  = std::min(burst_, tokens_ + static_cast<float>(now_ms - last_ms_) * rate_per_ms_);
+  last_ms_ = now_ms;
+}
+
+namespace {
+// Rundungsfehler beim Aufsummieren der Teil-Tokens tolerieren
+constexpr float kTokenEps = 1e-4f;
+} // namespace
+
+bool BusBudget::try_acquire(uint64_t now_ms) {
+  refill_(now_ms);
+  if (tokens_ + kTokenEps < 1.0f) { ++denied_; return false; }
+  tokens_ = std::max(0.0f, tokens_ - 1.0f);
+  ++granted_;
+  return true;
+}
+
+uint32_t BusBudget::ms_until_token(uint64_t now_ms) {
+  refill_(now_ms);
+  if (tokens_ + kTokenEps >= 1.0f) return 0;
+  if (rate_per_ms_ <= 0.0f) return UINT32_MAX;
+  return static_cast<uint32_t>(std::ceil((1.0f - tokens_) / rate_per_ms_));
+}
+
+AdaptivePollPolicy::AdaptivePollPolicy() : AdaptivePollPolicy(Config{}) {}
+
+AdaptivePollPolicy::AdaptivePollPolicy(Config cfg)
+: cfg_(cfg)
+, interval_ms_(cfg.min_interval_ms)
+, rng_(cfg.seed ? cfg.seed : 1u)
+{}
+
+uint32_t AdaptivePollPolicy::next_random_() noexcept {
+  // xorshift32
+  rng_ ^= rng_ << 13;
+  rng_ ^= rng_ >> 17;
+  rng_ ^= rng_ << 5;
+  return rng_;
+}
+
+void AdaptivePollPolicy::on_success(uint64_t now_ms, float value) {
+  failures_ = 0;
+  if (have_last_ && now_ms > last_ms_) {
+    const float rate = std::fabs(value - last_value_) * 1000.0f / static_cast<float>(now_ms - last_ms_);
+    if (rate >= cfg_.fast_rate_per_s) {
+      interval_ms_ = cfg_.min_interval_ms;
+    } else {
+      const float grown = static_cast<float>(interval_ms_) * cfg_.growth;
+      interval_ms_ = static_cast<uint32_t>(std::min(grown, static_cast<float>(cfg_.max_interval_ms)));
+      interval_ms_ = std::max(interval_ms_, cfg_.min_interval_ms);
+    }
+  }
+  have_last_  = true;
+  last_value_ = value;
+  last_ms_    = now_ms;
+  next_ms_    = now_ms + interval_ms_;
+}
+
+void AdaptivePollPolicy::on_failure(uint64_t now_ms) {
+  ++failures_;
+  const uint32_t shift = std::min<uint32_t>(failures_ - 1, 20);
+  const uint64_t base  = std::min<uint64_t>(uint64_t{cfg_.backoff_base_ms} << shift, cfg_.backoff_max_ms);
+  // Jitter gleichverteilt in [1 - jitter, 1 + jitter], damit Geräte auf
+  // demselben Bus nicht im Gleichtakt wiederholen
+  const float u = static_cast<float>(next_random_() >> 8) / static_cast<float>(1u << 24);
+  const float f = 1.0f - cfg_.jitter + 2.0f * cfg_.jitter * u;
+  next_ms_ = now_ms + static_cast<uint64_t>(static_cast<float>(base) * f);
+  // nach der Störung erst wieder schnell pollen
+  interval_ms_ = cfg_.min_interval_ms;
+}
+
+void AdaptivePollPolicy::defer(uint64_t now_ms, uint32_t delay_ms) {
+  next_ms_ = now_ms + std::max<uint32_t>(delay_ms, 1);
+}
+
+core::Quality AdaptivePollPolicy::quality() const noexcept {
+  if (failures_ == 0) return core::Quality::Good;
+  return failures_ >= cfg_.bad_after ? core::Quality::Bad : core::Quality::Uncertain;
+}
+
+} // namespace devices
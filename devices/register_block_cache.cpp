@@ -0,0 +1,151 @@
+#include "register_block_cache.h"
+
+#include <algorithm>
+
+#include <core/trace.h>
+
+namespace devices {
+
+RegisterBlockCache::RegisterBlockCache(IModbusClient& inner, IClock& clock)
+: RegisterBlockCache(inner, clock, Config{})
+{}
+
+RegisterBlockCache::RegisterBlockCache(IModbusClient& inner, IClock& clock, Config cfg)
+: inner_(inner), clock_(clock), cfg_(cfg)
+{
+  // ein Block muss in einen ModbusRegs-Puffer passen
+  if (cfg_.max_block > ModbusRegs().max_size()) cfg_.max_block = static_cast<uint16_t>(ModbusRegs().max_size());
+}
+
+bool RegisterBlockCache::add_range(uint8_t addr, uint16_t reg, uint16_t n) {
+  if (n == 0 || n > cfg_.max_block || uint32_t{reg} + n > 0x10000u) return false;
+  std::lock_guard<std::mutex> lk(mtx_);
+  for (auto& r : ranges_) {
+    if (r.addr == addr && r.reg == reg && r.n == n) return true;
+  }
+  if (ranges_.size() == ranges_.max_size()) return false;
+  ranges_.push_back(Range{addr, reg, n});
+  dirty_ = true;
+  return true;
+}
+
+void RegisterBlockCache::rebuild_() {
+  std::sort(ranges_.begin(), ranges_.end(), [](const Range& a, const Range& b) {
+    return a.addr != b.addr ? a.addr < b.addr : a.reg < b.reg;
+  });
+
+  blocks_.clear();
+  for (const Range& r : ranges_) {
+    const uint32_t r_end = uint32_t{r.reg} + r.n;
+    if (!blocks_.empty()) {
+      Block& b = blocks_.back();
+      const uint32_t b_end = uint32_t{b.reg} + b.n;
+      const uint32_t end   = std::max(b_end, r_end);
+      if (b.addr == r.addr && r.reg <= b_end + cfg_.max_gap && end - b.reg <= cfg_.max_block) {
+        b.n = static_cast<uint16_t>(end - b.reg);
+        continue;
+      }
+    }
+    Block nb;
+    nb.addr = r.addr;
+    nb.reg  = r.reg;
+    nb.n    = r.n;
+    blocks_.push_back(std::move(nb));
+  }
+  dirty_ = false;
+}
+
+RegisterBlockCache::Block* RegisterBlockCache::find_(uint8_t addr, uint16_t reg, uint16_t n) {
+  // letzter Block mit (addr, start) <= (addr, reg)
+  auto it = std::upper_bound(blocks_.begin(), blocks_.end(), std::make_pair(addr, reg),
+      [](const std::pair<uint8_t, uint16_t>& k, const Block& b) {
+        return k.first != b.addr ? k.first < b.addr : k.second < b.reg;
+      });
+  if (it == blocks_.begin()) return nullptr;
+  Block& b = *(it - 1);
+  if (b.addr != addr || uint32_t{reg} + n > uint32_t{b.reg} + b.n) return nullptr;
+  return &b;
+}
+
+bool RegisterBlockCache::fetch_(Block& b, uint64_t now, uint32_t timeout_ms) {
+  ++total_.transactions;
+  ++cycle_.transactions;
+  CARAVAN_TRACE_SCOPE_ARG("modbus.block_read", b.addr);
+  if (!inner_.read_holding(b.addr, b.reg, b.n, b.data, timeout_ms) || b.data.size() < b.n) {
+    // Fehlschlag bis max_age merken, damit nicht jeder Decoder erneut in
+    // den Timeout läuft
+    b.valid   = false;
+    b.failed  = true;
+    b.fail_ms = now;
+    return false;
+  }
+  b.valid  = true;
+  b.failed = false;
+  b.ts_ms  = now;
+  return true;
+}
+
+bool RegisterBlockCache::read_cached(uint8_t addr, uint16_t reg, uint16_t n,
+                                     ModbusRegs& out, uint64_t& ts_ms, uint32_t timeout_ms) {
+  std::lock_guard<std::mutex> lk(mtx_);
+  if (dirty_) rebuild_();
+  ++total_.requests;
+  ++cycle_.requests;
+  const uint64_t now = clock_.millis64();
+
+  Block* b = find_(addr, reg, n);
+  if (!b) {
+    ++total_.transactions;
+    ++cycle_.transactions;
+    if (cfg_.learn && n > 0 && n <= cfg_.max_block && ranges_.size() < ranges_.max_size()) {
+      ranges_.push_back(Range{addr, reg, n});
+      dirty_ = true;
+    }
+    ts_ms = now;
+    return inner_.read_holding(addr, reg, n, out, timeout_ms);
+  }
+
+  if (b->failed && now - b->fail_ms < cfg_.max_age_ms) return false;
+  if (!b->valid || now - b->ts_ms >= cfg_.max_age_ms) {
+    if (!fetch_(*b, now, timeout_ms)) return false;
+  }
+  const auto first = b->data.begin() + (reg - b->reg);
+  out.assign(first, first + n);
+  ts_ms = b->ts_ms;
+  return true;
+}
+
+bool RegisterBlockCache::read_holding(uint8_t addr, uint16_t reg, uint16_t n,
+                                      ModbusRegs& out, uint32_t timeout_ms) {
+  uint64_t ts = 0;
+  return read_cached(addr, reg, n, out, ts, timeout_ms);
+}
+
+std::size_t RegisterBlockCache::refresh_all(uint32_t timeout_ms) {
+  std::lock_guard<std::mutex> lk(mtx_);
+  if (dirty_) rebuild_();
+  const uint64_t now = clock_.millis64();
+  std::size_t failed = 0;
+  for (Block& b : blocks_) failed += !fetch_(b, now, timeout_ms);
+  return failed;
+}
+
+std::size_t RegisterBlockCache::block_count() {
+  std::lock_guard<std::mutex> lk(mtx_);
+  if (dirty_) rebuild_();
+  return blocks_.size();
+}
+
+RegisterBlockCache::Stats RegisterBlockCache::stats() const {
+  std::lock_guard<std::mutex> lk(mtx_);
+  return total_;
+}
+
+RegisterBlockCache::Stats RegisterBlockCache::take_cycle_stats() {
+  std::lock_guard<std::mutex> lk(mtx_);
+  Stats s = cycle_;
+  cycle_  = Stats{};
+  return s;
+}
+
+} // namespace devices
@@ -1,6 +1,8 @@
 #include "tilt_wt901c.h"
 #include <utility>
 
+#include <core/trace.h>
+
 using namespace core;
 
 namespace devices {
@@ -12,39 +14,94 @@ Wt901cDevice::Wt901cDevice(MetricBus& bus,
 : DeviceBase<TiltUnitTag>(bus, instance_id)
 , modbus_(modbus)
 , cfg_(cfg)
-{}
+, calib_(1)
+, policy_(cfg.poll)
+{
+  calib_.set(0, cfg_.angle);
+}
 
 void Wt901cDevice::tick(uint64_t ts) {
+  CARAVAN_TRACE_SCOPE_ARG("wt901c.tick", id_);
+  if (cfg_.adaptive) { tick_adaptive_(ts); return; }
   if (ts - last_poll_ms_ < cfg_.poll_interval_ms) return;
   last_poll_ms_ = ts;
   (void)read_once_and_publish(ts);
 }
 
+uint64_t Wt901cDevice::next_due_ms() const {
+  return cfg_.adaptive ? policy_.next_due_ms() : last_poll_ms_ + cfg_.poll_interval_ms;
+}
+
+void Wt901cDevice::tick_adaptive_(uint64_t ts) {
+  if (!policy_.due(ts)) return;
+  if (!acquire_budget_(ts)) return;
+  last_poll_ms_ = ts;
+  on_adaptive_result_(read_once_and_publish(ts), ts);
+}
+
+bool Wt901cDevice::acquire_budget_(uint64_t ts) {
+  if (!cfg_.budget || cfg_.budget->try_acquire(ts)) return true;
+  policy_.defer(ts, cfg_.budget->ms_until_token(ts));
+  return false;
+}
+
+void Wt901cDevice::on_adaptive_result_(bool ok, uint64_t ts) {
+  if (ok) {
+    policy_.on_success(ts, *last_angle_);
+    return;
+  }
+  policy_.on_failure(ts);
+  // während des Backoffs den letzten Wert mit abgewerteter Quality melden
+  if (last_angle_) publish<MetricID::TiltAngle>(mk_angle_metric_(*last_angle_, policy_.quality(), ts));
+}
+
+bool Wt901cDevice::probe(uint64_t ts) {
+  if (!read_once_and_publish(ts)) return false;
+  last_poll_ms_ = ts;
+  if (cfg_.adaptive) policy_.on_success(ts, *last_angle_);
+  return true;
+}
+
 bool Wt901cDevice::read_once_and_publish(uint64_t ts) {
-  std::vector<uint16_t> regs;
-  if (!modbus_.read_holding(cfg_.modbus_addr, cfg_.start_reg, cfg_.reg_count, regs, /*timeout_ms*/20)) {
-    return false;
+  ModbusRegs regs;
+  {
+    CARAVAN_TRACE_SCOPE_ARG("modbus.read_holding", cfg_.modbus_addr);
+    if (!modbus_.read_holding(cfg_.modbus_addr, cfg_.start_reg, cfg_.reg_count, regs, /*timeout_ms*/20)) {
+      return false;
+    }
+  }
+  return publish_regs_(regs, ts);
+}
+
+bool Wt901cDevice::publish_regs_(const ModbusRegs& regs, uint64_t ts) {
+  Quality q = Quality::Good;
+  std::optional<float> angle_opt;
+  {
+    CARAVAN_TRACE_SCOPE("wt901c.decode");
+    angle_opt = decode(regs, q);
   }
-  auto angle_opt = decode(regs);
   if (!angle_opt.has_value()) return false;
 
-  auto m = mk_angle_metric_(*angle_opt, ts);
+  last_angle_ = *angle_opt;
+  auto m = mk_angle_metric_(*angle_opt, q, ts);
 
   publish<MetricID::TiltAngle>(std::move(m));
   return true;
 }
 
-std::optional<float> Wt901cDevice::decode(const std::vector<uint16_t>& data) {
-  if (data.size() < 4) return std::nullopt;
-  // Beispielhafte Dekodierung: Wir nehmen an, dass der Neigungswinkel im 2. Register gespeichert ist
-  float angle = static_cast<float>(data[1]) * 0.1f; // Umrechnung in Grad
+std::optional<float> Wt901cDevice::decode(const ModbusRegs& data, Quality& q) {
+  // kurzer Read -> verwerfen
+  if (data.empty() || data.size() < cfg_.reg_count) return std::nullopt;
+  // Neigungswinkel im 1. Register (int16), Umrechnung über den gemeinsamen Kalibrierpfad
+  float angle = 0.0f;
+  calib_.apply(reinterpret_cast<const int16_t*>(data.data()), &angle, &q);
   return angle;
 }
 
-Metric Wt901cDevice::mk_angle_metric_(float deg, uint64_t ts) {
+Metric Wt901cDevice::mk_angle_metric_(float deg, Quality q, uint64_t ts) {
   Metric::PropMap p;
   p.emplace(PropertyKey::Unit,    static_cast<uint8_t>(Unit::Degree));
-  p.emplace(PropertyKey::Quality, static_cast<uint8_t>(Quality::Good));
+  p.emplace(PropertyKey::Quality, static_cast<uint8_t>(q));
   return Metric::Make(
       /*instance*/ id_,
       /*metric*/   MetricID::TiltAngle,
@@ -0,0 +1,28 @@
+#include "tilt_wt901c.h"
+
+namespace devices {
+
+// gleiche Logik wie tick()/tick_adaptive_, nur als Schleife: die Wartezeit
+// bis zum nächsten Poll ist ein Timer statt eines Vergleichs pro Tick
+coro::Task<> Wt901cDevice::run(coro::Scheduler& sched) {
+  ModbusRegs regs;
+  while (!sched.stopping()) {
+    const uint64_t ts = sched.now_ms();
+    if (cfg_.adaptive && !acquire_budget_(ts)) {
+      co_await sched.sleep_until(policy_.next_due_ms());
+      continue;
+    }
+    const bool read_ok = co_await sched.read_holding(modbus_, cfg_.modbus_addr, cfg_.start_reg,
+                                                     cfg_.reg_count, regs, /*timeout_ms*/20);
+    const bool ok = read_ok && publish_regs_(regs, ts);
+    last_poll_ms_ = ts;
+    if (cfg_.adaptive) {
+      on_adaptive_result_(ok, ts);
+      co_await sched.sleep_until(policy_.next_due_ms());
+    } else {
+      co_await sched.sleep_until(ts + cfg_.poll_interval_ms);
+    }
+  }
+}
+
+} // namespace devices
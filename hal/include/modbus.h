@@ -2,11 +2,22 @@
 #include <cstdint>
 #include <memory>
 #include <vector>
+
+#if CARAVAN_STATIC
+#include <core/static_config.h>
+#include <core/static_vector.h>
+// Register-Puffer fester Größe (CARAVAN_MAX_REGS); größere Reads schlagen fehl
+using ModbusRegs = core::StaticVector<uint16_t, core::caps::kMaxRegs>;
+#else
+using ModbusRegs = std::vector<uint16_t>;
+#endif
+
 struct IModbusClient {
   virtual ~IModbusClient() = default;
+  // n > out.max_size() -> false
   virtual bool read_holding(uint8_t addr, uint16_t reg, uint16_t n,
-                            std::vector<uint16_t>& out, uint32_t timeout_ms) = 0;
+                            ModbusRegs& out, uint32_t timeout_ms) = 0;
 };
 
 // Provide a factory function
-std::unique_ptr<IModbusClient> hal_make_modbus();
\ No newline at end of file
+std::unique_ptr<IModbusClient> hal_make_modbus();
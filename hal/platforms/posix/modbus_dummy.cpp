@@ -4,7 +4,8 @@
 class DummyModbus : public IModbusClient {
 public:
   bool read_holding(uint8_t, uint16_t, uint16_t n,
-                    std::vector<uint16_t>& out, uint32_t) override {
+                    ModbusRegs& out, uint32_t) override {
+    if (n > out.max_size()) return false;
     out.resize(n);
     // Fill with deterministic pseudo-values
     for (uint16_t i = 0; i < n; ++i) out[i] = static_cast<uint16_t>(i * 10u);
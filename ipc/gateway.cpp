@@ -0,0 +1,421 @@
+#include "ipc/gateway.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace core;
+
+namespace ipc {
+
+namespace {
+
+constexpr std::size_t kRecordBytes = sizeof(MetricRecord);
+
+uint64_t now_ns() {
+  using namespace std::chrono;
+  return static_cast<uint64_t>(
+      duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+inline uint64_t key_of(const MetricRecord& r) noexcept {
+  return (static_cast<uint64_t>(r.metric_id) << 32) | r.instance_id;
+}
+
+bool fail(std::string* err, const char* what) {
+  if (err) *err = std::string(what) + ": " + std::strerror(errno);
+  return false;
+}
+
+} // namespace
+
+namespace proto {
+
+std::vector<uint8_t> encode_filter(const std::vector<FilterEntry>& entries) {
+  FilterHeader h{kFilterMagic, static_cast<uint32_t>(entries.size())};
+  std::vector<uint8_t> buf(sizeof(h) + entries.size() * sizeof(FilterEntry));
+  std::memcpy(buf.data(), &h, sizeof(h));
+  if (!entries.empty())
+    std::memcpy(buf.data() + sizeof(h), entries.data(), entries.size() * sizeof(FilterEntry));
+  return buf;
+}
+
+} // namespace proto
+
+struct Gateway::Client {
+  int fd{-1};
+  std::vector<proto::FilterEntry> filter;
+  std::vector<uint8_t>            in;
+  // gebündelte, noch nicht gerahmte Records
+  std::vector<MetricRecord>              pending;
+  std::unordered_map<uint64_t, uint32_t> pending_idx;   // nur beim Conflating gepflegt
+  uint64_t                               pending_since_ns{0};
+  // gerahmte Bytes, die der Socket noch nicht genommen hat
+  std::vector<uint8_t> out;
+  std::size_t          out_off{0};
+  bool                 want_write{false};
+  bool                 doomed{false};
+
+  bool congested() const noexcept { return out_off < out.size(); }
+  std::size_t buffered() const noexcept { return (out.size() - out_off) + pending.size() * kRecordBytes; }
+};
+
+Gateway::Gateway(MetricBus& bus, Config cfg) : bus_(bus), cfg_(std::move(cfg)) {}
+
+Gateway::~Gateway() {
+  sub_.unsubscribe();
+  for (auto& [fd, c] : clients_) ::close(fd);
+  clients_.clear();
+  if (unix_fd_ >= 0) { ::close(unix_fd_); ::unlink(cfg_.unix_path.c_str()); }
+  if (tcp_fd_  >= 0) ::close(tcp_fd_);
+  if (wake_fd_ >= 0) ::close(wake_fd_);
+  if (epfd_    >= 0) ::close(epfd_);
+}
+
+bool Gateway::start(std::string* err) {
+  epfd_ = ::epoll_create1(EPOLL_CLOEXEC);
+  if (epfd_ < 0) return fail(err, "epoll_create1");
+  wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wake_fd_ < 0) return fail(err, "eventfd");
+
+  epoll_event ev{};
+  ev.events  = EPOLLIN;
+  ev.data.fd = wake_fd_;
+  ::epoll_ctl(epfd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+
+  if (!cfg_.unix_path.empty()) {
+    unix_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (unix_fd_ < 0) return fail(err, "socket(AF_UNIX)");
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (cfg_.unix_path.size() >= sizeof(addr.sun_path)) {
+      if (err) *err = "unix path too long";
+      return false;
+    }
+    std::strncpy(addr.sun_path, cfg_.unix_path.c_str(), sizeof(addr.sun_path) - 1);
+    ::unlink(cfg_.unix_path.c_str());
+    if (::bind(unix_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) return fail(err, "bind(unix)");
+    if (::listen(unix_fd_, 128) != 0) return fail(err, "listen(unix)");
+    ev.data.fd = unix_fd_;
+    ::epoll_ctl(epfd_, EPOLL_CTL_ADD, unix_fd_, &ev);
+  }
+
+  if (cfg_.tcp) {
+    tcp_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (tcp_fd_ < 0) return fail(err, "socket(AF_INET)");
+    const int one = 1;
+    ::setsockopt(tcp_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons(cfg_.tcp_port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);   // nur lokal
+    if (::bind(tcp_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) return fail(err, "bind(tcp)");
+    if (::listen(tcp_fd_, 128) != 0) return fail(err, "listen(tcp)");
+    socklen_t len = sizeof(addr);
+    ::getsockname(tcp_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+    bound_tcp_port_ = ntohs(addr.sin_port);
+    ev.data.fd = tcp_fd_;
+    ::epoll_ctl(epfd_, EPOLL_CTL_ADD, tcp_fd_, &ev);
+  }
+
+  running_.store(true);
+  sub_ = bus_.subscribe([this](const Metric& m) { on_bus_(m); });
+  return true;
+}
+
+void Gateway::on_bus_(const Metric& m) {
+  const MetricRecord r = to_record(m);
+  bool wake;
+  {
+    std::lock_guard<std::mutex> lk(inbox_mtx_);
+    wake = inbox_.empty();
+    if (cfg_.max_inbox && inbox_.size() >= cfg_.max_inbox && !high_(r)) {
+      // Gateway-Thread kommt nicht nach: konflatieren wie bei langsamen Clients
+      if (inbox_idx_.empty()) {
+        for (uint32_t i = 0; i < inbox_.size(); ++i)
+          if (!high_(inbox_[i])) inbox_idx_[key_of(inbox_[i])] = i;
+      }
+      auto it = inbox_idx_.find(key_of(r));
+      if (it != inbox_idx_.end()) {
+        inbox_[it->second] = r;
+        ++inbox_conflated_;
+      } else {
+        ++inbox_dropped_;
+      }
+      return;   // Inbox nicht leer, Gateway ist schon geweckt
+    }
+    inbox_.push_back(r);
+  }
+  if (wake) {
+    const uint64_t one = 1;
+    (void)!::write(wake_fd_, &one, sizeof(one));
+  }
+}
+
+void Gateway::stop() {
+  running_.store(false);
+  const uint64_t one = 1;
+  if (wake_fd_ >= 0) (void)!::write(wake_fd_, &one, sizeof(one));
+}
+
+void Gateway::run() {
+  while (running_.load()) run_once(1000);
+}
+
+Gateway::Stats Gateway::stats() const {
+  Stats st;
+  {
+    std::lock_guard<std::mutex> lk(stats_mtx_);
+    st = stats_;
+  }
+  std::lock_guard<std::mutex> lk(inbox_mtx_);
+  st.inbox_conflated = inbox_conflated_;
+  st.inbox_dropped   = inbox_dropped_;
+  return st;
+}
+
+int Gateway::next_timeout_ms_(int timeout_ms, uint64_t now) const {
+  const uint64_t cap_ns = uint64_t{cfg_.max_latency_ms} * 1'000'000u;
+  for (auto const& [fd, c] : clients_) {
+    if (c->pending.empty() || c->congested()) continue;
+    const uint64_t due  = c->pending_since_ns + cap_ns;
+    const uint64_t wait = due > now ? due - now : 0;
+    const int ms = static_cast<int>((wait + 999'999u) / 1'000'000u);
+    if (timeout_ms < 0 || ms < timeout_ms) timeout_ms = ms;
+  }
+  return timeout_ms;
+}
+
+void Gateway::run_once(int timeout_ms) {
+  epoll_event events[64];
+  const int n = ::epoll_wait(epfd_, events, 64, next_timeout_ms_(timeout_ms, now_ns()));
+
+  for (int i = 0; i < n; ++i) {
+    const int fd = events[i].data.fd;
+    if (fd == wake_fd_) {
+      uint64_t v;
+      (void)!::read(wake_fd_, &v, sizeof(v));
+      continue;
+    }
+    if (fd == unix_fd_ || fd == tcp_fd_) { accept_(fd); continue; }
+
+    auto it = clients_.find(fd);
+    if (it == clients_.end()) continue;
+    Client& c = *it->second;
+    if (events[i].events & (EPOLLERR | EPOLLHUP)) { c.doomed = true; continue; }
+    if (events[i].events & EPOLLIN)  on_readable_(c);
+    if (events[i].events & EPOLLOUT) on_writable_(c);
+  }
+
+  route_inbox_();
+  flush_due_(now_ns());
+
+  // geschlossene/zu langsame Clients erst hier entfernen (keine Iteratoren offen)
+  std::vector<int> dead;
+  for (auto const& [fd, c] : clients_) if (c->doomed) dead.push_back(fd);
+  for (int fd : dead) close_(fd);
+}
+
+void Gateway::accept_(int listen_fd) {
+  for (;;) {
+    const int fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) return;   // EAGAIN oder Fehler
+    if (clients_.size() >= cfg_.max_clients) {
+      ::close(fd);
+      std::lock_guard<std::mutex> lk(stats_mtx_);
+      ++stats_.rejected;
+      continue;
+    }
+    if (listen_fd == tcp_fd_) {
+      // Bündelung macht das Gateway selbst
+      const int one = 1;
+      ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    epoll_event ev{};
+    ev.events  = EPOLLIN;
+    ev.data.fd = fd;
+    ::epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev);
+
+    auto c = std::make_unique<Client>();
+    c->fd = fd;
+    clients_.emplace(fd, std::move(c));
+
+    std::lock_guard<std::mutex> lk(stats_mtx_);
+    ++stats_.accepted;
+    stats_.clients = clients_.size();
+  }
+}
+
+void Gateway::on_readable_(Client& c) {
+  uint8_t buf[4096];
+  for (;;) {
+    const ssize_t r = ::recv(c.fd, buf, sizeof(buf), 0);
+    if (r > 0) { c.in.insert(c.in.end(), buf, buf + r); continue; }
+    if (r == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) { c.doomed = true; return; }
+    if (errno == EINTR) continue;
+    break;
+  }
+
+  // vollständige Filter-Frames übernehmen
+  std::size_t off = 0;
+  while (c.in.size() - off >= sizeof(proto::FilterHeader)) {
+    proto::FilterHeader h;
+    std::memcpy(&h, c.in.data() + off, sizeof(h));
+    if (h.magic != proto::kFilterMagic || h.count > proto::kMaxFilterEntries) { c.doomed = true; return; }
+    const std::size_t need = sizeof(h) + h.count * sizeof(proto::FilterEntry);
+    if (c.in.size() - off < need) break;
+    c.filter.resize(h.count);
+    if (h.count)
+      std::memcpy(c.filter.data(), c.in.data() + off + sizeof(h), h.count * sizeof(proto::FilterEntry));
+    off += need;
+  }
+  c.in.erase(c.in.begin(), c.in.begin() + static_cast<std::ptrdiff_t>(off));
+}
+
+void Gateway::on_writable_(Client& c) {
+  if (!send_(c)) { c.doomed = true; return; }
+  if (!c.congested() && !c.pending.empty()) {
+    // aufgestaute (ggf. konflatierte) Werte sofort hinterher
+    if (!frame_and_send_(c)) c.doomed = true;
+  }
+}
+
+void Gateway::route_inbox_() {
+  {
+    std::lock_guard<std::mutex> lk(inbox_mtx_);
+    work_.swap(inbox_);
+    inbox_idx_.clear();
+  }
+  if (work_.empty()) return;
+
+  for (auto const& r : work_) {
+    for (auto& [fd, c] : clients_) {
+      if (c->doomed) continue;
+      for (auto const& f : c->filter) {
+        if (proto::matches(f, r)) { enqueue_(*c, r); break; }
+      }
+    }
+  }
+  work_.clear();
+}
+
+void Gateway::enqueue_(Client& c, const MetricRecord& r) {
+  const std::size_t after = c.buffered() + kRecordBytes;
+  if (high_(r)) {
+    // jede Flanke zählt: immer anhängen, unabhängig von Puffergrenze und Policy
+    if (c.pending.empty()) c.pending_since_ns = now_ns();
+    c.pending.push_back(r);
+    return;
+  }
+  if (after <= cfg_.out_buffer_bytes && c.pending_idx.empty()) {
+    if (c.pending.empty()) c.pending_since_ns = now_ns();
+    c.pending.push_back(r);
+    return;
+  }
+
+  if (cfg_.slow == SlowClientPolicy::Disconnect && after > cfg_.out_buffer_bytes) {
+    c.doomed = true;
+    std::lock_guard<std::mutex> lk(stats_mtx_);
+    ++stats_.slow_disconnects;
+    return;
+  }
+
+  // Conflate: neuester Wert pro Schlüssel ersetzt den wartenden
+  if (c.pending_idx.empty()) {
+    for (uint32_t i = 0; i < c.pending.size(); ++i)
+      if (!high_(c.pending[i])) c.pending_idx[key_of(c.pending[i])] = i;
+  }
+  auto it = c.pending_idx.find(key_of(r));
+  if (it != c.pending_idx.end()) {
+    c.pending[it->second] = r;
+    std::lock_guard<std::mutex> lk(stats_mtx_);
+    ++stats_.conflated;
+    return;
+  }
+  // neuer Schlüssel: doppelte Grenze als harte Schranke
+  if (after > 2 * cfg_.out_buffer_bytes) {
+    c.doomed = true;
+    std::lock_guard<std::mutex> lk(stats_mtx_);
+    ++stats_.slow_disconnects;
+    return;
+  }
+  if (c.pending.empty()) c.pending_since_ns = now_ns();
+  c.pending_idx[key_of(r)] = static_cast<uint32_t>(c.pending.size());
+  c.pending.push_back(r);
+}
+
+void Gateway::flush_due_(uint64_t now) {
+  const uint64_t cap_ns = uint64_t{cfg_.max_latency_ms} * 1'000'000u;
+  for (auto& [fd, c] : clients_) {
+    if (c->doomed || c->pending.empty() || c->congested()) continue;
+    const bool full = c->pending.size() * kRecordBytes >= cfg_.batch_bytes;
+    const bool old  = now - c->pending_since_ns >= cap_ns;
+    if ((full || old) && !frame_and_send_(*c)) c->doomed = true;
+  }
+}
+
+bool Gateway::frame_and_send_(Client& c) {
+  const proto::BatchHeader h{proto::kBatchMagic, static_cast<uint32_t>(c.pending.size())};
+  c.out.resize(sizeof(h) + c.pending.size() * kRecordBytes);
+  c.out_off = 0;
+  std::memcpy(c.out.data(), &h, sizeof(h));
+  std::memcpy(c.out.data() + sizeof(h), c.pending.data(), c.pending.size() * kRecordBytes);
+  {
+    std::lock_guard<std::mutex> lk(stats_mtx_);
+    ++stats_.frames_sent;
+    stats_.records_sent += c.pending.size();
+  }
+  c.pending.clear();
+  c.pending_idx.clear();
+  return send_(c);
+}
+
+bool Gateway::send_(Client& c) {
+  while (c.congested()) {
+    const ssize_t w = ::send(c.fd, c.out.data() + c.out_off, c.out.size() - c.out_off, MSG_NOSIGNAL);
+    if (w > 0) { c.out_off += static_cast<std::size_t>(w); continue; }
+    if (w < 0 && errno == EINTR) continue;
+    if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      if (!c.want_write) {
+        epoll_event ev{};
+        ev.events  = EPOLLIN | EPOLLOUT;
+        ev.data.fd = c.fd;
+        ::epoll_ctl(epfd_, EPOLL_CTL_MOD, c.fd, &ev);
+        c.want_write = true;
+      }
+      return true;
+    }
+    return false;
+  }
+  c.out.clear();
+  c.out_off = 0;
+  if (c.want_write) {
+    epoll_event ev{};
+    ev.events  = EPOLLIN;
+    ev.data.fd = c.fd;
+    ::epoll_ctl(epfd_, EPOLL_CTL_MOD, c.fd, &ev);
+    c.want_write = false;
+  }
+  return true;
+}
+
+void Gateway::close_(int fd) {
+  ::epoll_ctl(epfd_, EPOLL_CTL_DEL, fd, nullptr);
+  ::close(fd);
+  clients_.erase(fd);
+  std::lock_guard<std::mutex> lk(stats_mtx_);
+  stats_.clients = clients_.size();
+}
+
+} // namespace ipc
@@ -0,0 +1,159 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <core/metric_bus.h>
+#include <core/metric_record.h>
+#include <core/priority_lanes.h>
+#include <core/ids.h>
+
+namespace ipc {
+
+// Binärprotokoll (Host-Byteorder, nur lokal: Unix-Socket / Loopback-TCP)
+//
+// Client -> Gateway: Filter-Frame, ersetzt den bisherigen Filter.
+//   FilterHeader{magic = kFilterMagic, count} + count * FilterEntry
+//   Ohne Filter bekommt ein Client nichts.
+// Gateway -> Client: Batch-Frame
+//   BatchHeader{magic = kBatchMagic, count} + count * core::MetricRecord
+namespace proto {
+
+constexpr uint32_t kFilterMagic = 0x46535643;   // "CVSF"
+constexpr uint32_t kBatchMagic  = 0x42535643;   // "CVSB"
+constexpr uint16_t kAnyMetric   = 0;
+constexpr uint32_t kAnyInstance = 0xFFFFFFFFu;
+constexpr uint32_t kMaxFilterEntries = 256;
+
+struct FilterHeader {
+  uint32_t magic;
+  uint32_t count;
+};
+
+struct FilterEntry {
+  uint16_t metric_id;     // kAnyMetric = alle
+  uint16_t reserved;
+  uint32_t instance_id;   // kAnyInstance = alle
+};
+
+struct BatchHeader {
+  uint32_t magic;
+  uint32_t count;
+};
+
+static_assert(sizeof(FilterHeader) == 8 && sizeof(FilterEntry) == 8 && sizeof(BatchHeader) == 8,
+              "wire structs must be packed");
+
+std::vector<uint8_t> encode_filter(const std::vector<FilterEntry>& entries);
+
+inline bool matches(const FilterEntry& f, const core::MetricRecord& r) noexcept {
+  return (f.metric_id == kAnyMetric || f.metric_id == r.metric_id)
+      && (f.instance_id == kAnyInstance || f.instance_id == r.instance_id);
+}
+
+} // namespace proto
+
+// Ereignisgetriebenes Gateway (epoll, ein Thread) für Unix-Domain- und
+// Loopback-TCP-Clients. Metriken vom Bus landen in einer Inbox und werden im
+// Gateway-Thread pro Client gefiltert, gebündelt und nicht-blockierend
+// gesendet.
+class Gateway {
+public:
+  enum class SlowClientPolicy : uint8_t {
+    Disconnect,   // Puffergrenze überschritten -> Verbindung schließen
+    Conflate      // nur noch den neuesten Wert pro (metric, instance) halten
+  };
+
+  struct Config {
+    std::string      unix_path;                 // leer = aus
+    bool             tcp{false};
+    uint16_t         tcp_port{0};               // 0 = ephemeral (siehe tcp_port())
+    std::size_t      max_clients{512};
+    std::size_t      out_buffer_bytes{256 * 1024};
+    SlowClientPolicy slow{SlowClientPolicy::Conflate};
+    std::size_t      batch_bytes{16 * 1024};    // Frame senden, sobald so viel ansteht ...
+    uint32_t         max_latency_ms{10};        // ... oder der älteste Record so alt ist
+    // Records zwischen Bus und Gateway-Thread (0 = unbegrenzt); darüber nur
+    // noch den neuesten Wert pro (metric, instance), neue Schlüssel verwerfen
+    std::size_t      max_inbox{64 * 1024};
+    // Priority::High (Default: Health, Alarme) ist von allen Grenzen
+    // ausgenommen: nie konflatiert, verworfen oder Anlass zum Trennen
+    core::LaneMap    lanes{};
+  };
+
+  struct Stats {
+    uint64_t accepted{0};
+    uint64_t rejected{0};          // max_clients erreicht
+    uint64_t frames_sent{0};
+    uint64_t records_sent{0};
+    uint64_t conflated{0};         // durch neueren Wert ersetzt
+    uint64_t slow_disconnects{0};
+    uint64_t inbox_conflated{0};   // Inbox voll, durch neueren Wert ersetzt
+    uint64_t inbox_dropped{0};     // Inbox voll, neuer Schlüssel verworfen (nie High)
+    std::size_t clients{0};
+  };
+
+  Gateway(core::MetricBus& bus, Config cfg);
+  ~Gateway();
+
+  Gateway(const Gateway&)            = delete;
+  Gateway& operator=(const Gateway&) = delete;
+
+  // Sockets, epoll und Bus-Subscription einrichten; false + err bei Fehler
+  bool start(std::string* err = nullptr);
+
+  // Eine Runde der Event-Loop (wartet höchstens timeout_ms)
+  void run_once(int timeout_ms);
+  // Läuft bis stop() (aus beliebigem Thread)
+  void run();
+  void stop();
+
+  uint16_t tcp_port() const noexcept { return bound_tcp_port_; }
+  Stats    stats() const;
+
+private:
+  struct Client;
+
+  void on_bus_(const core::Metric& m);
+  void accept_(int listen_fd);
+  void on_readable_(Client& c);
+  void on_writable_(Client& c);
+  void route_inbox_();
+  void enqueue_(Client& c, const core::MetricRecord& r);
+  bool high_(const core::MetricRecord& r) const noexcept {
+    return cfg_.lanes.lane_of(static_cast<core::MetricID>(r.metric_id)) == core::Priority::High;
+  }
+  void flush_due_(uint64_t now_ns);
+  bool frame_and_send_(Client& c);
+  bool send_(Client& c);
+  void close_(int fd);
+  int  next_timeout_ms_(int timeout_ms, uint64_t now_ns) const;
+
+  core::MetricBus& bus_;
+  Config           cfg_;
+  int              epfd_{-1};
+  int              unix_fd_{-1};
+  int              tcp_fd_{-1};
+  int              wake_fd_{-1};
+  uint16_t         bound_tcp_port_{0};
+  std::atomic<bool> running_{false};
+
+  mutable std::mutex              inbox_mtx_;
+  std::vector<core::MetricRecord> inbox_;
+  std::unordered_map<uint64_t, uint32_t> inbox_idx_;   // erst ab max_inbox
+  uint64_t                        inbox_conflated_{0};
+  uint64_t                        inbox_dropped_{0};
+  std::vector<core::MetricRecord> work_;
+
+  std::unordered_map<int, std::unique_ptr<Client>> clients_;
+  mutable std::mutex stats_mtx_;
+  Stats              stats_;
+  core::Subscription sub_;
+};
+
+} // namespace ipc
@@ -0,0 +1,131 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <core/metric_bus.h>
+#include <core/metric_record.h>
+
+namespace ipc {
+
+// Layout des POSIX-Shared-Memory-Rings (Linux).
+// Ein Ring aus `capacity` Slots (Zweierpotenz), jeder Slot mit eigener
+// Sequenznummer (Seqlock). Schreiber reservieren Positionen per fetch_add,
+// Leser lesen ohne Locks und erkennen Überholen an der Sequenznummer.
+namespace shm {
+
+constexpr uint32_t kMagic   = 0x43564D42;  // "CVMB"
+constexpr uint32_t kVersion = 1;
+
+struct Header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t record_size;
+  uint32_t capacity;
+  alignas(64) std::atomic<uint64_t> write_seq;   // Anzahl reservierter Records
+};
+
+struct Slot {
+  std::atomic<uint64_t> seq;   // Record-Index + 1, wenn fertig geschrieben; 0 = in Arbeit
+  core::MetricRecord    rec;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shm ring needs lock-free 64-bit atomics");
+
+} // namespace shm
+
+// Spiegelt einen MetricBus in ein Shared-Memory-Segment (/dev/shm/<name>).
+// Besitzt das Segment und entfernt es im Destructor (nur, solange der Name
+// noch auf dieses Segment zeigt). Ein ShmBridgeWriter pro Segment.
+class ShmBridgeWriter {
+public:
+  enum class Create : uint8_t {
+    Exclusive,   // Fehler, wenn das Segment schon existiert (Schreiber läuft noch?)
+    Takeover     // vorhandenes Segment entfernen und neu anlegen; Leser des alten
+                 // Segments sehen keine neuen Records mehr und müssen neu öffnen
+  };
+
+  // capacity wird auf die nächste Zweierpotenz aufgerundet.
+  // nullptr bei Fehler, err enthält den Grund.
+  static std::unique_ptr<ShmBridgeWriter> create(core::MetricBus& bus, const std::string& name,
+                                                 std::size_t capacity, std::string* err = nullptr,
+                                                 Create mode = Create::Exclusive);
+  ~ShmBridgeWriter();
+
+  ShmBridgeWriter(const ShmBridgeWriter&)            = delete;
+  ShmBridgeWriter& operator=(const ShmBridgeWriter&) = delete;
+
+  // Direkt schreiben (ohne Bus); thread-safe, lock-frei
+  void write(const core::Metric& m) noexcept;
+
+  uint64_t    written()  const noexcept;
+  std::size_t capacity() const noexcept { return capacity_; }
+  const std::string& name() const noexcept { return name_; }
+
+private:
+  ShmBridgeWriter(std::string name, void* base, std::size_t bytes, std::size_t capacity);
+
+  std::string        name_;
+  uint64_t           dev_{0}, ino_{0};   // Identität des eigenen Segments
+  void*              base_;
+  std::size_t        bytes_;
+  std::size_t        capacity_;
+  shm::Header*       hdr_;
+  shm::Slot*         slots_;
+  core::Subscription sub_;
+};
+
+// Lock-freier Leser; beliebig viele Leser (auch in anderen Prozessen).
+class ShmBridgeReader {
+public:
+  enum class Start : uint8_t {
+    Tail,     // nur neue Records
+    Oldest    // ab dem ältesten noch im Ring liegenden Record
+  };
+
+  static std::unique_ptr<ShmBridgeReader> open(const std::string& name, Start start = Start::Tail,
+                                               std::string* err = nullptr);
+  ~ShmBridgeReader();
+
+  ShmBridgeReader(const ShmBridgeReader&)            = delete;
+  ShmBridgeReader& operator=(const ShmBridgeReader&) = delete;
+
+  // Liest den nächsten Record. false, wenn gerade nichts (fertig) anliegt.
+  // Ein Schreiber, der mitten im Record abbricht, blockiert den Leser, bis
+  // der Ring ihn einmal überholt hat.
+  bool read(core::MetricRecord& out);
+
+  uint64_t received() const noexcept { return received_; }
+  // Records, die der Schreiber überschrieben hat, bevor sie gelesen wurden
+  uint64_t overruns() const noexcept { return overruns_; }
+  uint64_t position() const noexcept { return next_; }
+
+private:
+  ShmBridgeReader(void* base, std::size_t bytes);
+
+  void*        base_;
+  std::size_t  bytes_;
+  std::size_t  mask_;
+  const shm::Header* hdr_;
+  const shm::Slot*   slots_;
+  uint64_t     next_{0};
+  uint64_t     received_{0};
+  uint64_t     overruns_{0};
+};
+
+// Leser-Adapter: republiziert Records in einen lokalen MetricBus
+class ShmBusAdapter {
+public:
+  ShmBusAdapter(ShmBridgeReader& reader, core::MetricBus& local) : reader_(reader), local_(local) {}
+
+  // Republiziert bis zu max Records, Rückgabe: Anzahl
+  std::size_t pump(std::size_t max = SIZE_MAX);
+
+private:
+  ShmBridgeReader& reader_;
+  core::MetricBus& local_;
+};
+
+} // namespace ipc
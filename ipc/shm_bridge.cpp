@@ -0,0 +1,217 @@
+#include "ipc/shm_bridge.h"
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace core;
+
+namespace ipc {
+
+namespace {
+
+std::string shm_path(const std::string& name) {
+  return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+
+std::size_t ring_bytes(std::size_t capacity) {
+  return sizeof(shm::Header) + capacity * sizeof(shm::Slot);
+}
+
+bool fail(std::string* err, const std::string& what) {
+  if (err) *err = what + ": " + std::strerror(errno);
+  return false;
+}
+
+} // namespace
+
+// ---- ShmBridgeWriter ----
+
+std::unique_ptr<ShmBridgeWriter> ShmBridgeWriter::create(MetricBus& bus, const std::string& name,
+                                                         std::size_t capacity, std::string* err,
+                                                         Create mode) {
+  std::size_t cap = 16;
+  while (cap < capacity) cap <<= 1;
+  const std::size_t bytes = ring_bytes(cap);
+  const std::string path  = shm_path(name);
+
+  if (mode == Create::Takeover) ::shm_unlink(path.c_str());   // bewusste Übernahme
+  // O_EXCL: nie ein fremdes, noch gelesenes Segment neu initialisieren
+  const int fd = ::shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd < 0) {
+    fail(err, errno == EEXIST ? "shm_open " + path + " (segment exists, writer running?)"
+                              : "shm_open " + path);
+    return nullptr;
+  }
+  struct stat st{};
+  if (::fstat(fd, &st) != 0 || ::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+    fail(err, "ftruncate " + path);
+    ::close(fd);
+    ::shm_unlink(path.c_str());
+    return nullptr;
+  }
+  void* base = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (base == MAP_FAILED) {
+    fail(err, "mmap " + path);
+    ::shm_unlink(path.c_str());
+    return nullptr;
+  }
+
+  std::unique_ptr<ShmBridgeWriter> w(new ShmBridgeWriter(path, base, bytes, cap));
+  w->dev_ = static_cast<uint64_t>(st.st_dev);
+  w->ino_ = static_cast<uint64_t>(st.st_ino);
+  w->sub_ = bus.subscribe([raw = w.get()](const Metric& m) { raw->write(m); });
+  return w;
+}
+
+ShmBridgeWriter::ShmBridgeWriter(std::string name, void* base, std::size_t bytes, std::size_t capacity)
+: name_(std::move(name)), base_(base), bytes_(bytes), capacity_(capacity) {
+  auto* p = static_cast<unsigned char*>(base_);
+  hdr_   = new (p) shm::Header;
+  slots_ = reinterpret_cast<shm::Slot*>(p + sizeof(shm::Header));
+  for (std::size_t i = 0; i < capacity_; ++i) {
+    new (&slots_[i]) shm::Slot;
+    slots_[i].seq.store(0, std::memory_order_relaxed);
+  }
+  hdr_->record_size = sizeof(MetricRecord);
+  hdr_->capacity    = static_cast<uint32_t>(capacity_);
+  hdr_->version     = shm::kVersion;
+  hdr_->write_seq.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  hdr_->magic       = shm::kMagic;   // zuletzt: Segment ist gültig
+}
+
+ShmBridgeWriter::~ShmBridgeWriter() {
+  sub_.unsubscribe();   // vor munmap keine Callbacks mehr
+  ::munmap(base_, bytes_);
+  // nach einem Takeover gehört der Name einem anderen Schreiber
+  const int fd = ::shm_open(name_.c_str(), O_RDONLY, 0);
+  if (fd < 0) return;
+  struct stat st{};
+  const bool ours = ::fstat(fd, &st) == 0 && static_cast<uint64_t>(st.st_dev) == dev_
+                    && static_cast<uint64_t>(st.st_ino) == ino_;
+  ::close(fd);
+  if (ours) ::shm_unlink(name_.c_str());
+}
+
+void ShmBridgeWriter::write(const Metric& m) noexcept {
+  const MetricRecord rec = to_record(m);
+  const uint64_t n = hdr_->write_seq.fetch_add(1, std::memory_order_acq_rel);
+  shm::Slot& s = slots_[n & (capacity_ - 1)];
+
+  s.seq.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(&s.rec, &rec, sizeof(rec));
+  s.seq.store(n + 1, std::memory_order_release);
+}
+
+uint64_t ShmBridgeWriter::written() const noexcept {
+  return hdr_->write_seq.load(std::memory_order_acquire);
+}
+
+// ---- ShmBridgeReader ----
+
+std::unique_ptr<ShmBridgeReader> ShmBridgeReader::open(const std::string& name, Start start,
+                                                       std::string* err) {
+  const std::string path = shm_path(name);
+  const int fd = ::shm_open(path.c_str(), O_RDONLY, 0);
+  if (fd < 0) { fail(err, "shm_open " + path); return nullptr; }
+
+  struct stat st{};
+  if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(shm::Header)) {
+    if (err) *err = "segment too small: " + path;
+    ::close(fd);
+    return nullptr;
+  }
+  const auto bytes = static_cast<std::size_t>(st.st_size);
+  void* base = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (base == MAP_FAILED) { fail(err, "mmap " + path); return nullptr; }
+
+  const auto* hdr = static_cast<const shm::Header*>(base);
+  if (hdr->magic != shm::kMagic || hdr->version != shm::kVersion
+      || hdr->record_size != sizeof(MetricRecord)
+      || ring_bytes(hdr->capacity) != bytes) {
+    if (err) *err = "incompatible segment: " + path;
+    ::munmap(base, bytes);
+    return nullptr;
+  }
+
+  std::unique_ptr<ShmBridgeReader> r(new ShmBridgeReader(base, bytes));
+  const uint64_t w = hdr->write_seq.load(std::memory_order_acquire);
+  if (start == Start::Tail) r->next_ = w;
+  else                      r->next_ = w > hdr->capacity ? w - hdr->capacity : 0;
+  return r;
+}
+
+ShmBridgeReader::ShmBridgeReader(void* base, std::size_t bytes)
+: base_(base), bytes_(bytes) {
+  auto* p = static_cast<const unsigned char*>(base_);
+  hdr_   = reinterpret_cast<const shm::Header*>(p);
+  slots_ = reinterpret_cast<const shm::Slot*>(p + sizeof(shm::Header));
+  mask_  = hdr_->capacity - 1;
+}
+
+ShmBridgeReader::~ShmBridgeReader() {
+  ::munmap(base_, bytes_);
+}
+
+bool ShmBridgeReader::read(MetricRecord& out) {
+  const uint64_t cap = mask_ + 1;
+  for (;;) {
+    const uint64_t avail = hdr_->write_seq.load(std::memory_order_acquire);
+    if (next_ >= avail) return false;
+
+    // Schreiber hat uns um mehr als einen Ring überholt
+    if (avail - next_ > cap) {
+      overruns_ += avail - cap - next_;
+      next_ = avail - cap;
+    }
+
+    const shm::Slot& s = slots_[next_ & mask_];
+    const uint64_t s1 = s.seq.load(std::memory_order_acquire);
+    if (s1 == next_ + 1) {
+      MetricRecord tmp;
+      std::memcpy(&tmp, &s.rec, sizeof(tmp));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (s.seq.load(std::memory_order_relaxed) == s1) {
+        out = tmp;
+        ++next_;
+        ++received_;
+        return true;
+      }
+      // während des Kopierens überschrieben
+      ++overruns_;
+      ++next_;
+      continue;
+    }
+    if (s1 > next_ + 1) {
+      // Slot gehört schon zu einem neueren Umlauf
+      ++overruns_;
+      ++next_;
+      continue;
+    }
+    // Schreiber noch nicht fertig
+    return false;
+  }
+}
+
+// ---- ShmBusAdapter ----
+
+std::size_t ShmBusAdapter::pump(std::size_t max) {
+  std::size_t n = 0;
+  MetricRecord rec;
+  while (n < max && reader_.read(rec)) {
+    local_.publish(from_record(rec));
+    ++n;
+  }
+  return n;
+}
+
+} // namespace ipc
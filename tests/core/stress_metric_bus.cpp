@@ -0,0 +1,234 @@
+// Stresstest für MetricBus unter Last: viele Publisher-Threads, Threads mit
+// zufälligem subscribe/unsubscribe/Subscription-Move (auch über Threads
+// hinweg) und re-entrante Publishes aus Callbacks.
+// Geprüft wird:
+//   - Reihenfolge pro Publisher bleibt bei jedem Subscriber erhalten
+//   - keine Zustellung eines publish(), der erst nach unsubscribe() begann
+// Ausgabe: Durchsatz und Latenz-Perzentile von publish(); Exit-Code 1 bei
+// Verletzungen. Für ThreadSanitizer mit -DCARAVAN_SANITIZE=thread bauen.
+//   metric_bus_stress [publishers] [churners] [duration_ms] [shards] [recursive|deferred]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <core/metric_bus.h>
+#include <core/metric.h>
+#include <core/ids.h>
+
+using namespace core;
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+inline uint64_t now_ns() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(SteadyClock::now().time_since_epoch()).count());
+}
+
+struct Xorshift {
+  uint64_t s;
+  uint64_t next() { s ^= s << 13; s ^= s >> 7; s ^= s << 17; return s; }
+  uint32_t below(uint32_t n) { return static_cast<uint32_t>(next() % n); }
+};
+
+struct Global {
+  MetricBus&            bus;
+  uint32_t              publishers;
+  std::atomic<uint64_t> ticket{0};      // globale Reihenfolge der publish()-Aufrufe
+  std::atomic<bool>     stop{false};
+  std::atomic<uint64_t> order_violations{0};
+  std::atomic<uint64_t> late_deliveries{0};
+  std::atomic<uint64_t> churn_ops{0};
+};
+
+// Zustellungen pro Thread zählen, ohne gemeinsamen Zähler
+thread_local uint64_t tl_deliveries = 0;
+
+// Zustand eines Subscribers; die Callback-Kopien halten ihn am Leben
+struct SubState {
+  explicit SubState(uint32_t publishers) : last_seq(publishers, 0) {}
+  std::atomic<uint64_t> cutoff{UINT64_MAX};   // erstes Ticket nach unsubscribe()
+  // Eintrag p wird nur vom Thread des Publishers p geschrieben (synchrone Zustellung)
+  std::vector<uint32_t> last_seq;
+  bool republish{false};
+};
+
+struct Sub {
+  Subscription              s;
+  std::shared_ptr<SubState> st;
+};
+
+Sub make_sub(Global& g, Xorshift& rng) {
+  Sub out;
+  out.st = std::make_shared<SubState>(g.publishers);
+  out.st->republish = rng.below(8) == 0;
+  auto cb = [&g, st = out.st](const Metric& m) {
+    ++tl_deliveries;
+    if (m.timestamp_ms() >= st->cutoff.load()) ++g.late_deliveries;
+    if (m.metric_id() != MetricID::Temperature) return;
+    uint32_t& last = st->last_seq[m.instance_id()];
+    if (m.seq() <= last) ++g.order_violations;
+    last = m.seq();
+    // re-entrant: abgeleiteter Wert auf demselben Bus
+    if (st->republish)
+      g.bus.publish(Metric::Make(m.instance_id(), MetricID::TiltAngleSmoothed, 0.0f, m.timestamp_ms(), m.seq()));
+  };
+  if (rng.below(3) == 0)
+    out.s = g.bus.subscribe(rng.below(2) ? MetricID::Temperature : MetricID::TiltAngleSmoothed, std::move(cb));
+  else
+    out.s = g.bus.subscribe(std::move(cb));
+  return out;
+}
+
+void retire(Global& g, Sub& sub) {
+  if (!sub.st) return;
+  sub.s.unsubscribe();
+  // alles, was ab jetzt ein Ticket zieht, darf diesen Subscriber nicht mehr erreichen
+  sub.st->cutoff.store(g.ticket.load());
+  sub.st.reset();
+}
+
+struct PublisherResult {
+  uint64_t              publishes{0};
+  uint64_t              deliveries{0};
+  std::vector<uint32_t> lat_ns;
+};
+
+void publisher(Global& g, uint32_t id, PublisherResult& res) {
+  constexpr std::size_t kMaxSamples = 1u << 21;
+  res.lat_ns.reserve(kMaxSamples);
+  uint32_t seq = 0;
+  while (!g.stop.load(std::memory_order_relaxed)) {
+    const uint64_t ticket = g.ticket.fetch_add(1);
+    ++seq;
+    const Metric m = Metric::Make(id, MetricID::Temperature, float(seq), ticket, seq);
+    const uint64_t t0 = now_ns();
+    g.bus.publish(m);
+    const uint64_t dt = now_ns() - t0;
+    if (res.lat_ns.size() < kMaxSamples) res.lat_ns.push_back(static_cast<uint32_t>(std::min<uint64_t>(dt, UINT32_MAX)));
+    ++res.publishes;
+  }
+  res.deliveries = tl_deliveries;
+}
+
+// Übergabe von Subscriptions zwischen Churn-Threads (Move über Threads)
+struct HandoffPool {
+  std::mutex       mtx;
+  std::vector<Sub> subs;
+};
+
+void churner(Global& g, HandoffPool& pool, uint64_t seed) {
+  constexpr std::size_t kSlots = 32;
+  Xorshift rng{seed};
+  std::vector<Sub> own(kSlots);
+  while (!g.stop.load(std::memory_order_relaxed)) {
+    Sub& a = own[rng.below(kSlots)];
+    Sub& b = own[rng.below(kSlots)];
+    switch (rng.below(5)) {
+      case 0:   // neu anmelden (ersetzt ggf. einen bestehenden)
+      case 1:
+        retire(g, a);
+        a = make_sub(g, rng);
+        break;
+      case 2:   // abmelden
+        retire(g, a);
+        break;
+      case 3:   // Move innerhalb des Threads; das Ziel wird vorher abgemeldet
+        if (&a != &b) { retire(g, b); b = std::move(a); }
+        break;
+      case 4: { // Move in den/aus dem gemeinsamen Pool
+        std::lock_guard<std::mutex> lk(pool.mtx);
+        if (a.st && pool.subs.size() < kSlots) {
+          pool.subs.push_back(std::move(a));
+        } else if (!a.st && !pool.subs.empty()) {
+          a = std::move(pool.subs.back());
+          pool.subs.pop_back();
+        }
+        break;
+      }
+    }
+    g.churn_ops.fetch_add(1, std::memory_order_relaxed);
+  }
+  for (auto& s : own) retire(g, s);
+}
+
+uint32_t percentile(const std::vector<uint32_t>& sorted, double p) {
+  if (sorted.empty()) return 0;
+  const std::size_t i = static_cast<std::size_t>(p * double(sorted.size() - 1));
+  return sorted[i];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t publishers  = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4;
+  const uint32_t churners    = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2;
+  const uint32_t duration_ms = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 2000;
+  const std::size_t shards   = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 0;
+  const bool deferred        = argc > 5 && std::strcmp(argv[5], "deferred") == 0;
+
+  MetricBus::Options opt;
+  opt.shards     = shards;
+  opt.reentrancy = deferred ? MetricBus::Reentrancy::Deferred : MetricBus::Reentrancy::Recursive;
+  MetricBus bus(opt);
+
+  Global g{bus, publishers};
+  HandoffPool pool;
+
+  // einige langlebige Subscriber, damit immer zugestellt wird
+  Xorshift rng{0x5EED};
+  std::vector<Sub> stable;
+  for (int i = 0; i < 8; ++i) stable.push_back(make_sub(g, rng));
+
+  std::printf("MetricBus stress: %u publishers, %u churners, %u ms, %zu shards, %s\n",
+              publishers, churners, duration_ms, bus.shard_count(), deferred ? "deferred" : "recursive");
+
+  std::vector<PublisherResult> results(publishers);
+  std::vector<std::thread> threads;
+  const uint64_t t0 = now_ns();
+  for (uint32_t p = 0; p < publishers; ++p) threads.emplace_back(publisher, std::ref(g), p, std::ref(results[p]));
+  for (uint32_t c = 0; c < churners; ++c) threads.emplace_back(churner, std::ref(g), std::ref(pool), 0x1234 + c);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(duration_ms));
+  g.stop.store(true);
+  for (auto& t : threads) t.join();
+  const double secs = double(now_ns() - t0) / 1e9;
+
+  for (auto& s : pool.subs) retire(g, s);
+  for (auto& s : stable) retire(g, s);
+
+  uint64_t pubs = 0, dels = 0;
+  std::vector<uint32_t> lat;
+  for (auto& r : results) {
+    pubs += r.publishes;
+    dels += r.deliveries;
+    lat.insert(lat.end(), r.lat_ns.begin(), r.lat_ns.end());
+  }
+  std::sort(lat.begin(), lat.end());
+
+  std::printf("%-28s %14.0f /s\n", "publish", double(pubs) / secs);
+  std::printf("%-28s %14.0f /s\n", "deliveries", double(dels) / secs);
+  std::printf("%-28s %14.0f /s\n", "subscription churn", double(g.churn_ops.load()) / secs);
+  std::printf("publish latency ns: p50 %u  p90 %u  p99 %u  p99.9 %u  max %u\n",
+              percentile(lat, 0.50), percentile(lat, 0.90), percentile(lat, 0.99),
+              percentile(lat, 0.999), lat.empty() ? 0u : lat.back());
+  std::printf("re-entrancy overflows %llu, subscribers left %zu\n",
+              static_cast<unsigned long long>(bus.reentrancy_overflows()), bus.subscriber_count());
+
+  const uint64_t order = g.order_violations.load();
+  const uint64_t late  = g.late_deliveries.load();
+  std::printf("order violations %llu, deliveries after unsubscribe %llu\n",
+              static_cast<unsigned long long>(order), static_cast<unsigned long long>(late));
+  const bool ok = order == 0 && late == 0 && bus.subscriber_count() == 0 && pubs > 0;
+  std::printf("%s\n", ok ? "OK" : "FAILED");
+  return ok ? 0 : 1;
+}
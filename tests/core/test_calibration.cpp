@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+#include <core/calibration.h>
+#include <core/enums.h>
+
+using namespace core;
+
+namespace {
+// Referenz: direkt nach Spec
+inline float ref_value(float raw, const ChannelCalib& c, Quality& q) {
+  const float v = raw * c.scale + c.offset;
+  q = (v < c.min || v > c.max) ? Quality::Bad : Quality::Good;
+  return v < c.min ? c.min : (v > c.max ? c.max : v);
+}
+
+inline CalibrationTable make_table(std::size_t n) {
+  CalibrationTable t(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    t.set(i, ChannelCalib{0.1f * static_cast<float>(i + 1), static_cast<float>(i) - 3.0f,
+                          -500.0f, 2000.0f});
+  }
+  return t;
+}
+} // namespace
+
+TEST(Calibration, Unsigned_MatchesReference_AllBlockSizes) {
+  // Blockgrößen um die Vektorbreiten herum (Rest-Schleife mit abdecken)
+  for (std::size_t n : {1u, 3u, 4u, 7u, 8u, 9u, 16u, 17u, 64u}) {
+    CalibrationTable t = make_table(n);
+    std::vector<uint16_t> raw(n);
+    for (std::size_t i = 0; i < n; ++i) raw[i] = static_cast<uint16_t>(i * 1111u);
+
+    std::vector<float> out(n);
+    std::vector<Quality> q(n);
+    t.apply(raw.data(), out.data(), q.data());
+
+    for (std::size_t i = 0; i < n; ++i) {
+      Quality rq;
+      const float rv = ref_value(static_cast<float>(raw[i]), t.get(i), rq);
+      EXPECT_FLOAT_EQ(out[i], rv) << "n=" << n << " i=" << i << " kernel=" << calib::kernel_name();
+      EXPECT_EQ(q[i], rq) << "n=" << n << " i=" << i;
+    }
+  }
+}
+
+TEST(Calibration, Signed_SignExtends) {
+  CalibrationTable t(9);
+  for (std::size_t i = 0; i < 9; ++i) t.set(i, ChannelCalib{0.01f, 0.0f, -180.0f, 180.0f});
+
+  const int16_t raw[9] = {-1234, 1234, 0, -32768, 32767, -1, 1, -18000, 18000};
+  float   out[9];
+  Quality q[9];
+  t.apply(raw, out, q);
+
+  EXPECT_FLOAT_EQ(out[0], -12.34f);
+  EXPECT_FLOAT_EQ(out[1],  12.34f);
+  EXPECT_FLOAT_EQ(out[3], -180.0f);   // geclampt
+  EXPECT_EQ(q[3], Quality::Bad);
+  EXPECT_FLOAT_EQ(out[4],  180.0f);
+  EXPECT_EQ(q[4], Quality::Bad);
+  EXPECT_FLOAT_EQ(out[7], -180.0f);   // genau auf der Grenze -> Good
+  EXPECT_EQ(q[7], Quality::Good);
+  EXPECT_EQ(q[8], Quality::Good);     // Rest-Element (skalarer Pfad)
+}
+
+TEST(Calibration, VectorHelper_RejectsShortBuffer) {
+  CalibrationTable t(4);
+  std::vector<float> out;
+  std::vector<Quality> q;
+  EXPECT_FALSE(t.apply(std::vector<uint16_t>{1, 2, 3}, out, q));
+  ASSERT_TRUE(t.apply(std::vector<uint16_t>{1, 2, 3, 4, 5}, out, q));
+  ASSERT_EQ(out.size(), 4u);
+  EXPECT_FLOAT_EQ(out[3], 4.0f);      // Default: Scale 1, Offset 0, kein Clamping
+  EXPECT_EQ(q[3], Quality::Good);
+}
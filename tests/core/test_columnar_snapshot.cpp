@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <core/columnar_snapshot.h>
+#include <core/metric_bus.h>
+#include <core/metric_record.h>
+#include <core/metric.h>
+#include <core/enums.h>
+#include <core/ids.h>
+
+using namespace core;
+
+namespace {
+
+Metric mk(uint32_t inst, MetricID id, Metric::Value v, uint64_t ts, Quality q = Quality::Good,
+          Unit u = Unit::None) {
+  Metric::PropMap p;
+  p.emplace(PropertyKey::Quality, static_cast<uint8_t>(q));
+  p.emplace(PropertyKey::Unit, static_cast<uint8_t>(u));
+  return Metric::Make(inst, id, v, ts, 1, std::move(p));
+}
+
+} // namespace
+
+TEST(ColumnarSnapshot, DenseSlotsFromBus_UpdatedInPlace) {
+  MetricBus bus;
+  ColumnarSnapshot snap(bus);
+
+  bus.publish(mk(1, MetricID::TiltAngle, 1.5f, 100, Quality::Good, Unit::Degree));
+  bus.publish(mk(2, MetricID::Temperature, 21.0f, 110, Quality::Good, Unit::Celsius));
+  bus.publish(mk(1, MetricID::TiltAngle, 2.5f, 200, Quality::Uncertain, Unit::Degree));
+  bus.publish(mk(3, MetricID::Alarm, true, 120));
+  bus.publish(mk(4, MetricID::Health, int32_t{7}, 130));
+
+  EXPECT_EQ(snap.slot_count(), 4u);
+  EXPECT_EQ(snap.current()->size(), 0u);   // erst nach commit sichtbar
+
+  auto f = snap.commit();
+  ASSERT_EQ(f->size(), 4u);
+  EXPECT_EQ(f->version, 1u);
+  const uint32_t s = *snap.slot_of(1, MetricID::TiltAngle);
+  EXPECT_EQ(s, 0u);
+  EXPECT_FLOAT_EQ(f->value[s], 2.5f);
+  EXPECT_EQ(f->ts_ms[s], 200u);
+  EXPECT_EQ(f->quality[s], static_cast<uint8_t>(Quality::Uncertain));
+  EXPECT_EQ(f->unit[s], static_cast<uint8_t>(Unit::Degree));
+  EXPECT_FLOAT_EQ(f->value[*snap.slot_of(3, MetricID::Alarm)], 1.0f);
+  EXPECT_FLOAT_EQ(f->value[*snap.slot_of(4, MetricID::Health)], 7.0f);
+  EXPECT_FALSE(snap.slot_of(9, MetricID::TiltAngle).has_value());
+}
+
+TEST(ColumnarSnapshot, ReadersKeepTheirFrame_WriterRecyclesReleasedOnes) {
+  ColumnarSnapshot snap;
+  snap.update(mk(1, MetricID::TiltAngle, 1.0f, 10));
+  snap.update(mk(2, MetricID::TiltAngle, 2.0f, 10));
+  auto f1 = snap.commit();
+
+  snap.update(mk(1, MetricID::TiltAngle, 5.0f, 20));
+  auto f2 = snap.commit();
+  // f1 noch gehalten -> unverändert, neuer Back-Buffer per Vollkopie
+  EXPECT_FLOAT_EQ(f1->value[0], 1.0f);
+  EXPECT_FLOAT_EQ(f2->value[0], 5.0f);
+  EXPECT_EQ(snap.full_copies(), 1u);
+
+  f1.reset();
+  f2.reset();
+  snap.update(mk(2, MetricID::TiltAngle, 7.0f, 30));
+  snap.update(mk(3, MetricID::TiltAngle, 9.0f, 30));
+  snap.commit();
+  snap.update(mk(1, MetricID::TiltAngle, 6.0f, 40));
+  auto f4 = snap.commit();
+  EXPECT_EQ(snap.full_copies(), 1u);   // freigegebene Frames wiederverwendet
+
+  // der recycelte Buffer hat alle Änderungen nachgezogen
+  ASSERT_EQ(f4->size(), 3u);
+  EXPECT_FLOAT_EQ(f4->value[0], 6.0f);
+  EXPECT_FLOAT_EQ(f4->value[1], 7.0f);
+  EXPECT_FLOAT_EQ(f4->value[2], 9.0f);
+  EXPECT_EQ(f4->ts_ms[1], 30u);
+  EXPECT_EQ(f4->version, 4u);
+}
+
+TEST(ColumnarSnapshot, WholeStateScans) {
+  ColumnarSnapshot snap;
+  for (uint32_t i = 0; i < 300; ++i)
+    snap.update(mk(i, MetricID::Temperature, float(i), i % 3 == 0 ? 1000 : 9000,
+                   i % 10 == 0 ? Quality::Bad : Quality::Good));
+  auto f = snap.commit();
+
+  // "älter als 5 s" bei now = 10 s
+  EXPECT_EQ(f->count_stale(10'000, 5'000), 100u);
+  EXPECT_TRUE(f->any_stale(10'000, 5'000));
+  EXPECT_FALSE(f->any_stale(10'000, 9'500));
+  std::vector<uint32_t> slots;
+  f->stale_slots(10'000, 5'000, slots);
+  ASSERT_EQ(slots.size(), 100u);
+  EXPECT_EQ(slots[1], 3u);
+  EXPECT_EQ(f->count_quality(Quality::Bad), 30u);
+  // Zeitstempel in der Zukunft gelten nicht als veraltet
+  EXPECT_EQ(f->count_stale(500, 5'000), 0u);
+}
+
+TEST(ColumnarSnapshot, ExportAsRecords) {
+  ColumnarSnapshot snap;
+  snap.update(mk(1, MetricID::TiltAngle, 1.25f, 10, Quality::Uncertain, Unit::Degree));
+  snap.update(mk(2, MetricID::Health, int32_t{-3}, 20));
+  snap.update(mk(3, MetricID::Alarm, true, 30));
+  std::vector<MetricRecord> recs;
+  snap.commit()->to_records(recs);
+  ASSERT_EQ(recs.size(), 3u);
+
+  const Metric a = from_record(recs[0]);
+  EXPECT_EQ(a.metric_id(), MetricID::TiltAngle);
+  EXPECT_FLOAT_EQ(*a.get_if<float>(), 1.25f);
+  EXPECT_EQ(a.try_get_prop<uint8_t>(PropertyKey::Quality), static_cast<uint8_t>(Quality::Uncertain));
+  EXPECT_EQ(a.try_get_prop<uint8_t>(PropertyKey::Unit), static_cast<uint8_t>(Unit::Degree));
+  EXPECT_EQ(*from_record(recs[1]).get_if<int32_t>(), -3);
+  EXPECT_TRUE(*from_record(recs[2]).get_if<bool>());
+  EXPECT_EQ(recs[2].timestamp_ms, 30u);
+}
+
+TEST(ColumnarSnapshot, ConcurrentReadersSeeConsistentFrames) {
+  MetricBus bus;
+  ColumnarSnapshot snap(bus);
+  std::atomic<bool> done{false};
+  std::atomic<int>  torn{0};
+
+  // alle Slots bekommen pro Runde denselben Wert -> ein Frame ist konsistent,
+  // wenn alle Werte gleich sind
+  std::thread reader([&] {
+    while (!done.load()) {
+      auto f = snap.current();
+      for (std::size_t i = 1; i < f->size(); ++i)
+        if (f->value[i] != f->value[0]) { ++torn; break; }
+    }
+  });
+  for (int round = 0; round < 2000; ++round) {
+    for (uint32_t i = 0; i < 32; ++i)
+      bus.publish(mk(i, MetricID::Temperature, float(round), uint64_t(round)));
+    snap.commit();
+  }
+  done = true;
+  reader.join();
+  EXPECT_EQ(torn.load(), 0);
+  EXPECT_EQ(snap.current()->version, 2000u);
+}
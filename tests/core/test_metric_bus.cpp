@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <atomic>
+#include <stdexcept>
 #include <thread>
 #include <vector>
 
@@ -81,22 +82,21 @@ TEST_F(MetricBusFixture, MultipleSubscribers_OrderAndDelivery)
 
 TEST_F(MetricBusFixture, Reentrancy_SafePublishWithinCallback)
 {
-    GTEST_FAIL() << "Not implemented";
-    //TODO: Hier ist ein übler crash mal gucken. liegt aber scheinbar eher am test!
     int outer = 0, inner = 0;
     auto sub_inner = bus_.subscribe([&](const Metric &)
                                     { ++inner; });
-    auto sub_outer = bus_.subscribe([&](const Metric & /*m*/)
+    auto sub_outer = bus_.subscribe([&](const Metric &m)
                                     {
     ++outer;
-    // reentrant publish: frische, triviale Metric
-    bus_.publish(mk_health(2)); });
+    // reentrant publish: frische, triviale Metric (nur einmal, sonst Endlosschleife)
+    if (m.seq() == 1) bus_.publish(mk_health(2)); });
 
     bus_.publish(mk_health(1));
 
-    EXPECT_EQ(outer, 1);
-    // inner empfängt sowohl ursprüngliche als auch reentrant publizierte Metric
+    // beide empfangen sowohl die ursprüngliche als auch die reentrant publizierte Metric
+    EXPECT_EQ(outer, 2);
     EXPECT_EQ(inner, 2);
+    EXPECT_EQ(bus_.reentrancy_overflows(), 0u);
 
     sub_outer.unsubscribe();
     sub_inner.unsubscribe();
@@ -136,3 +136,267 @@ TEST_F(MetricBusFixture, UnsubscribeNonexistentReturnsFalse)
     EXPECT_FALSE(bus_.unsubscribe(0));
     EXPECT_FALSE(bus_.unsubscribe(999'999'999ull));
 }
+
+// ---- Sharded Bus ----
+
+TEST(MetricBusSharded, DeliversAcrossShards_AndUnsubscribesEverywhere)
+{
+    MetricBus bus(MetricBus::Options{4, MetricBus::ShardKey::Instance});
+    ASSERT_EQ(bus.shard_count(), 4u);
+
+    int count = 0;
+    auto sub = bus.subscribe([&](const Metric &)
+                             { ++count; });
+
+    for (uint32_t inst = 1; inst <= 8; ++inst)
+        bus.publish(Metric::Make(inst, MetricID::Health, int32_t{0}, 100, 1));
+    EXPECT_EQ(count, 8);
+
+    sub.unsubscribe();
+    for (uint32_t inst = 1; inst <= 8; ++inst)
+        bus.publish(Metric::Make(inst, MetricID::Health, int32_t{0}, 100, 2));
+    EXPECT_EQ(count, 8);
+}
+
+TEST(MetricBusSharded, FilteredSubscribe_ByMetric)
+{
+    MetricBus bus(MetricBus::Options{3, MetricBus::ShardKey::Metric});
+
+    int tilt = 0, all = 0;
+    auto st = bus.subscribe(MetricID::TiltAngle, [&](const Metric &)
+                            { ++tilt; });
+    auto sa = bus.subscribe([&](const Metric &)
+                            { ++all; });
+
+    bus.publish(Metric::Make(1, MetricID::TiltAngle, 1.0f, 100, 1));
+    bus.publish(Metric::Make(1, MetricID::Health, int32_t{0}, 100, 2));
+    bus.publish(Metric::Make(2, MetricID::GasLevelPercent, 50.0f, 100, 1));
+
+    EXPECT_EQ(tilt, 1);
+    EXPECT_EQ(all, 3);
+}
+
+TEST(MetricBusSharded, PerInstanceOrder_WithConcurrentPublishers)
+{
+    MetricBus bus(MetricBus::Options{0, MetricBus::ShardKey::Instance});
+    constexpr uint32_t kThreads = 4, kPerThread = 5000;
+
+    // Callback läuft im Thread des Publishers -> ein Slot pro Instanz, kein Lock nötig
+    std::vector<uint32_t> last(kThreads + 1, 0);
+    std::atomic<int> out_of_order{0};
+    auto sub = bus.subscribe([&](const Metric &m)
+                             {
+        auto& l = last[m.instance_id()];
+        if (m.seq() != l + 1) out_of_order.fetch_add(1, std::memory_order_relaxed);
+        l = m.seq(); });
+
+    std::vector<std::thread> pubs;
+    for (uint32_t t = 1; t <= kThreads; ++t)
+        pubs.emplace_back([&, t]
+                          {
+            for (uint32_t i = 1; i <= kPerThread; ++i)
+                bus.publish(Metric::Make(t, MetricID::Health, int32_t{0}, i, i)); });
+    for (auto &th : pubs) th.join();
+
+    EXPECT_EQ(out_of_order.load(), 0);
+    for (uint32_t t = 1; t <= kThreads; ++t) EXPECT_EQ(last[t], kPerThread);
+}
+
+// ---- Slot-Map ----
+
+TEST_F(MetricBusFixture, StaleHandle_AfterSlotReuse_IsRejected)
+{
+    int a = 0, b = 0;
+    auto sa = bus_.subscribe([&](const Metric &)
+                             { ++a; });
+    const uint64_t old_id = sa.id();
+    sa.unsubscribe();
+
+    // gleicher Slot, neue Generation
+    auto sb = bus_.subscribe([&](const Metric &)
+                             { ++b; });
+    EXPECT_EQ(sb.id() & 0xFFFFFFFFull, old_id & 0xFFFFFFFFull);
+    EXPECT_NE(sb.id(), old_id);
+
+    EXPECT_FALSE(bus_.unsubscribe(old_id));
+    bus_.publish(mk_health(1));
+    EXPECT_EQ(a, 0);
+    EXPECT_EQ(b, 1);
+    EXPECT_EQ(bus_.subscriber_count(), 1u);
+}
+
+TEST_F(MetricBusFixture, Churn_KeepsRegistrationOrder)
+{
+    std::vector<int> order;
+    std::vector<Subscription> keep;
+    for (int i = 0; i < 8; ++i)
+        keep.push_back(bus_.subscribe([&order, i](const Metric &)
+                                      { order.push_back(i); }));
+
+    // viele kurzlebige Subscriptions dazwischen -> Grabsteine + Kompaktierung
+    {
+        std::vector<Subscription> window(16);
+        for (std::size_t i = 0; i < 1000; ++i)
+            window[i % window.size()] = bus_.subscribe([&order](const Metric &)
+                                                       { order.push_back(-1); });
+    }
+    keep[3].unsubscribe();
+    keep.push_back(bus_.subscribe([&order](const Metric &)
+                                  { order.push_back(8); }));
+
+    bus_.publish(mk_health(1));
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 4, 5, 6, 7, 8}));
+    EXPECT_EQ(bus_.subscriber_count(), 8u);
+}
+
+TEST_F(MetricBusFixture, UnsubscribeSelfInsideCallback)
+{
+    int count = 0;
+    Subscription self;
+    self = bus_.subscribe([&](const Metric &)
+                          {
+        ++count;
+        self.unsubscribe(); });
+
+    bus_.publish(mk_health(1));
+    bus_.publish(mk_health(2));
+    EXPECT_EQ(count, 1);
+
+    // Slot wurde nach dem Aufruf freigegeben und ist wiederverwendbar
+    int other = 0;
+    auto sub = bus_.subscribe([&](const Metric &)
+                              { ++other; });
+    bus_.publish(mk_health(3));
+    EXPECT_EQ(other, 1);
+    EXPECT_EQ(count, 1);
+}
+
+// ---- Re-entrancy ----
+
+namespace
+{
+    // A publiziert bei 1 -> 2 und 3, bei 2 -> 4; B protokolliert
+    std::vector<uint32_t> fan_out_order(MetricBus &bus)
+    {
+        std::vector<uint32_t> seen;
+        auto a = bus.subscribe([&](const Metric &m)
+                               {
+            if (m.seq() == 1) { bus.publish(mk_health(2)); bus.publish(mk_health(3)); }
+            if (m.seq() == 2) bus.publish(mk_health(4)); });
+        auto b = bus.subscribe([&](const Metric &m)
+                               { seen.push_back(m.seq()); });
+        bus.publish(mk_health(1));
+        return seen;
+    }
+} // namespace
+
+TEST(MetricBusReentrancy, Recursive_DepthFirst)
+{
+    MetricBus bus;
+    EXPECT_EQ(fan_out_order(bus), (std::vector<uint32_t>{4, 2, 3, 1}));
+}
+
+TEST(MetricBusReentrancy, Deferred_BreadthFirst)
+{
+    MetricBus::Options opt;
+    opt.reentrancy = MetricBus::Reentrancy::Deferred;
+    MetricBus bus(opt);
+    EXPECT_EQ(fan_out_order(bus), (std::vector<uint32_t>{1, 2, 3, 4}));
+}
+
+TEST(MetricBusReentrancy, MaxDepth_StopsEndlessChain)
+{
+    for (auto mode : {MetricBus::Reentrancy::Recursive, MetricBus::Reentrancy::Deferred})
+    {
+        MetricBus::Options opt;
+        opt.reentrancy = mode;
+        opt.max_depth  = 3;
+        MetricBus bus(opt);
+
+        std::vector<uint32_t> seen;
+        auto sub = bus.subscribe([&](const Metric &m)
+                                 {
+            seen.push_back(m.seq());
+            bus.publish(mk_health(m.seq() + 1)); });   // würde ohne Grenze nie enden
+        bus.publish(mk_health(1));
+
+        EXPECT_EQ(seen, (std::vector<uint32_t>{1, 2, 3, 4}));
+        EXPECT_EQ(bus.reentrancy_overflows(), 1u);
+
+        // Zähler läuft weiter, Bus bleibt benutzbar
+        bus.publish(mk_health(1));
+        EXPECT_EQ(seen.size(), 8u);
+        EXPECT_EQ(bus.reentrancy_overflows(), 2u);
+    }
+}
+
+TEST(MetricBusReentrancy, ThrowingCallbackLeavesBusUsable)
+{
+    for (auto mode : {MetricBus::Reentrancy::Recursive, MetricBus::Reentrancy::Deferred})
+    {
+        MetricBus::Options opt;
+        opt.reentrancy = mode;
+        opt.max_depth  = 2;
+        MetricBus bus(opt);
+
+        bool boom = true;
+        std::vector<uint32_t> seen;
+        int second = 0;
+        auto a = bus.subscribe([&](const Metric &m)
+                               {
+            seen.push_back(m.seq());
+            if (m.seq() == 1) bus.publish(mk_health(2));
+            if (m.seq() == 2 && boom) throw std::runtime_error("boom"); });
+        auto b = bus.subscribe([&](const Metric &)
+                               { ++second; });
+
+        EXPECT_THROW(bus.publish(mk_health(1)), std::runtime_error);
+
+        // kein Frame/keine Ebene hängen geblieben: wieder äußerster publish()
+        boom = false;
+        seen.clear();
+        second = 0;
+        for (int i = 0; i < 3; ++i) bus.publish(mk_health(1));
+        EXPECT_EQ(seen, (std::vector<uint32_t>{1, 2, 1, 2, 1, 2}));
+        EXPECT_EQ(second, 6);
+        EXPECT_EQ(bus.reentrancy_overflows(), 0u);
+    }
+}
+
+TEST(MetricBusReentrancy, Deferred_QueueLimit)
+{
+    MetricBus::Options opt;
+    opt.reentrancy = MetricBus::Reentrancy::Deferred;
+    opt.max_queue  = 2;
+    MetricBus bus(opt);
+
+    std::vector<uint32_t> seen;
+    auto sub = bus.subscribe([&](const Metric &m)
+                             {
+        seen.push_back(m.seq());
+        if (m.seq() == 1)
+            for (uint32_t i = 10; i < 15; ++i) bus.publish(mk_health(i)); });
+    bus.publish(mk_health(1));
+
+    EXPECT_EQ(seen, (std::vector<uint32_t>{1, 10, 11}));
+    EXPECT_EQ(bus.reentrancy_overflows(), 3u);
+}
+
+TEST(MetricBusReentrancy, Deferred_OtherBusIsDeliveredImmediately)
+{
+    MetricBus::Options opt;
+    opt.reentrancy = MetricBus::Reentrancy::Deferred;
+    MetricBus a(opt), b(opt);
+
+    std::vector<int> log;
+    auto sb = b.subscribe([&](const Metric &)
+                          { log.push_back(2); });
+    auto sa = a.subscribe([&](const Metric &)
+                          {
+        log.push_back(1);
+        b.publish(mk_health(1));   // anderer Bus: kein Re-entrant-Fall
+        log.push_back(3); });
+
+    a.publish(mk_health(1));
+    EXPECT_EQ(log, (std::vector<int>{1, 2, 3}));
+}
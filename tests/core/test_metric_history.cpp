@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <core/metric_history.h>
+#include <core/metric_bus.h>
+#include <core/metric.h>
+#include <core/enums.h>
+#include <core/ids.h>
+
+using namespace core;
+
+namespace {
+
+Metric mk(uint32_t inst, MetricID id, Metric::Value v, uint64_t ts, Quality q = Quality::Good) {
+  Metric::PropMap p;
+  p.emplace(PropertyKey::Quality, static_cast<uint8_t>(q));
+  return Metric::Make(inst, id, v, ts, 1, std::move(p));
+}
+
+std::vector<HistoryPoint> decode_all(const std::vector<uint8_t>& block, bool* ok = nullptr) {
+  std::vector<HistoryPoint> out;
+  HistoryDecoder dec(block);
+  HistoryPoint p;
+  while (dec.next(p)) out.push_back(p);
+  if (ok) *ok = dec.ok();
+  return out;
+}
+
+} // namespace
+
+TEST(HistoryCodec, FloatRoundTripWithJitterAndQuality) {
+  HistoryEncoder enc(DataType::Float);
+  std::vector<HistoryPoint> in;
+  uint64_t ts = 1'700'000'000'000ull;
+  for (int i = 0; i < 500; ++i) {
+    ts += 1000 + (i % 7) - 3;                          // Polling mit Jitter
+    const float v = 20.0f + 0.25f * static_cast<float>((i / 10) % 8);
+    const Quality q = (i % 97 == 0) ? Quality::Uncertain : Quality::Good;
+    ASSERT_TRUE(enc.append(ts, v, q));
+    in.push_back({ts, v, q});
+  }
+  EXPECT_EQ(enc.count(), 500u);
+  EXPECT_EQ(enc.first_ts_ms(), in.front().ts_ms);
+  EXPECT_EQ(enc.last_ts_ms(), in.back().ts_ms);
+  EXPECT_LT(enc.size_bytes(), 500u * 3);   // << 12 Byte roh pro Punkt
+
+  bool ok = false;
+  const auto out = decode_all(enc.bytes(), &ok);
+  EXPECT_TRUE(ok);
+  ASSERT_EQ(out.size(), in.size());
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    EXPECT_EQ(out[i].ts_ms, in[i].ts_ms) << i;
+    EXPECT_EQ(out[i].value, in[i].value) << i;
+    EXPECT_EQ(out[i].quality, in[i].quality) << i;
+  }
+}
+
+TEST(HistoryCodec, Int32AndBoolWithLargeGapsAndNegativeDod) {
+  HistoryEncoder ienc(DataType::Int32);
+  const uint64_t ts[] = {0, 1000, 2000, 1'000'000, 1'000'001, 1'000'001, 9'000'000'000ull, 9'000'000'100ull};
+  const int32_t  iv[] = {0, -1, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max(), 7, 7, 42, -42};
+  for (std::size_t i = 0; i < 8; ++i) ASSERT_TRUE(ienc.append(ts[i], iv[i], Quality::Bad));
+  auto out = decode_all(ienc.bytes());
+  ASSERT_EQ(out.size(), 8u);
+  for (std::size_t i = 0; i < 8; ++i) {
+    EXPECT_EQ(out[i].ts_ms, ts[i]);
+    EXPECT_EQ(std::get<int32_t>(out[i].value), iv[i]);
+    EXPECT_EQ(out[i].quality, Quality::Bad);
+  }
+
+  HistoryEncoder benc(DataType::Bool);
+  for (int i = 0; i < 64; ++i) ASSERT_TRUE(benc.append(100u * i, (i / 5) % 2 == 1));
+  out = decode_all(benc.bytes());
+  ASSERT_EQ(out.size(), 64u);
+  for (int i = 0; i < 64; ++i) EXPECT_EQ(std::get<bool>(out[i].value), (i / 5) % 2 == 1);
+  EXPECT_LT(benc.size_bytes(), 6u + 13 + 64 / 2);
+}
+
+TEST(HistoryCodec, FloatBitPatternsPreserved) {
+  HistoryEncoder enc(DataType::Float);
+  const float vals[] = {0.0f, -0.0f, std::numeric_limits<float>::quiet_NaN(),
+                        std::numeric_limits<float>::infinity(), 1e-38f, -3.5f};
+  for (std::size_t i = 0; i < 6; ++i) ASSERT_TRUE(enc.append(i, vals[i]));
+  const auto out = decode_all(enc.bytes());
+  ASSERT_EQ(out.size(), 6u);
+  for (std::size_t i = 0; i < 6; ++i) {
+    const float f = std::get<float>(out[i].value);
+    EXPECT_EQ(std::memcmp(&f, &vals[i], sizeof(f)), 0) << i;
+  }
+}
+
+TEST(HistoryCodec, RejectsOutOfOrderWrongTypeAndFullBlock) {
+  HistoryEncoder enc(DataType::Float, 64);
+  EXPECT_TRUE(enc.append(100, 1.0f));
+  EXPECT_FALSE(enc.append(99, 1.0f));
+  EXPECT_FALSE(enc.append(200, int32_t{1}));
+  EXPECT_TRUE(enc.append(100, 2.0f));   // gleicher Zeitstempel ist erlaubt
+
+  uint64_t ts = 100;
+  for (;;) {
+    ts += 1000;
+    if (!enc.append(ts, static_cast<float>(ts))) break;
+  }
+  EXPECT_LE(enc.size_bytes(), 64u);
+  const uint32_t n = enc.count();
+  EXPECT_FALSE(enc.append(ts + 1000, 0.0f));
+  EXPECT_EQ(enc.count(), n);
+  EXPECT_EQ(decode_all(enc.bytes()).size(), n);
+}
+
+TEST(HistoryCodec, TruncatedOrForeignBlockIsNotOk) {
+  HistoryEncoder enc(DataType::Float);
+  for (int i = 0; i < 50; ++i) ASSERT_TRUE(enc.append(1000u * i + (i % 3), 0.1f * i));
+  std::vector<uint8_t> cut(enc.bytes().begin(), enc.bytes().end() - 8);
+  bool ok = true;
+  const auto out = decode_all(cut, &ok);
+  EXPECT_FALSE(ok);
+  EXPECT_LT(out.size(), 50u);
+
+  std::vector<uint8_t> foreign = enc.bytes();
+  foreign[0] = 99;   // unbekannte Version
+  HistoryDecoder dec(foreign);
+  HistoryPoint p;
+  EXPECT_FALSE(dec.next(p));
+  EXPECT_FALSE(dec.ok());
+}
+
+TEST(MetricHistory, BusFedRangeQueryAcrossBlocks) {
+  MetricBus bus;
+  MetricHistory::Config cfg;
+  cfg.block_bytes = 128;
+  MetricHistory hist(bus, cfg);
+
+  for (uint32_t i = 0; i < 400; ++i) {
+    bus.publish(mk(1, MetricID::WaterLevelPercent, 50.0f + 0.5f * static_cast<float>(i % 9), 1000u * i));
+    bus.publish(mk(2, MetricID::Alarm, i % 50 == 0, 1000u * i));
+  }
+  bus.publish(mk(1, MetricID::WaterLevelPercent, 0.0f, 5));   // außer der Reihe
+
+  const auto st = hist.stats();
+  EXPECT_EQ(st.series, 2u);
+  EXPECT_EQ(st.points, 800u);
+  EXPECT_EQ(st.out_of_order, 1u);
+  EXPECT_EQ(st.evicted_blocks, 0u);
+  EXPECT_GT(hist.blocks(1, MetricID::WaterLevelPercent).size(), 2u);
+
+  std::vector<HistoryPoint> got;
+  const std::size_t n = hist.query(1, MetricID::WaterLevelPercent, 100'000, 299'500,
+                                   [&](const HistoryPoint& p) { got.push_back(p); return true; });
+  ASSERT_EQ(n, 200u);
+  ASSERT_EQ(got.size(), 200u);
+  for (std::size_t k = 0; k < got.size(); ++k) {
+    const uint32_t i = 100 + static_cast<uint32_t>(k);
+    EXPECT_EQ(got[k].ts_ms, 1000u * i);
+    EXPECT_FLOAT_EQ(std::get<float>(got[k].value), 50.0f + 0.5f * static_cast<float>(i % 9));
+  }
+
+  // Abbruch durch den Callback
+  std::size_t seen = 0;
+  EXPECT_EQ(hist.query(2, MetricID::Alarm, 0, ~0ull, [&](const HistoryPoint&) { return ++seen < 3; }), 3u);
+  EXPECT_EQ(hist.query(3, MetricID::Alarm, 0, ~0ull, [](const HistoryPoint&) { return true; }), 0u);
+}
+
+TEST(MetricHistory, EvictsOldestBlocksAndHandlesTypeChange) {
+  MetricHistory::Config cfg;
+  cfg.block_bytes          = 64;
+  cfg.max_bytes_per_series = 256;
+  MetricHistory hist(cfg);
+
+  for (uint32_t i = 0; i < 2000; ++i)
+    ASSERT_TRUE(hist.append(mk(7, MetricID::Electrical, static_cast<float>(i) * 1.37f, 10u * i)));
+  auto st = hist.stats();
+  EXPECT_GT(st.evicted_blocks, 0u);
+  EXPECT_LE(st.bytes, cfg.max_bytes_per_series);
+  EXPECT_LT(st.points, 2000u);
+
+  // die neuesten Punkte sind noch da, die ältesten nicht
+  uint64_t first = 0, last = 0;
+  const std::size_t n = hist.query(7, MetricID::Electrical, 0, ~0ull, [&](const HistoryPoint& p) {
+    if (!first) first = p.ts_ms;
+    last = p.ts_ms;
+    return true;
+  });
+  EXPECT_EQ(n, st.points);
+  EXPECT_GT(first, 0u);
+  EXPECT_EQ(last, 10u * 1999);
+
+  // Typwechsel versiegelt den offenen Block
+  ASSERT_TRUE(hist.append(mk(7, MetricID::Electrical, int32_t{12}, 20'000)));
+  std::vector<HistoryPoint> tail;
+  hist.query(7, MetricID::Electrical, 19'990, 20'000, [&](const HistoryPoint& p) { tail.push_back(p); return true; });
+  ASSERT_EQ(tail.size(), 2u);
+  EXPECT_TRUE(std::holds_alternative<float>(tail[0].value));
+  EXPECT_EQ(std::get<int32_t>(tail[1].value), 12);
+}
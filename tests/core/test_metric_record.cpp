@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+
+#include <core/metric_record.h>
+#include <core/metric.h>
+#include <core/enums.h>
+#include <core/ids.h>
+
+using namespace core;
+
+TEST(MetricRecord, RoundTrip_AllValueTypesAndProps) {
+  Metric::PropMap p;
+  p.emplace(PropertyKey::Unit,     static_cast<uint8_t>(Unit::Percent));
+  p.emplace(PropertyKey::Quality,  static_cast<uint8_t>(Quality::Uncertain));
+  p.emplace(PropertyKey::Scale,    0.5f);
+  p.emplace(PropertyKey::Min,      int32_t{-3});
+  p.emplace(PropertyKey::SensorId, int32_t{77});
+
+  const Metric f = Metric::Make(42, MetricID::WaterLevelPercent, 73.25f, 1234567890123ull, 9, p);
+  EXPECT_TRUE(from_record(to_record(f)) == f);
+
+  const Metric i = Metric::Make(1, MetricID::Health, int32_t{-2}, 5, 6, {});
+  EXPECT_TRUE(from_record(to_record(i)) == i);
+
+  const Metric b = Metric::Make(2, MetricID::Alarm, true, 7, 8, {});
+  EXPECT_TRUE(from_record(to_record(b)) == b);
+}
+
+TEST(MetricRecord, LayoutIsStable) {
+  const Metric m = Metric::Make(0x01020304u, MetricID::TiltAngle, 1.0f, 10, 11, {});
+  const MetricRecord r = to_record(m);
+  EXPECT_EQ(r.instance_id, 0x01020304u);
+  EXPECT_EQ(r.metric_id, 0x1201u);
+  EXPECT_EQ(r.datatype, static_cast<uint8_t>(DataType::Float));
+  EXPECT_EQ(r.prop_types, 0u);
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include <core/priority_lanes.h>
+#include <core/metric_bus.h>
+#include <core/metric.h>
+#include <core/ids.h>
+
+using namespace core;
+
+namespace {
+inline Metric mk(MetricID id, uint32_t seq) {
+  if (id == MetricID::Health) return Metric::Make(1, id, int32_t{0}, 0, seq, {});
+  return Metric::Make(1, id, 1.0f, 0, seq, {});
+}
+} // namespace
+
+TEST(LaneMap, DefaultHealthRangeIsHigh) {
+  LaneMap map;
+  EXPECT_EQ(map.lane_of(MetricID::Health), Priority::High);
+  EXPECT_EQ(map.lane_of(MetricID::Alarm), Priority::High);
+  EXPECT_EQ(map.lane_of(MetricID::TiltAngle), Priority::Normal);
+
+  map.assign(0x1200, 0x12FF, Priority::Bulk);
+  EXPECT_EQ(map.lane_of(MetricID::TiltAngle), Priority::Bulk);
+  map.assign(MetricID::TiltAngle, Priority::Normal);   // spätere Zuordnung gewinnt
+  EXPECT_EQ(map.lane_of(MetricID::TiltAngle), Priority::Normal);
+}
+
+TEST(LaneDispatcher, HighLaneOvertakesQueuedBulk) {
+  MetricBus target;
+  LaneDispatcher::Config cfg;
+  cfg.map.assign(0x1200, 0x12FF, Priority::Bulk);
+  LaneDispatcher lanes(target, cfg);
+
+  std::vector<MetricID> order;
+  auto sub = target.subscribe([&](const Metric& m) { order.push_back(m.metric_id()); });
+
+  lanes.post(mk(MetricID::TiltAngle, 1));
+  lanes.post(mk(MetricID::TiltAngle, 2));
+  lanes.post(mk(MetricID::GasLevelPercent, 3));
+  lanes.post(mk(MetricID::Health, 4));
+
+  EXPECT_EQ(lanes.drain(), 4u);
+  ASSERT_EQ(order.size(), 4u);
+  EXPECT_EQ(order[0], MetricID::Health);
+  EXPECT_EQ(order[1], MetricID::GasLevelPercent);
+  EXPECT_EQ(order[2], MetricID::TiltAngle);
+  EXPECT_EQ(order[3], MetricID::TiltAngle);
+
+  auto hs = lanes.stats(Priority::High);
+  EXPECT_EQ(hs.delivered, 1u);
+  EXPECT_GE(hs.percentile_ns(0.99), hs.lat_max_ns / 2);
+}
+
+TEST(LaneDispatcher, DropPolicyAppliesOnlyToLowerLanes) {
+  MetricBus target;
+  LaneDispatcher::Config cfg;
+  cfg.lanes[static_cast<std::size_t>(Priority::High)]   = {2, LaneDispatcher::DropPolicy::DropNewest};
+  cfg.lanes[static_cast<std::size_t>(Priority::Normal)] = {2, LaneDispatcher::DropPolicy::DropOldest};
+  LaneDispatcher lanes(target, cfg);
+
+  std::vector<uint32_t> seqs;
+  auto sub = target.subscribe([&](const Metric& m) {
+    if (m.metric_id() != MetricID::Health) seqs.push_back(m.seq());
+  });
+
+  for (uint32_t i = 1; i <= 5; ++i) EXPECT_TRUE(lanes.post(mk(MetricID::Health, i)));
+  for (uint32_t i = 1; i <= 5; ++i) lanes.post(mk(MetricID::Temperature, i));
+
+  EXPECT_EQ(lanes.pending(Priority::High), 5u);     // trotz capacity 2
+  EXPECT_EQ(lanes.pending(Priority::Normal), 2u);
+  EXPECT_EQ(lanes.stats(Priority::Normal).dropped, 3u);
+  EXPECT_EQ(lanes.stats(Priority::High).dropped, 0u);
+
+  lanes.drain();
+  ASSERT_EQ(seqs.size(), 2u);
+  EXPECT_EQ(seqs[0], 4u);   // DropOldest: die neuesten bleiben
+  EXPECT_EQ(seqs[1], 5u);
+}
+
+TEST(LaneDispatcher, FeedFromBridgesBuses) {
+  MetricBus source, target;
+  LaneDispatcher lanes(target);
+  auto feed = lanes.feed_from(source);
+
+  int got = 0;
+  auto sub = target.subscribe([&](const Metric&) { ++got; });
+
+  source.publish(mk(MetricID::Temperature, 1));
+  EXPECT_EQ(got, 0);            // gepuffert
+  EXPECT_EQ(lanes.pending(), 1u);
+  lanes.drain();
+  EXPECT_EQ(got, 1);
+}
+
+TEST(LaneDispatcher, SeqTrackingOnTargetMatchesLaneDrops) {
+  MetricBus::Options opt;
+  opt.track_seq = true;
+  MetricBus target(opt);
+  LaneDispatcher::Config cfg;
+  cfg.lanes[static_cast<std::size_t>(Priority::Normal)] = {2, LaneDispatcher::DropPolicy::DropOldest};
+  LaneDispatcher lanes(target, cfg);
+
+  lanes.post(mk(MetricID::Temperature, 1));
+  lanes.drain();
+  for (uint32_t i = 2; i <= 6; ++i) lanes.post(mk(MetricID::Temperature, i));
+  lanes.drain();
+
+  // Verlust am Ziel-Bus sichtbar, ohne die Lanes zu kennen
+  const auto st = target.seq_stats();
+  EXPECT_EQ(st.lost, lanes.stats(Priority::Normal).dropped);
+  EXPECT_EQ(st.lost, 3u);
+  EXPECT_EQ(st.received, 3u);
+}
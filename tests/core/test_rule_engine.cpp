@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <vector>
+
+#include <core/rule_engine.h>
+#include <core/metric_bus.h>
+#include <core/metric.h>
+#include <core/enums.h>
+#include <core/ids.h>
+
+using namespace core;
+
+namespace {
+inline Metric mk(uint32_t inst, MetricID id, Metric::Value v, uint64_t ts, uint32_t seq) {
+  return Metric::Make(inst, id, v, ts, seq, {});
+}
+
+struct AlarmLog {
+  explicit AlarmLog(MetricBus& bus)
+  : sub(bus.subscribe([this](const Metric& m) {
+      if (m.metric_id() == MetricID::Alarm) events.push_back({m.instance_id(), *m.get_if<bool>()});
+    })) {}
+  std::vector<std::pair<uint32_t, bool>> events;
+  Subscription sub;
+};
+} // namespace
+
+TEST(RuleEngine, Below_WithHysteresis) {
+  MetricBus bus;
+  RuleEngine eng(bus);
+  AlarmLog log(bus);
+
+  Rule r;
+  r.metric = MetricID::GasLevelPercent; r.instance = 200;
+  r.op = Rule::Op::Below; r.threshold = 10.0f; r.hysteresis = 1.0f;
+  r.alarm_instance = 9001;
+  eng.load({r});
+
+  bus.publish(mk(200, MetricID::GasLevelPercent, 12.0f, 0, 1));
+  bus.publish(mk(200, MetricID::GasLevelPercent, 9.5f, 1, 2));   // raise
+  bus.publish(mk(200, MetricID::GasLevelPercent, 10.5f, 2, 3));  // innerhalb Hysterese
+  bus.publish(mk(200, MetricID::GasLevelPercent, 11.5f, 3, 4));  // clear
+
+  ASSERT_EQ(log.events.size(), 2u);
+  EXPECT_EQ(log.events[0], std::make_pair(9001u, true));
+  EXPECT_EQ(log.events[1], std::make_pair(9001u, false));
+  EXPECT_FALSE(eng.alarm_active(9001));
+}
+
+TEST(RuleEngine, Debounce_RequiresConditionToHold) {
+  MetricBus bus;
+  RuleEngine eng(bus);
+  AlarmLog log(bus);
+
+  Rule r;
+  r.metric = MetricID::TiltAngle; r.instance = 300;
+  r.op = Rule::Op::Above; r.threshold = 5.0f; r.debounce_ms = 500;
+  r.alarm_instance = 9002;
+  eng.load({r});
+
+  bus.publish(mk(300, MetricID::TiltAngle, 6.0f, 1000, 1));
+  bus.publish(mk(300, MetricID::TiltAngle, 4.0f, 1200, 2));   // Debounce abgebrochen
+  bus.publish(mk(300, MetricID::TiltAngle, 6.0f, 1300, 3));
+  bus.publish(mk(300, MetricID::TiltAngle, 6.0f, 1700, 4));   // erst 400 ms
+  EXPECT_TRUE(log.events.empty());
+  bus.publish(mk(300, MetricID::TiltAngle, 6.0f, 1800, 5));   // 500 ms -> raise
+  ASSERT_EQ(log.events.size(), 1u);
+  EXPECT_TRUE(eng.alarm_active(9002));
+}
+
+TEST(RuleEngine, Debounce_RestartsWhenTimestampGoesBackwards) {
+  MetricBus bus;
+  RuleEngine eng(bus);
+  AlarmLog log(bus);
+
+  Rule r;
+  r.metric = MetricID::TiltAngle; r.instance = 300;
+  r.op = Rule::Op::Above; r.threshold = 5.0f; r.debounce_ms = 500;
+  r.alarm_instance = 9003;
+  eng.load({r});
+
+  bus.publish(mk(300, MetricID::TiltAngle, 6.0f, 10'000, 1));
+  bus.publish(mk(300, MetricID::TiltAngle, 6.0f, 100, 1));    // Quelle neu gestartet
+  EXPECT_TRUE(log.events.empty());                            // kein Unterlauf -> kein Sofort-Alarm
+  bus.publish(mk(300, MetricID::TiltAngle, 6.0f, 400, 2));
+  EXPECT_TRUE(log.events.empty());
+  bus.publish(mk(300, MetricID::TiltAngle, 6.0f, 600, 3));    // 500 ms seit dem Neustart
+  ASSERT_EQ(log.events.size(), 1u);
+  EXPECT_TRUE(eng.alarm_active(9003));
+}
+
+TEST(RuleEngine, SharedAlarmInstance_OneSeqAndOredState) {
+  MetricBus::Options opt;
+  opt.track_seq = true;   // wie der App-Bus des Hubs: doppelte seq würden verworfen
+  MetricBus bus(opt);
+  RuleEngine eng(bus);
+  AlarmLog log(bus);
+
+  Rule lo, hi;
+  lo.metric = hi.metric = MetricID::GasLevelPercent;
+  lo.instance = 200; hi.instance = 201;
+  lo.op = Rule::Op::Below; lo.threshold = 10.0f;
+  hi.op = Rule::Op::Above; hi.threshold = 90.0f;
+  lo.alarm_instance = hi.alarm_instance = 9010;
+  ASSERT_TRUE(eng.load({lo, hi}));
+
+  bus.publish(mk(200, MetricID::GasLevelPercent, 5.0f, 0, 1));    // lo an -> raise
+  bus.publish(mk(201, MetricID::GasLevelPercent, 95.0f, 1, 1));   // hi an, bleibt aktiv
+  EXPECT_TRUE(eng.alarm_active(9010));
+  bus.publish(mk(200, MetricID::GasLevelPercent, 50.0f, 2, 2));   // lo aus, hi noch aktiv
+  EXPECT_TRUE(eng.alarm_active(9010));
+  bus.publish(mk(201, MetricID::GasLevelPercent, 50.0f, 3, 2));   // beide aus -> clear
+  EXPECT_FALSE(eng.alarm_active(9010));
+  bus.publish(mk(201, MetricID::GasLevelPercent, 95.0f, 4, 3));   // hi allein -> raise
+
+  ASSERT_EQ(log.events.size(), 3u);
+  EXPECT_EQ(log.events[0], std::make_pair(9010u, true));
+  EXPECT_EQ(log.events[1], std::make_pair(9010u, false));
+  EXPECT_EQ(log.events[2], std::make_pair(9010u, true));
+  EXPECT_EQ(bus.seq_stats().duplicates, 0u);
+}
+
+TEST(RuleEngine, RulesOnAlarmAreRejected) {
+  MetricBus bus;
+  RuleEngine eng(bus);
+  Rule r;
+  r.metric = MetricID::GasLevelPercent; r.instance = 200; r.alarm_instance = 9001;
+  ASSERT_TRUE(eng.load({r}));
+
+  std::string err;
+  Rule on_alarm = r;
+  on_alarm.metric = MetricID::Alarm;
+  EXPECT_FALSE(eng.load({r, on_alarm}, &err));
+  EXPECT_EQ(err, "rules on Alarm not supported");
+  EXPECT_EQ(eng.rule_count(), 1u);
+
+  std::istringstream by_name("Alarm 9001 == 1 9100\n");
+  EXPECT_FALSE(eng.load_config(by_name, &err));
+  EXPECT_EQ(err, "line 1: rules on Alarm not supported");
+  std::istringstream by_id("0xFF02 9001 == 1 9100\n");
+  EXPECT_FALSE(eng.load_config(by_id, &err));
+  EXPECT_EQ(eng.rule_count(), 1u);
+}
+
+TEST(RuleEngine, OnlyRulesOfPublishedKeyAreEvaluated) {
+  MetricBus bus;
+  RuleEngine eng(bus);
+
+  std::vector<Rule> rules;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    Rule r;
+    r.metric = MetricID::Temperature; r.instance = i;
+    r.op = Rule::Op::Above; r.threshold = 50.0f; r.alarm_instance = 10000 + i;
+    rules.push_back(r);
+  }
+  Rule h;
+  h.metric = MetricID::Health; h.instance = 7; h.op = Rule::Op::NotEqual; h.alarm_instance = 1;
+  rules.push_back(h);
+  rules.push_back(h);   // zwei Regeln auf demselben Schlüssel
+  eng.load(rules);
+
+  EXPECT_EQ(eng.evaluate(mk(42, MetricID::Temperature, 20.0f, 0, 1)), 1u);
+  EXPECT_EQ(eng.evaluate(mk(7, MetricID::Health, int32_t{0}, 0, 1)), 2u);
+  EXPECT_EQ(eng.evaluate(mk(5000, MetricID::Temperature, 20.0f, 0, 1)), 0u);
+}
+
+TEST(RuleEngine, LoadConfig_ParsesAndReportsErrors) {
+  MetricBus bus;
+  RuleEngine eng(bus);
+  AlarmLog log(bus);
+
+  std::istringstream good(
+    "# metric instance op thr [hyst] [debounce] alarm\n"
+    "GasLevelPercent 200 < 10 1 2000 9001\n"
+    "\n"
+    "Health 0x12c != 0 9003   # ohne Hysterese/Debounce\n");
+  std::string err;
+  ASSERT_TRUE(eng.load_config(good, &err)) << err;
+  EXPECT_EQ(eng.rule_count(), 2u);
+
+  bus.publish(mk(300, MetricID::Health, int32_t{3}, 0, 1));
+  ASSERT_EQ(log.events.size(), 1u);
+  EXPECT_EQ(log.events[0], std::make_pair(9003u, true));
+
+  std::istringstream bad("TiltAngle 1 >> 5 9\n");
+  EXPECT_FALSE(eng.load_config(bad, &err));
+  EXPECT_EQ(err, "line 1: bad operator");
+  EXPECT_EQ(eng.rule_count(), 2u);   // alte Regeln bleiben
+}
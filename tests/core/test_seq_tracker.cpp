@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include <core/seq_tracker.h>
+#include <core/metric_bus.h>
+#include <core/metric.h>
+#include <core/ids.h>
+
+using namespace core;
+
+namespace {
+using V = SeqTracker::Verdict;
+
+Metric mk(uint32_t inst, uint32_t seq) {
+  return Metric::Make(inst, MetricID::Temperature, 1.0f, 0, seq);
+}
+} // namespace
+
+TEST(SeqTracker, GapsDuplicatesLateAndReset) {
+  SeqTracker t;
+  EXPECT_EQ(t.observe(1, 10), V::First);
+  EXPECT_EQ(t.observe(1, 11), V::InOrder);
+  EXPECT_EQ(t.observe(1, 11), V::Duplicate);
+  EXPECT_EQ(t.observe(1, 15), V::Gap);        // 12..14 fehlen
+  EXPECT_EQ(t.observe(1, 13), V::Late);       // Nachzügler
+  EXPECT_EQ(t.observe(1, 13), V::Duplicate);  // schon gesehen
+  EXPECT_EQ(t.observe(1, 10), V::Duplicate);  // vor der Lücke gesehen
+  EXPECT_EQ(t.observe(1, 1), V::Reset);       // Neustart der Quelle
+  EXPECT_EQ(t.observe(1, 2), V::InOrder);
+  EXPECT_EQ(t.observe(2, 0), V::Untracked);   // ohne Nummer
+
+  const auto& s = t.stats();
+  EXPECT_EQ(s.instances, 1u);
+  EXPECT_EQ(s.received, 6u);
+  EXPECT_EQ(s.gaps, 1u);
+  EXPECT_EQ(s.lost, 2u);
+  EXPECT_EQ(s.late, 1u);
+  EXPECT_EQ(s.duplicates, 3u);
+  EXPECT_EQ(s.resets, 1u);
+  EXPECT_EQ(s.untracked, 1u);
+  EXPECT_DOUBLE_EQ(s.loss_ratio(), 2.0 / 8.0);
+
+  const SeqTracker::Entry* e = t.find(1);
+  ASSERT_NE(e, nullptr);
+  EXPECT_EQ(e->last_seq, 2u);
+  EXPECT_EQ(e->lost, 2u);
+  EXPECT_EQ(e->duplicates, 3u);
+  EXPECT_EQ(e->resets, 1u);
+  EXPECT_EQ(t.find(2), nullptr);
+}
+
+TEST(SeqTracker, WrapAroundAndFarBackwardsIsReset) {
+  SeqTracker t;
+  EXPECT_EQ(t.observe(7, 0xFFFFFFFEu), V::First);
+  EXPECT_EQ(t.observe(7, 0xFFFFFFFFu), V::InOrder);
+  EXPECT_EQ(t.observe(7, 2), V::Gap);         // modulo 2^32: 0 und 1 zählen als fehlend
+  EXPECT_EQ(t.stats().lost, 2u);
+
+  EXPECT_EQ(t.observe(7, 1000), V::Gap);
+  EXPECT_EQ(t.observe(7, 500), V::Reset);     // außerhalb des 64er-Fensters
+  EXPECT_EQ(t.find(7)->last_seq, 500u);
+}
+
+TEST(SeqTracker, FullTableLeavesNewInstancesUntracked) {
+  SeqTracker::Config cfg;
+  cfg.max_instances = 3;
+  SeqTracker t(cfg);
+  for (uint32_t i = 0; i < 3; ++i) EXPECT_EQ(t.observe(100 + i, 1), V::First);
+  EXPECT_EQ(t.observe(200, 1), V::Untracked);
+  EXPECT_EQ(t.observe(200, 1), V::Untracked);   // nicht verfolgt -> nie Duplicate
+  EXPECT_EQ(t.observe(101, 2), V::InOrder);
+  EXPECT_EQ(t.stats().instances, 3u);
+  EXPECT_EQ(t.stats().untracked, 2u);
+
+  t.clear();
+  EXPECT_EQ(t.stats().instances, 0u);
+  EXPECT_EQ(t.observe(200, 1), V::First);
+}
+
+TEST(MetricBusSeq, DuplicatesDroppedBeforeFanOut) {
+  MetricBus::Options opt;
+  opt.shards    = 2;
+  opt.track_seq = true;
+  MetricBus bus(opt);
+
+  std::vector<uint32_t> got;
+  auto s1 = bus.subscribe([&](const Metric& m) { got.push_back(m.seq()); });
+  int second = 0;
+  auto s2 = bus.subscribe([&](const Metric&) { ++second; });
+
+  for (uint32_t seq : {11u, 12u, 12u, 13u, 15u, 14u, 14u, 16u}) bus.publish(mk(1, seq));
+  bus.publish(mk(2, 1));
+  bus.publish(mk(2, 1));
+
+  EXPECT_EQ(got, (std::vector<uint32_t>{11, 12, 13, 15, 14, 16, 1}));
+  EXPECT_EQ(second, 7);
+
+  const auto st = bus.seq_stats();
+  EXPECT_EQ(st.instances, 2u);
+  EXPECT_EQ(st.received, 7u);
+  EXPECT_EQ(st.duplicates, 3u);
+  EXPECT_EQ(st.gaps, 1u);
+  EXPECT_EQ(st.lost, 0u);   // 14 kam verspätet an
+  EXPECT_EQ(st.late, 1u);
+
+  // ohne track_seq unverändert alles zustellen
+  MetricBus plain;
+  int n = 0;
+  auto s3 = plain.subscribe([&](const Metric&) { ++n; });
+  plain.publish(mk(1, 1));
+  plain.publish(mk(1, 1));
+  EXPECT_EQ(n, 2);
+  EXPECT_EQ(plain.seq_stats().received, 0u);
+}
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include <core/flat_map.h>
+#include <core/inplace_function.h>
+#include <core/static_vector.h>
+#include <core/metric_bus.h>
+#include <core/metric.h>
+#include <core/ids.h>
+
+using namespace core;
+
+#if CARAVAN_STATIC
+// Heap-Allokationen zählen (nur im statischen Profil eingebunden)
+namespace {
+std::atomic<std::size_t> g_allocs{0};
+}
+void* operator new(std::size_t n) {
+  g_allocs.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(n ? n : 1)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+#endif
+
+TEST(StaticVector, CapacityOverflowIsAnError) {
+  StaticVector<int, 3> v;
+  EXPECT_TRUE(v.push_back(1));
+  EXPECT_TRUE(v.push_back(2));
+  EXPECT_TRUE(v.emplace_back(3));
+  EXPECT_TRUE(v.full());
+  EXPECT_FALSE(v.push_back(4));
+  EXPECT_EQ(v.size(), 3u);
+  EXPECT_EQ(v.max_size(), 3u);
+
+  v.erase(v.begin(), v.begin() + 2);
+  ASSERT_EQ(v.size(), 1u);
+  EXPECT_EQ(v[0], 3);
+
+  EXPECT_FALSE(v.resize(5, 7));   // auf die Kapazität begrenzt
+  EXPECT_EQ(v, (StaticVector<int, 3>{3, 7, 7}));
+  EXPECT_TRUE(v.assign(2, 9));
+  EXPECT_EQ(v, (StaticVector<int, 3>{9, 9}));
+  const int src[] = {1, 2, 3, 4};
+  EXPECT_FALSE(v.assign(std::begin(src), std::end(src)));
+  EXPECT_EQ(v.size(), 3u);
+}
+
+TEST(StaticVector, DestroysElements) {
+  auto token = std::make_shared<int>(0);
+  {
+    StaticVector<std::shared_ptr<int>, 4> v;
+    v.push_back(token);
+    v.push_back(token);
+    StaticVector<std::shared_ptr<int>, 4> w = v;
+    EXPECT_EQ(token.use_count(), 5);
+    w = std::move(v);
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(token.use_count(), 3);
+  }
+  EXPECT_EQ(token.use_count(), 1);
+}
+
+TEST(FlatMap, EmplaceFindAndOverflow) {
+  FlatMap<PropertyKey, int, 2> m;
+  EXPECT_TRUE(m.emplace(PropertyKey::Unit, 1).second);
+  EXPECT_FALSE(m.emplace(PropertyKey::Unit, 5).second);   // wie unordered_map: kein Überschreiben
+  EXPECT_EQ(m.find(PropertyKey::Unit)->second, 1);
+  EXPECT_TRUE(m.emplace(PropertyKey::Quality, 2).second);
+
+  auto full = m.emplace(PropertyKey::Scale, 3);
+  EXPECT_FALSE(full.second);
+  EXPECT_EQ(full.first, m.end());
+  EXPECT_EQ(m.find(PropertyKey::Scale), m.end());
+
+  FlatMap<PropertyKey, int, 2> other{{PropertyKey::Quality, 2}, {PropertyKey::Unit, 1}};
+  EXPECT_EQ(m, other);   // Reihenfolge egal
+  EXPECT_EQ(m.erase(PropertyKey::Unit), 1u);
+  EXPECT_NE(m, other);
+}
+
+TEST(InplaceFunction, CallCopyMoveReset) {
+  auto token = std::make_shared<int>(41);
+  using Fn = InplaceFunction<int(int), 32>;
+  Fn f = [token](int d) { return *token + d; };
+  EXPECT_TRUE(static_cast<bool>(f));
+  EXPECT_EQ(f(1), 42);
+
+  Fn g = f;
+  EXPECT_EQ(token.use_count(), 3);
+  Fn h = std::move(f);
+  EXPECT_FALSE(static_cast<bool>(f));
+  EXPECT_EQ(h(2), 43);
+  EXPECT_EQ(token.use_count(), 3);
+
+  g = nullptr;
+  h = nullptr;
+  EXPECT_EQ(token.use_count(), 1);
+  EXPECT_FALSE(static_cast<bool>(g));
+}
+
+#if CARAVAN_STATIC
+
+TEST(StaticProfile, SubscriberLimitReportedNotAllocated) {
+  MetricBus bus;
+  int hits = 0;
+  std::vector<Subscription> subs;
+  for (std::size_t i = 0; i < caps::kMaxSubscribers; ++i) {
+    subs.push_back(bus.subscribe([&hits](const Metric&) { ++hits; }));
+    ASSERT_TRUE(static_cast<bool>(subs.back()));
+  }
+  Subscription extra = bus.subscribe([&hits](const Metric&) { hits += 100; });
+  EXPECT_FALSE(static_cast<bool>(extra));
+  EXPECT_EQ(bus.capacity_overflows(), 1u);
+  EXPECT_EQ(bus.subscriber_count(), caps::kMaxSubscribers);
+
+  bus.publish(Metric::Make(1, MetricID::Temperature, 20.0f, 0, 1));
+  EXPECT_EQ(hits, static_cast<int>(caps::kMaxSubscribers));
+
+  // freigegebene Slots (und Grabsteine im Shard) werden wiederverwendet
+  for (int round = 0; round < 5; ++round) {
+    subs[round].unsubscribe();
+    subs[round] = bus.subscribe([&hits](const Metric&) { ++hits; });
+    EXPECT_TRUE(static_cast<bool>(subs[round]));
+  }
+  EXPECT_EQ(bus.capacity_overflows(), 1u);
+  hits = 0;
+  bus.publish(Metric::Make(1, MetricID::Temperature, 20.0f, 0, 2));
+  EXPECT_EQ(hits, static_cast<int>(caps::kMaxSubscribers));
+}
+
+TEST(StaticProfile, PublishDoesNotAllocate) {
+  MetricBus::Options opt;
+  opt.shards = 2;
+  MetricBus bus(opt);
+  float sum = 0.0f;
+  auto s1 = bus.subscribe([&sum](const Metric& m) { sum += *m.get_if<float>(); });
+  auto s2 = bus.subscribe(MetricID::Temperature, [&sum](const Metric&) { sum += 1.0f; });
+
+  Metric::PropMap p;
+  p.emplace(PropertyKey::Unit, static_cast<uint8_t>(Unit::Celsius));
+  p.emplace(PropertyKey::Quality, static_cast<uint8_t>(Quality::Good));
+  const Metric m = Metric::Make(3, MetricID::Temperature, 1.5f, 0, 1, p);
+
+  // erster publish() eines Threads: die Laufzeit registriert ggf. den
+  // Destruktor der thread_local-Frames (einmalig)
+  bus.publish(m);
+  const std::size_t before = g_allocs.load();
+  for (int i = 0; i < 1000; ++i) bus.publish(m);
+  EXPECT_EQ(g_allocs.load(), before);
+  EXPECT_FLOAT_EQ(sum, 2502.5f);
+}
+
+TEST(StaticProfile, DeferredQueueReusesConsumedEntries) {
+  MetricBus::Options opt;
+  opt.reentrancy = MetricBus::Reentrancy::Deferred;
+  MetricBus bus(opt);
+
+  // Kette: jede Metric erzeugt die nächste -> höchstens ein Eintrag ausstehend,
+  // insgesamt mehr als CARAVAN_MAX_DEFERRED
+  const uint32_t chain = static_cast<uint32_t>(caps::kMaxDeferred) * 3;
+  uint32_t seen = 0;
+  auto s = bus.subscribe([&](const Metric& m) {
+    ++seen;
+    if (m.seq() < chain) bus.publish(Metric::Make(1, MetricID::Temperature, 0.0f, 0, m.seq() + 1));
+  });
+  bus.publish(Metric::Make(1, MetricID::Temperature, 0.0f, 0, 1));
+  EXPECT_EQ(seen, chain);
+  EXPECT_EQ(bus.reentrancy_overflows(), 0u);
+
+  // Fan-out über die Kapazität: der Rest wird verworfen und gezählt
+  MetricBus fan_bus(opt);
+  uint32_t tilt = 0;
+  auto fan = fan_bus.subscribe(MetricID::Health, [&](const Metric&) {
+    for (std::size_t i = 0; i < caps::kMaxDeferred + 2; ++i)
+      fan_bus.publish(Metric::Make(2, MetricID::TiltAngle, 0.0f, 0, 1));
+  });
+  auto count = fan_bus.subscribe(MetricID::TiltAngle, [&](const Metric&) { ++tilt; });
+  fan_bus.publish(Metric::Make(2, MetricID::Health, int32_t{0}, 0, 1));
+  EXPECT_EQ(fan_bus.reentrancy_overflows(), 2u);
+  EXPECT_EQ(tilt, caps::kMaxDeferred);
+}
+
+#endif // CARAVAN_STATIC
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include <core/stream_ops.h>
+#include <core/metric_bus.h>
+#include <core/metric.h>
+#include <core/enums.h>
+#include <core/ids.h>
+
+using namespace core;
+using namespace core::stream;
+
+namespace {
+inline Metric mk_tilt(uint32_t inst, float deg, uint64_t ts, uint32_t seq) {
+  Metric::PropMap p;
+  p.emplace(PropertyKey::Unit,    static_cast<uint8_t>(Unit::Degree));
+  p.emplace(PropertyKey::Quality, static_cast<uint8_t>(Quality::Good));
+  return Metric::Make(inst, MetricID::TiltAngle, deg, ts, seq, std::move(p));
+}
+} // namespace
+
+TEST(StreamOps, MovingAverage_Window) {
+  MovingAverage ma(3);
+  EXPECT_FLOAT_EQ(ma.push(3.0f), 3.0f);
+  EXPECT_FLOAT_EQ(ma.push(6.0f), 4.5f);
+  EXPECT_FLOAT_EQ(ma.push(9.0f), 6.0f);
+  EXPECT_FLOAT_EQ(ma.push(12.0f), 9.0f);  // 3 fällt raus
+}
+
+TEST(StreamOps, Ewma_FirstSampleInitializes) {
+  Ewma e(0.5f);
+  EXPECT_FLOAT_EQ(e.push(10.0f), 10.0f);
+  EXPECT_FLOAT_EQ(e.push(20.0f), 15.0f);
+  EXPECT_FLOAT_EQ(e.push(20.0f), 17.5f);
+}
+
+TEST(StreamOps, WindowMinMax) {
+  WindowMin mn(3);
+  WindowMax mx(3);
+  const float xs[] = {5, 1, 4, 7, 2, 8, 3, 3};
+  const float exp_min[] = {5, 1, 1, 1, 2, 2, 2, 3};
+  const float exp_max[] = {5, 5, 5, 7, 7, 8, 8, 8};
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_FLOAT_EQ(mn.push(xs[i]), exp_min[i]) << "i=" << i;
+    EXPECT_FLOAT_EQ(mx.push(xs[i]), exp_max[i]) << "i=" << i;
+  }
+}
+
+TEST(StreamOps, RateOfChange_PerSecond) {
+  RateOfChange r;
+  EXPECT_FLOAT_EQ(r.push(1.0f, 1000), 0.0f);
+  EXPECT_FLOAT_EQ(r.push(2.0f, 1500), 2.0f);
+  EXPECT_FLOAT_EQ(r.push(2.0f, 1500), 2.0f); // gleicher ts -> Rate bleibt
+  EXPECT_FLOAT_EQ(r.push(1.0f, 2500), -1.0f);
+}
+
+TEST(StreamOps, MedianFilter_RejectsSpikes) {
+  MedianFilter mf(3);
+  EXPECT_FLOAT_EQ(mf.push(1.0f), 1.0f);
+  EXPECT_FLOAT_EQ(mf.push(3.0f), 2.0f);
+  EXPECT_FLOAT_EQ(mf.push(100.0f), 3.0f);
+  EXPECT_FLOAT_EQ(mf.push(2.0f), 3.0f);   // {3,100,2}
+  EXPECT_FLOAT_EQ(mf.push(2.0f), 2.0f);   // {100,2,2}
+}
+
+TEST(StreamOps, Chain_AppliesInOrder) {
+  Chain<MedianFilter, MovingAverage> c(MedianFilter(3), MovingAverage(2));
+  c.push(1.0f);
+  c.push(1.0f);
+  EXPECT_FLOAT_EQ(c.push(50.0f), 1.0f);   // Spike vom Median geschluckt
+}
+
+TEST(StreamOps, DerivedMetric_RepublishesSmoothedValue) {
+  MetricBus bus;
+  DerivedMetric<MovingAverage> node(bus, {10, MetricID::TiltAngle},
+                                    {11, MetricID::TiltAngleSmoothed}, MovingAverage(2));
+
+  std::vector<Metric> got;
+  auto sub = bus.subscribe([&](const Metric& m) {
+    if (m.metric_id() == MetricID::TiltAngleSmoothed) got.push_back(m);
+  });
+
+  bus.publish(mk_tilt(10, 2.0f, 100, 1));
+  bus.publish(mk_tilt(99, 50.0f, 110, 1));   // andere Instanz -> ignoriert
+  bus.publish(mk_tilt(10, 4.0f, 120, 2));
+
+  ASSERT_EQ(got.size(), 2u);
+  EXPECT_EQ(got[1].instance_id(), 11u);
+  EXPECT_FLOAT_EQ(*got[1].get_if<float>(), 3.0f);
+  EXPECT_EQ(got[1].timestamp_ms(), 120u);
+  EXPECT_EQ(got[1].seq(), 2u);
+  EXPECT_EQ(got[1].try_get_prop<uint8_t>(PropertyKey::Unit), static_cast<uint8_t>(Unit::Degree));
+}
+
+TEST(StreamOps, EwmaBank_MatchesScalar) {
+  constexpr std::size_t kCh = 13;
+  EwmaBank bank(kCh, 0.25f);
+  std::vector<Ewma> ref(kCh, Ewma(0.25f));
+
+  std::vector<float> x(kCh), r(kCh);
+  for (int step = 0; step < 20; ++step) {
+    for (std::size_t i = 0; i < kCh; ++i) x[i] = static_cast<float>((step * 7 + i * 3) % 11);
+    bank.update(x.data());
+    for (std::size_t i = 0; i < kCh; ++i) r[i] = ref[i].push(x[i]);
+  }
+  for (std::size_t i = 0; i < kCh; ++i) EXPECT_FLOAT_EQ(bank.values()[i], r[i]);
+}
+
+TEST(StreamOps, MovingAverageBank_MatchesScalar) {
+  constexpr std::size_t kCh = 9;
+  MovingAverageBank bank(kCh, 4);
+  std::vector<MovingAverage> ref(kCh, MovingAverage(4));
+
+  std::vector<float> x(kCh), m(kCh), r(kCh);
+  for (int step = 0; step < 25; ++step) {
+    for (std::size_t i = 0; i < kCh; ++i) {
+      x[i] = static_cast<float>((step * 5 + i) % 17);
+      r[i] = ref[i].push(x[i]);
+    }
+    bank.update(x.data());
+    bank.means(m.data());
+    for (std::size_t i = 0; i < kCh; ++i) EXPECT_NEAR(m[i], r[i], 1e-4f);
+  }
+}
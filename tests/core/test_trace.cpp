@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <core/trace.h>
+#include <core/metric_bus.h>
+#include <core/metric.h>
+#include <core/ids.h>
+
+using namespace core;
+
+namespace {
+
+std::size_t count_of(const std::string& s, const std::string& needle) {
+  std::size_t n = 0;
+  for (auto pos = s.find(needle); pos != std::string::npos; pos = s.find(needle, pos + 1)) ++n;
+  return n;
+}
+
+std::string dump() {
+  std::ostringstream os;
+  trace::write_chrome_json(os);
+  return os.str();
+}
+
+// feste Zeitbasis für reproduzierbare Zeitstempel
+std::atomic<uint64_t> g_fake_ns{0};
+uint64_t fake_now() { return g_fake_ns.fetch_add(1000); }
+
+} // namespace
+
+TEST(Trace, DisabledRecordsNothing) {
+  trace::start();
+  trace::stop();
+  EXPECT_FALSE(trace::enabled());
+  {
+    CARAVAN_TRACE_SCOPE("test.idle");
+    CARAVAN_TRACE_COUNTER("test.counter", 1);
+  }
+  EXPECT_EQ(trace::event_count(), 0u);
+}
+
+TEST(Trace, SpansAndCountersAsChromeJson) {
+  trace::set_time_source(&fake_now);
+  g_fake_ns = 5'000'000;
+  trace::start();
+  trace::set_thread_name("main \"test\"");
+  {
+    CARAVAN_TRACE_SCOPE_ARG("test.outer", 42);
+    { CARAVAN_TRACE_SCOPE("test.inner"); }
+    CARAVAN_TRACE_COUNTER("test.queue", 7);
+  }
+  trace::stop();
+  trace::set_time_source(nullptr);
+
+  EXPECT_EQ(trace::event_count(), 3u);
+  const std::string js = dump();
+  EXPECT_EQ(js.rfind("{\"traceEvents\":[", 0), 0u);
+  EXPECT_NE(js.find("\"displayTimeUnit\":\"ns\"}"), std::string::npos);
+  EXPECT_NE(js.find("\"thread_name\""), std::string::npos);
+  EXPECT_NE(js.find("main \\\"test\\\""), std::string::npos);
+  // outer: start 5000 µs, Ende nach inner (2 Ticks) + Counter (1 Tick) -> 4 µs
+  EXPECT_NE(js.find("{\"name\":\"test.outer\",\"ph\":\"X\""), std::string::npos);
+  EXPECT_NE(js.find("\"ts\":5000.000,\"dur\":4.000,\"args\":{\"arg\":42}"), std::string::npos);
+  EXPECT_NE(js.find("\"ts\":5001.000,\"dur\":1.000"), std::string::npos);
+  EXPECT_NE(js.find("{\"name\":\"test.queue\",\"ph\":\"C\""), std::string::npos);
+  EXPECT_NE(js.find("\"args\":{\"value\":7}"), std::string::npos);
+}
+
+TEST(Trace, RingKeepsNewestEvents) {
+  trace::start(/*events_per_thread*/ 16);
+  std::thread t([] {
+    for (int i = 0; i < 100; ++i) CARAVAN_TRACE_COUNTER("test.wrap", i);
+  });
+  t.join();
+  trace::stop();
+  const std::string js = dump();
+  // ein Platz bleibt als Puffer gegen einen laufenden Schreibvorgang frei
+  EXPECT_EQ(count_of(js, "\"test.wrap\""), 15u);
+  EXPECT_NE(js.find("\"value\":99}"), std::string::npos);
+  EXPECT_EQ(js.find("\"value\":84}"), std::string::npos);
+  EXPECT_NE(js.find("\"value\":85}"), std::string::npos);
+}
+
+TEST(Trace, PerThreadRings_DumpWhileRecording) {
+  trace::start(1024);
+  std::atomic<bool> go{true};
+  std::atomic<int>  running{0};
+  std::vector<std::thread> ths;
+  for (int t = 0; t < 4; ++t)
+    ths.emplace_back([&] {
+      ++running;
+      do { CARAVAN_TRACE_SCOPE("test.busy"); } while (go.load());
+    });
+  while (running.load() < 4) std::this_thread::yield();
+  // Export während die Threads schreiben: nur vollständige Events
+  for (int i = 0; i < 5; ++i) {
+    const std::string js = dump();
+    EXPECT_EQ(js.find("\"name\":\"\""), std::string::npos);
+  }
+  go = false;
+  for (auto& th : ths) th.join();
+  trace::stop();
+  EXPECT_GE(trace::event_count(), 4u);
+  EXPECT_LE(trace::event_count(), 4u * 1024u + 64u);
+}
+
+TEST(Trace, RingsOnlyWhileRecordingAndReusedAfterThreadExit) {
+  trace::start(64);
+  trace::stop();
+  // Name ohne Aufzeichnung: kein Ring, taucht im Export nicht auf
+  std::thread([] { trace::set_thread_name("idle"); }).join();
+
+  trace::start(64);
+  for (int i = 0; i < 20; ++i) {
+    std::thread([i] {
+      trace::set_thread_name(i == 19 ? "last" : "worker");
+      CARAVAN_TRACE_COUNTER("test.worker", i);
+    }).join();
+  }
+  trace::stop();
+
+  const std::string js = dump();
+  EXPECT_EQ(js.find("\"idle\""), std::string::npos);
+  // nacheinander laufende Threads teilen sich einen Ring
+  EXPECT_EQ(count_of(js, "\"test.worker\""), 1u);
+  EXPECT_EQ(js.find("\"worker\""), std::string::npos);
+  EXPECT_EQ(count_of(js, "\"last\""), 1u);
+  EXPECT_NE(js.find("\"value\":19}"), std::string::npos);
+}
+
+TEST(Trace, MetricBusPublishAndCallbacks) {
+  MetricBus bus;
+  auto s1 = bus.subscribe([](const Metric&) {});
+  auto s2 = bus.subscribe([](const Metric&) { CARAVAN_TRACE_SCOPE("test.slow_subscriber"); });
+
+  trace::start();
+  bus.publish(Metric::Make(1, MetricID::TiltAngle, 1.0f, 0, 1));
+  trace::stop();
+
+  const std::string js = dump();
+  EXPECT_EQ(count_of(js, "\"bus.publish\""), 1u);
+  EXPECT_EQ(count_of(js, "\"bus.callback\""), 2u);
+  EXPECT_EQ(count_of(js, "\"test.slow_subscriber\""), 1u);
+  EXPECT_NE(js.find("\"arg\":4609}"), std::string::npos);   // MetricID::TiltAngle
+}
@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <core/metric_bus.h>
+#include <core/metric.h>
+#include <core/ids.h>
+
+#include "coro.h"
+#include "tilt_wt901c.h"
+#include "clock.h"
+#include "modbus.h"
+
+using namespace core;
+using namespace devices;
+using namespace devices::coro;
+
+namespace {
+
+class ManualClock : public IClock {
+public:
+  uint64_t now{0};
+  uint64_t millis64() override { return now; }
+};
+
+class LogModbus : public IModbusClient {
+public:
+  std::vector<std::string> log;
+  bool ok{true};
+  bool read_holding(uint8_t addr, uint16_t reg, uint16_t n, ModbusRegs& out, uint32_t) override {
+    log.push_back(std::to_string(addr) + ":" + std::to_string(reg));
+    if (!ok) return false;
+    out.assign(n, static_cast<uint16_t>(reg));
+    return true;
+  }
+};
+
+// mehrstufige Sequenz: Block lesen, warten, erneut lesen, Summe liefern
+Task<int> read_twice(Scheduler& s, IModbusClient& mb, uint8_t addr) {
+  ModbusRegs regs;
+  int sum = 0;
+  if (!co_await s.read_holding(mb, addr, 10, 1, regs, 20)) co_return -1;
+  sum += regs[0];
+  co_await s.sleep_for(100);
+  if (!co_await s.read_holding(mb, addr, 20, 1, regs, 20)) co_return -1;
+  sum += regs[0];
+  co_return sum;
+}
+
+Task<> driver(Scheduler& s, IModbusClient& mb, uint8_t addr, std::vector<int>& results) {
+  while (!s.stopping()) {
+    results.push_back(co_await read_twice(s, mb, addr));
+    co_await s.sleep_for(400);
+  }
+}
+
+Task<> idle_driver(Scheduler& s, int& wakeups) {
+  while (!s.stopping()) {
+    co_await s.sleep_for(1000);
+    ++wakeups;
+  }
+}
+
+} // namespace
+
+TEST(Coro, NestedTasksInterleaveOnOneBus) {
+  ManualClock clk;
+  LogModbus mb;
+  Scheduler s(clk);
+  std::vector<int> ra, rb;
+  s.spawn(driver(s, mb, 1, ra));
+  s.spawn(driver(s, mb, 2, rb));
+  EXPECT_EQ(s.task_count(), 2u);
+
+  s.run_once();
+  EXPECT_EQ(mb.log, (std::vector<std::string>{"1:10", "2:10"}));
+  EXPECT_EQ(s.next_wakeup_ms(), 100u);
+
+  clk.now = 99;
+  EXPECT_EQ(s.run_once(), 0u);
+  clk.now = 100;
+  s.run_once();
+  EXPECT_EQ(ra, (std::vector<int>{30}));
+  EXPECT_EQ(rb, (std::vector<int>{30}));
+  EXPECT_EQ(s.next_wakeup_ms(), 500u);
+  EXPECT_EQ(s.transactions(), 4u);
+
+  mb.ok = false;
+  clk.now = 500;
+  s.run_once();
+  EXPECT_EQ(ra.back(), -1);
+
+  s.stop();
+  clk.now = 900;
+  s.run_once();
+  EXPECT_EQ(s.task_count(), 0u);
+}
+
+TEST(Coro, TimersFireInDeadlineOrder) {
+  ManualClock clk;
+  Scheduler s(clk);
+  std::vector<int> order;
+  auto sleeper = [](Scheduler& s, uint32_t ms, int tag, std::vector<int>& order) -> Task<> {
+    co_await s.sleep_for(ms);
+    order.push_back(tag);
+  };
+  s.spawn(sleeper(s, 30, 3, order));
+  s.spawn(sleeper(s, 10, 1, order));
+  s.spawn(sleeper(s, 20, 2, order));
+  s.spawn(sleeper(s, 10, 4, order));   // gleiche Deadline: Reihenfolge des Einreihens
+  s.run_once();
+  clk.now = 50;
+  s.run_once();
+  EXPECT_EQ(order, (std::vector<int>{1, 4, 2, 3}));
+  EXPECT_EQ(s.task_count(), 0u);
+  EXPECT_EQ(s.next_wakeup_ms(), UINT64_MAX);
+}
+
+TEST(Coro, ThousandsOfDriversInPooledFrames) {
+  constexpr int kDrivers = 5000;
+  ManualClock clk;
+  const auto& pool = FramePool::local();
+  const std::size_t live0 = pool.live_frames();
+  int wakeups = 0;
+  {
+    Scheduler s(clk);
+    for (int i = 0; i < kDrivers; ++i) s.spawn(idle_driver(s, wakeups));
+    s.run_once();
+    EXPECT_EQ(pool.live_frames() - live0, static_cast<std::size_t>(kDrivers));
+    EXPECT_EQ(pool.heap_fallbacks(), 0u);
+    // kleine Frames, dicht gepackt
+    EXPECT_LE(pool.reserved_bytes() / kDrivers, 256u);
+
+    clk.now = 1000;
+    s.run_once();
+    EXPECT_EQ(wakeups, kDrivers);
+  }
+  // Scheduler zerstört -> alle Frames zurück im Pool
+  EXPECT_EQ(pool.live_frames(), live0);
+
+  // Wiederverwendung: kein neuer Speicher für die nächste Generation
+  const std::size_t reserved = pool.reserved_bytes();
+  Scheduler s2(clk);
+  for (int i = 0; i < kDrivers; ++i) s2.spawn(idle_driver(s2, wakeups));
+  EXPECT_EQ(pool.reserved_bytes(), reserved);
+}
+
+TEST(Coro, Wt901cPollLoopAsCoroutine) {
+  MetricBus bus;
+  ManualClock clk;
+  LogModbus mb;
+  Scheduler s(clk);
+
+  Wt901cDevice::Config cfg;
+  cfg.modbus_addr      = 5;
+  cfg.start_reg        = 150;   // 1.50°
+  cfg.reg_count        = 1;
+  cfg.poll_interval_ms = 50;
+  Wt901cDevice dev(bus, 9, mb, cfg);
+
+  std::vector<Metric> got;
+  auto sub = bus.subscribe([&](const Metric& m) { got.push_back(m); });
+
+  s.spawn(dev.run(s));
+  for (clk.now = 0; clk.now < 500; clk.now += 10) s.run_once();
+  EXPECT_EQ(got.size(), 10u);
+  EXPECT_FLOAT_EQ(*got.front().get_if<float>(), 1.5f);
+  EXPECT_EQ(got.back().timestamp_ms(), 450u);
+
+  s.stop();
+  clk.now += 50;
+  s.run_once();
+  EXPECT_EQ(s.task_count(), 0u);
+}
+
+TEST(Coro, Wt901cAdaptiveBackoffMatchesTick) {
+  MetricBus bus;
+  ManualClock clk;
+  LogModbus mb;
+  Scheduler s(clk);
+
+  Wt901cDevice::Config cfg;
+  cfg.adaptive             = true;
+  cfg.reg_count            = 1;
+  cfg.poll.backoff_base_ms = 100;
+  cfg.poll.backoff_max_ms  = 400;
+  cfg.poll.jitter          = 0.0f;
+  Wt901cDevice dev(bus, 3, mb, cfg);
+  s.spawn(dev.run(s));
+
+  s.run_once();
+  mb.ok = false;
+  for (clk.now = 10; clk.now <= 2000; clk.now += 10) s.run_once();
+  // wie tick(): Versuche bei 0, 50, 150, 350, 750, 1150, 1550, 1950
+  EXPECT_EQ(mb.log.size(), 8u);
+  EXPECT_EQ(dev.poll_policy().failures(), 7u);
+}
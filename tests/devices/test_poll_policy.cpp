@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include <core/metric_bus.h>
+#include <core/metric.h>
+#include <core/enums.h>
+#include <core/ids.h>
+
+#include "poll_policy.h"
+#include "tilt_wt901c.h"
+#include "modbus.h"
+
+using namespace core;
+using namespace devices;
+
+namespace {
+
+class ScriptedModbus : public IModbusClient {
+public:
+  bool     ok{true};
+  uint16_t value{100};
+  int      reads{0};
+  bool read_holding(uint8_t, uint16_t, uint16_t n, ModbusRegs& out, uint32_t) override {
+    ++reads;
+    if (!ok) return false;
+    out.assign(n, value);
+    return true;
+  }
+};
+
+inline Quality quality_of(const Metric& m) {
+  return static_cast<Quality>(m.try_get_prop<uint8_t>(PropertyKey::Quality).value_or(0));
+}
+
+} // namespace
+
+TEST(AdaptivePollPolicy, SlowsDownWhenStable_SpeedsUpWhenMoving) {
+  AdaptivePollPolicy::Config cfg;
+  cfg.min_interval_ms = 50;
+  cfg.max_interval_ms = 800;
+  cfg.growth          = 2.0f;
+  cfg.fast_rate_per_s = 0.5f;
+  AdaptivePollPolicy p(cfg);
+
+  uint64_t t = 0;
+  p.on_success(t, 1.0f);
+  EXPECT_EQ(p.interval_ms(), 50u);
+  for (int i = 0; i < 10; ++i) {
+    t = p.next_due_ms();
+    p.on_success(t, 1.0f);
+  }
+  EXPECT_EQ(p.interval_ms(), 800u);
+  EXPECT_FALSE(p.due(t + 799));
+  EXPECT_TRUE(p.due(t + 800));
+
+  // 1 Grad in 800 ms = 1.25 Grad/s -> sofort wieder schnell
+  t += 800;
+  p.on_success(t, 2.0f);
+  EXPECT_EQ(p.interval_ms(), 50u);
+  EXPECT_EQ(p.quality(), Quality::Good);
+}
+
+TEST(AdaptivePollPolicy, ExponentialBackoffWithJitter_AndQuality) {
+  AdaptivePollPolicy::Config cfg;
+  cfg.backoff_base_ms = 100;
+  cfg.backoff_max_ms  = 1000;
+  cfg.jitter          = 0.2f;
+  cfg.bad_after       = 3;
+  AdaptivePollPolicy p(cfg);
+
+  const uint32_t expected[] = {100, 200, 400, 800, 1000, 1000};
+  for (uint32_t base : expected) {
+    p.on_failure(0);
+    EXPECT_GE(p.next_due_ms(), static_cast<uint64_t>(base * 0.8f));
+    EXPECT_LE(p.next_due_ms(), static_cast<uint64_t>(base * 1.2f));
+  }
+  EXPECT_EQ(p.failures(), 6u);
+  EXPECT_EQ(p.quality(), Quality::Bad);
+
+  AdaptivePollPolicy q(cfg);
+  q.on_failure(0);
+  EXPECT_EQ(q.quality(), Quality::Uncertain);
+  q.on_success(10, 0.0f);
+  EXPECT_EQ(q.quality(), Quality::Good);
+  EXPECT_EQ(q.failures(), 0u);
+}
+
+TEST(AdaptivePollPolicy, JitterSpreadsDevices) {
+  AdaptivePollPolicy::Config a, b;
+  a.seed = 1;
+  b.seed = 2;
+  AdaptivePollPolicy pa(a), pb(b);
+  int differ = 0;
+  for (int i = 0; i < 4; ++i) {
+    pa.on_failure(0);
+    pb.on_failure(0);
+    differ += pa.next_due_ms() != pb.next_due_ms();
+  }
+  EXPECT_GE(differ, 3);
+}
+
+TEST(BusBudget, BurstThenRateLimited) {
+  BusBudget b(/*rate*/ 10.0f, /*burst*/ 3.0f);
+  EXPECT_TRUE(b.try_acquire(0));
+  EXPECT_TRUE(b.try_acquire(0));
+  EXPECT_TRUE(b.try_acquire(0));
+  EXPECT_FALSE(b.try_acquire(0));
+  EXPECT_EQ(b.ms_until_token(0), 100u);
+  EXPECT_FALSE(b.try_acquire(99));
+  EXPECT_TRUE(b.try_acquire(100));
+  EXPECT_EQ(b.granted(), 4u);
+  EXPECT_EQ(b.denied(), 2u);
+}
+
+TEST(WT901C, Adaptive_ParkedCaravanPollsLess) {
+  MetricBus bus;
+  ScriptedModbus fixed_mb, adaptive_mb;
+
+  Wt901cDevice::Config fixed_cfg;   // 50 ms fest
+  Wt901cDevice::Config adaptive_cfg;
+  adaptive_cfg.adaptive = true;
+  Wt901cDevice fixed(bus, 1, fixed_mb, fixed_cfg);
+  Wt901cDevice adaptive(bus, 2, adaptive_mb, adaptive_cfg);
+
+  // 10 s geparkt: Winkel konstant
+  for (uint64_t t = 0; t <= 10'000; t += 10) {
+    fixed.tick(t);
+    adaptive.tick(t);
+  }
+  EXPECT_GE(fixed_mb.reads, 190);
+  EXPECT_LT(adaptive_mb.reads, fixed_mb.reads / 5);
+
+  // Nivellieren: Winkel ändert sich laufend -> zurück auf min_interval
+  const int before = adaptive_mb.reads;
+  uint64_t t = 10'000;
+  for (int i = 0; i < 200; ++i, t += 10) {
+    adaptive_mb.value = static_cast<uint16_t>(100 + i * 5);   // 0.05 Grad pro 10 ms
+    adaptive.tick(t);
+  }
+  EXPECT_GE(adaptive_mb.reads - before, 30);   // ~2 s / 50 ms, nach Anlauf
+  EXPECT_EQ(adaptive.poll_policy().interval_ms(), 50u);
+}
+
+TEST(WT901C, Adaptive_BacksOffAndDegradesQuality) {
+  MetricBus bus;
+  ScriptedModbus mb;
+  Wt901cDevice::Config cfg;
+  cfg.adaptive              = true;
+  cfg.poll.backoff_base_ms  = 100;
+  cfg.poll.backoff_max_ms   = 400;
+  cfg.poll.jitter           = 0.0f;
+  cfg.poll.bad_after        = 2;
+  Wt901cDevice dev(bus, 7, mb, cfg);
+
+  std::vector<Metric> got;
+  auto sub = bus.subscribe([&](const Metric& m) { got.push_back(m); });
+
+  dev.tick(0);
+  ASSERT_EQ(got.size(), 1u);
+  EXPECT_EQ(quality_of(got[0]), Quality::Good);
+
+  mb.ok = false;
+  for (uint64_t t = 10; t <= 2000; t += 10) dev.tick(t);
+  // Versuche bei 50, 150, 350, 750, 1150, 1550, 1950 statt alle 50 ms
+  EXPECT_EQ(mb.reads, 1 + 7);
+  ASSERT_EQ(got.size(), 1u + 7u);
+  EXPECT_EQ(quality_of(got[1]), Quality::Uncertain);
+  EXPECT_EQ(quality_of(got[2]), Quality::Bad);
+  EXPECT_FLOAT_EQ(*got[2].get_if<float>(), 1.0f);   // letzter gültiger Wert
+
+  mb.ok = true;
+  for (uint64_t t = 2010; t <= 2400; t += 10) dev.tick(t);
+  EXPECT_EQ(quality_of(got.back()), Quality::Good);
+}
+
+TEST(WT901C, Adaptive_HonorsBusBudget) {
+  MetricBus bus;
+  ScriptedModbus mb;
+  BusBudget budget(/*rate*/ 20.0f, /*burst*/ 1.0f);
+
+  std::vector<std::unique_ptr<Wt901cDevice>> devs;
+  for (uint32_t i = 0; i < 4; ++i) {
+    Wt901cDevice::Config cfg;
+    cfg.adaptive = true;
+    cfg.budget   = &budget;
+    cfg.poll.max_interval_ms = 50;   // würden zusammen 80 Reads/s wollen
+    devs.push_back(std::make_unique<Wt901cDevice>(bus, i + 1, mb, cfg));
+  }
+  for (uint64_t t = 0; t <= 5000; t += 5)
+    for (auto& d : devs) d->tick(t);
+
+  EXPECT_LE(mb.reads, 20 * 5 + 1);
+  EXPECT_GE(mb.reads, 20 * 5 - 5);
+  EXPECT_GT(budget.denied(), 0u);
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include <core/metric_bus.h>
+#include <core/metric.h>
+#include <core/ids.h>
+
+#include "register_block_cache.h"
+#include "tilt_wt901c.h"
+#include "clock.h"
+#include "modbus.h"
+
+using namespace core;
+using namespace devices;
+
+namespace {
+
+class ManualClock : public IClock {
+public:
+  uint64_t now{1000};
+  uint64_t millis64() override { return now; }
+};
+
+// Registerwert = Registeradresse, zählt Transaktionen
+class CountingModbus : public IModbusClient {
+public:
+  int  reads{0};
+  bool ok{true};
+  uint16_t last_reg{0}, last_n{0};
+  bool read_holding(uint8_t, uint16_t reg, uint16_t n, ModbusRegs& out, uint32_t) override {
+    ++reads;
+    last_reg = reg;
+    last_n   = n;
+    if (!ok) return false;
+    out.resize(n);
+    for (uint16_t i = 0; i < n; ++i) out[i] = static_cast<uint16_t>(reg + i);
+    return true;
+  }
+};
+
+} // namespace
+
+TEST(RegisterBlockCache, MergesAdjacentAndOverlappingRanges) {
+  CountingModbus mb;
+  ManualClock clk;
+  RegisterBlockCache cache(mb, clk);
+
+  ASSERT_TRUE(cache.add_range(0x50, 0x34, 3));   // Beschleunigung
+  ASSERT_TRUE(cache.add_range(0x50, 0x37, 3));   // Winkelgeschwindigkeit (angrenzend)
+  ASSERT_TRUE(cache.add_range(0x50, 0x38, 4));   // überlappend
+  ASSERT_TRUE(cache.add_range(0x50, 0x40, 1));   // Lücke -> eigener Block
+  ASSERT_TRUE(cache.add_range(0x51, 0x34, 3));   // anderer Slave
+  EXPECT_FALSE(cache.add_range(0x50, 0, 0));
+  EXPECT_FALSE(cache.add_range(0x50, 0, 126));
+  EXPECT_EQ(cache.block_count(), 3u);
+
+  ModbusRegs a, b, c;
+  ASSERT_TRUE(cache.read_holding(0x50, 0x34, 3, a, 20));
+  EXPECT_EQ(mb.last_reg, 0x34);
+  EXPECT_EQ(mb.last_n, 8);    // 0x34..0x3B in einem Read
+  ASSERT_TRUE(cache.read_holding(0x50, 0x37, 3, b, 20));
+  ASSERT_TRUE(cache.read_holding(0x50, 0x38, 4, c, 20));
+  EXPECT_EQ(mb.reads, 1);
+  EXPECT_EQ(a, (ModbusRegs{0x34, 0x35, 0x36}));
+  EXPECT_EQ(c, (ModbusRegs{0x38, 0x39, 0x3A, 0x3B}));
+
+  const auto st = cache.take_cycle_stats();
+  EXPECT_EQ(st.requests, 3u);
+  EXPECT_EQ(st.transactions, 1u);
+  EXPECT_EQ(st.saved(), 2u);
+  EXPECT_EQ(cache.take_cycle_stats().requests, 0u);
+}
+
+TEST(RegisterBlockCache, MaxGapBridgesSmallHoles) {
+  CountingModbus mb;
+  ManualClock clk;
+  RegisterBlockCache::Config cfg;
+  cfg.max_gap = 4;
+  RegisterBlockCache cache(mb, clk, cfg);
+  cache.add_range(1, 0x34, 3);
+  cache.add_range(1, 0x3D, 4);   // Lücke 0x37..0x3C (6 Register) -> zu groß
+  cache.add_range(1, 0x3A, 2);   // Lücke 3 -> überbrückt, schließt auch 0x3D an
+  EXPECT_EQ(cache.block_count(), 1u);
+}
+
+TEST(RegisterBlockCache, RefetchesAfterMaxAge_WithTimestamps) {
+  CountingModbus mb;
+  ManualClock clk;
+  RegisterBlockCache::Config cfg;
+  cfg.max_age_ms = 50;
+  RegisterBlockCache cache(mb, clk, cfg);
+  cache.add_range(1, 0, 4);
+
+  ModbusRegs out;
+  uint64_t ts = 0;
+  ASSERT_TRUE(cache.read_cached(1, 0, 2, out, ts, 20));
+  EXPECT_EQ(ts, 1000u);
+  clk.now = 1049;
+  ASSERT_TRUE(cache.read_cached(1, 2, 2, out, ts, 20));
+  EXPECT_EQ(ts, 1000u);          // noch frisch: Zeitstempel des Bulk-Reads
+  EXPECT_EQ(mb.reads, 1);
+  clk.now = 1050;
+  ASSERT_TRUE(cache.read_cached(1, 2, 2, out, ts, 20));
+  EXPECT_EQ(ts, 1050u);
+  EXPECT_EQ(mb.reads, 2);
+}
+
+TEST(RegisterBlockCache, FailureIsCachedForOneCycle) {
+  CountingModbus mb;
+  ManualClock clk;
+  RegisterBlockCache cache(mb, clk);   // max_age 20 ms
+  cache.add_range(1, 0, 4);
+  mb.ok = false;
+
+  ModbusRegs out;
+  EXPECT_FALSE(cache.read_holding(1, 0, 2, out, 20));
+  EXPECT_FALSE(cache.read_holding(1, 2, 2, out, 20));
+  EXPECT_EQ(mb.reads, 1);   // zweiter Decoder läuft nicht erneut in den Timeout
+
+  mb.ok = true;
+  clk.now += 20;
+  EXPECT_TRUE(cache.read_holding(1, 2, 2, out, 20));
+  EXPECT_EQ(mb.reads, 2);
+}
+
+TEST(RegisterBlockCache, LearnsUnregisteredRanges) {
+  CountingModbus mb;
+  ManualClock clk;
+  RegisterBlockCache cache(mb, clk);
+
+  ModbusRegs out;
+  ASSERT_TRUE(cache.read_holding(1, 0x3D, 1, out, 20));   // unbekannt -> durchgereicht
+  ASSERT_TRUE(cache.read_holding(1, 0x3E, 2, out, 20));
+  EXPECT_EQ(mb.reads, 2);
+
+  clk.now += 100;   // nächster Zyklus: beide Bereiche als ein Block
+  ASSERT_TRUE(cache.read_holding(1, 0x3D, 1, out, 20));
+  ASSERT_TRUE(cache.read_holding(1, 0x3E, 2, out, 20));
+  EXPECT_EQ(mb.reads, 3);
+  EXPECT_EQ(out, (ModbusRegs{0x3E, 0x3F}));
+}
+
+TEST(RegisterBlockCache, TwoDecodersOnOneSlave_OneTransactionPerCycle) {
+  MetricBus bus;
+  CountingModbus mb;
+  ManualClock clk;
+  RegisterBlockCache cache(mb, clk);
+
+  Wt901cDevice::Config roll;
+  roll.modbus_addr = 0x50;
+  roll.start_reg   = 0x3D;
+  roll.reg_count   = 1;
+  Wt901cDevice::Config pitch = roll;
+  pitch.start_reg  = 0x3E;
+  cache.add_range(0x50, roll.start_reg, roll.reg_count);
+  cache.add_range(0x50, pitch.start_reg, pitch.reg_count);
+
+  Wt901cDevice a(bus, 1, cache, roll);
+  Wt901cDevice b(bus, 2, cache, pitch);
+
+  std::vector<float> got;
+  auto sub = bus.subscribe([&](const Metric& m) { got.push_back(*m.get_if<float>()); });
+
+  for (int cycle = 0; cycle < 3; ++cycle) {
+    clk.now += 50;
+    ASSERT_TRUE(a.read_once_and_publish(clk.now));
+    ASSERT_TRUE(b.read_once_and_publish(clk.now));
+  }
+  EXPECT_EQ(mb.reads, 3);
+  ASSERT_EQ(got.size(), 6u);
+  EXPECT_FLOAT_EQ(got[0], 0x3D * 0.01f);
+  EXPECT_FLOAT_EQ(got[1], 0x3E * 0.01f);
+  EXPECT_EQ(cache.stats().saved(), 3u);
+}
@@ -14,11 +14,11 @@ using namespace devices;
 class FakeModbus : public IModbusClient {
 public:
   bool ok{true};
-  std::vector<uint16_t> next_regs;
+  ModbusRegs next_regs;
   mutable uint8_t last_addr{0};
   mutable uint16_t last_reg{0}, last_n{0};
   bool read_holding(uint8_t addr, uint16_t reg, uint16_t n,
-                    std::vector<uint16_t>& out, uint32_t) override {
+                    ModbusRegs& out, uint32_t) override {
     last_addr = addr; last_reg = reg; last_n = n;
     if (!ok) return false;
     out = next_regs;
@@ -68,6 +68,25 @@ TEST(WT901C, Publishes_TiltAngle_OnSuccessfulReadAndDecode) {
   EXPECT_EQ(std::get<uint8_t>(q_it->second), static_cast<uint8_t>(Quality::Good));
 }
 
+TEST(WT901C, OutOfRangeAngle_IsClampedAndMarkedBad) {
+  MetricBus bus;
+  FakeModbus mb;
+
+  Wt901cDevice::Config cfg;
+  cfg.reg_count = 1;
+  Wt901cDevice dev(bus, 1u, mb, cfg);
+
+  std::vector<Metric> got;
+  auto sub = bus.subscribe([&](const Metric& m){ got.push_back(m); });
+
+  // int16 -20000 -> -200° -> auf -180° geclampt
+  mb.next_regs = { static_cast<uint16_t>(int16_t{-20000}) };
+  ASSERT_TRUE(dev.read_once_and_publish(10));
+  ASSERT_EQ(got.size(), 1u);
+  EXPECT_FLOAT_EQ(*got[0].get_if<float>(), -180.0f);
+  EXPECT_EQ(got[0].try_get_prop<uint8_t>(PropertyKey::Quality), static_cast<uint8_t>(Quality::Bad));
+}
+
 // TEST(WT901C, TickHonorsPollInterval) {
 //   MetricBus bus;
 //   FakeClock clk;
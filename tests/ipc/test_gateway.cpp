@@ -0,0 +1,313 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <ipc/gateway.h>
+#include <core/metric_bus.h>
+#include <core/metric.h>
+#include <core/ids.h>
+
+using namespace core;
+using namespace ipc;
+
+namespace {
+
+inline std::string sock_path(const char* tag) {
+  return "/tmp/caravan_gw_" + std::string(tag) + "_" + std::to_string(::getpid()) + ".sock";
+}
+
+int connect_unix(const std::string& path) {
+  const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un a{};
+  a.sun_family = AF_UNIX;
+  std::strncpy(a.sun_path, path.c_str(), sizeof(a.sun_path) - 1);
+  if (::connect(fd, reinterpret_cast<sockaddr*>(&a), sizeof(a)) != 0) { ::close(fd); return -1; }
+  return fd;
+}
+
+int connect_tcp(uint16_t port) {
+  const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in a{};
+  a.sin_family      = AF_INET;
+  a.sin_port        = htons(port);
+  a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (::connect(fd, reinterpret_cast<sockaddr*>(&a), sizeof(a)) != 0) { ::close(fd); return -1; }
+  return fd;
+}
+
+void send_filter(int fd, const std::vector<proto::FilterEntry>& f) {
+  const auto buf = proto::encode_filter(f);
+  ASSERT_EQ(::send(fd, buf.data(), buf.size(), 0), static_cast<ssize_t>(buf.size()));
+}
+
+bool read_exact(int fd, void* dst, std::size_t n, int timeout_ms) {
+  auto* p = static_cast<uint8_t*>(dst);
+  while (n) {
+    pollfd pfd{fd, POLLIN, 0};
+    if (::poll(&pfd, 1, timeout_ms) <= 0) return false;
+    const ssize_t r = ::recv(fd, p, n, 0);
+    if (r <= 0) return false;
+    p += r;
+    n -= static_cast<std::size_t>(r);
+  }
+  return true;
+}
+
+// Liest einen Batch-Frame; leer bei Timeout
+std::vector<MetricRecord> read_batch(int fd, int timeout_ms = 2000) {
+  proto::BatchHeader h{};
+  if (!read_exact(fd, &h, sizeof(h), timeout_ms) || h.magic != proto::kBatchMagic) return {};
+  std::vector<MetricRecord> recs(h.count);
+  if (!read_exact(fd, recs.data(), h.count * sizeof(MetricRecord), timeout_ms)) return {};
+  return recs;
+}
+
+template <typename Pred>
+bool wait_for(Pred p, int timeout_ms = 2000) {
+  const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  while (std::chrono::steady_clock::now() < end) {
+    if (p()) return true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return p();
+}
+
+struct Running {
+  explicit Running(Gateway& g) : gw(g), th([this] { gw.run(); }) {}
+  ~Running() { gw.stop(); th.join(); }
+  Gateway&    gw;
+  std::thread th;
+};
+
+inline Metric mk(uint32_t inst, MetricID id, uint32_t seq) {
+  return Metric::Make(inst, id, static_cast<float>(seq), seq, seq, {});
+}
+
+} // namespace
+
+TEST(Gateway, UnixClient_ReceivesOnlyFilteredMetrics) {
+  MetricBus bus;
+  Gateway::Config cfg;
+  cfg.unix_path      = sock_path("filter");
+  cfg.max_latency_ms = 1;
+  Gateway gw(bus, cfg);
+  std::string err;
+  ASSERT_TRUE(gw.start(&err)) << err;
+  Running loop(gw);
+
+  const int fd = connect_unix(cfg.unix_path);
+  ASSERT_GE(fd, 0);
+  send_filter(fd, {{static_cast<uint16_t>(MetricID::TiltAngle), 0, 5}});
+  ASSERT_TRUE(wait_for([&] { return gw.stats().clients == 1; }));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));   // Filter verarbeitet
+
+  bus.publish(mk(6, MetricID::TiltAngle, 1));
+  bus.publish(mk(5, MetricID::Health, 2));
+  bus.publish(mk(5, MetricID::TiltAngle, 3));
+
+  const auto recs = read_batch(fd);
+  ASSERT_EQ(recs.size(), 1u);
+  EXPECT_TRUE(from_record(recs[0]) == mk(5, MetricID::TiltAngle, 3));
+  ::close(fd);
+}
+
+TEST(Gateway, TcpClient_BatchesWithinLatencyCap) {
+  MetricBus bus;
+  Gateway::Config cfg;
+  cfg.tcp            = true;
+  cfg.batch_bytes    = 1 << 20;   // nur die Latenzgrenze löst aus
+  cfg.max_latency_ms = 50;
+  Gateway gw(bus, cfg);
+  std::string err;
+  ASSERT_TRUE(gw.start(&err)) << err;
+  ASSERT_NE(gw.tcp_port(), 0);
+  Running loop(gw);
+
+  const int fd = connect_tcp(gw.tcp_port());
+  ASSERT_GE(fd, 0);
+  send_filter(fd, {{proto::kAnyMetric, 0, proto::kAnyInstance}});
+  ASSERT_TRUE(wait_for([&] { return gw.stats().clients == 1; }));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  for (uint32_t i = 1; i <= 100; ++i) bus.publish(mk(1, MetricID::Temperature, i));
+
+  std::size_t total = 0, frames = 0;
+  uint32_t last = 0;
+  while (total < 100) {
+    const auto recs = read_batch(fd);
+    ASSERT_FALSE(recs.empty());
+    ++frames;
+    total += recs.size();
+    for (auto& r : recs) { EXPECT_GT(r.seq, last); last = r.seq; }
+  }
+  EXPECT_EQ(total, 100u);
+  EXPECT_LT(frames, 10u);   // gebündelt, nicht ein Frame pro Metric
+  ::close(fd);
+}
+
+TEST(Gateway, SlowClient_IsDisconnected) {
+  MetricBus bus;
+  Gateway::Config cfg;
+  cfg.unix_path        = sock_path("slow");
+  cfg.out_buffer_bytes = 8 * 1024;
+  cfg.slow             = Gateway::SlowClientPolicy::Disconnect;
+  cfg.max_latency_ms   = 1;
+  Gateway gw(bus, cfg);
+  ASSERT_TRUE(gw.start());
+  Running loop(gw);
+
+  const int fd = connect_unix(cfg.unix_path);
+  ASSERT_GE(fd, 0);
+  send_filter(fd, {{proto::kAnyMetric, 0, proto::kAnyInstance}});
+  ASSERT_TRUE(wait_for([&] { return gw.stats().clients == 1; }));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  // Client liest nie -> Socketpuffer voll -> Gateway-Puffer läuft über
+  for (uint32_t i = 1; gw.stats().slow_disconnects == 0 && i < 2'000'000; ++i) {
+    bus.publish(mk(i, MetricID::Temperature, i));
+    if (i % 1000 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_TRUE(wait_for([&] { return gw.stats().slow_disconnects == 1 && gw.stats().clients == 0; }));
+  ::close(fd);
+}
+
+TEST(Gateway, SlowClient_ConflatesToLatestValue) {
+  MetricBus bus;
+  Gateway::Config cfg;
+  cfg.unix_path        = sock_path("conflate");
+  cfg.out_buffer_bytes = 8 * 1024;
+  cfg.slow             = Gateway::SlowClientPolicy::Conflate;
+  cfg.max_latency_ms   = 1;
+  Gateway gw(bus, cfg);
+  ASSERT_TRUE(gw.start());
+  Running loop(gw);
+
+  const int fd = connect_unix(cfg.unix_path);
+  ASSERT_GE(fd, 0);
+  send_filter(fd, {{proto::kAnyMetric, 0, proto::kAnyInstance}});
+  ASSERT_TRUE(wait_for([&] { return gw.stats().clients == 1; }));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  // wenige Schlüssel, sehr viele Updates, Client liest zunächst nicht
+  uint32_t seq = 0;
+  while (gw.stats().conflated == 0 && seq < 2'000'000) {
+    ++seq;
+    bus.publish(mk(seq % 4, MetricID::Temperature, seq));
+    if (seq % 1000 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_GT(gw.stats().conflated, 0u);
+  EXPECT_EQ(gw.stats().slow_disconnects, 0u);
+
+  // jetzt lesen: der neueste Wert kommt an
+  bool got_last = false;
+  for (int i = 0; i < 100000 && !got_last; ++i) {
+    const auto recs = read_batch(fd, 500);
+    if (recs.empty()) break;
+    for (auto& r : recs) got_last |= (r.seq == seq);
+  }
+  EXPECT_TRUE(got_last);
+  ::close(fd);
+}
+
+TEST(Gateway, FullInbox_ConflatesAndDropsNewKeys) {
+  MetricBus bus;
+  Gateway::Config cfg;
+  cfg.unix_path      = sock_path("inbox");
+  cfg.max_inbox      = 8;
+  cfg.max_latency_ms = 1;
+  Gateway gw(bus, cfg);
+  ASSERT_TRUE(gw.start());
+
+  const int fd = connect_unix(cfg.unix_path);
+  ASSERT_GE(fd, 0);
+  send_filter(fd, {{proto::kAnyMetric, 0, proto::kAnyInstance}});
+  ASSERT_TRUE(wait_for([&] { gw.run_once(1); return gw.stats().clients == 1; }));
+  gw.run_once(5);   // Filter übernehmen
+
+  // Gateway-Schleife steht: 8 Schlüssel füllen die Inbox
+  uint32_t seq = 0;
+  for (uint32_t inst = 0; inst < 8; ++inst) bus.publish(mk(inst, MetricID::Temperature, ++seq));
+  for (int i = 0; i < 10; ++i) bus.publish(mk(i % 4, MetricID::Temperature, ++seq));
+  for (uint32_t inst = 100; inst < 105; ++inst) bus.publish(mk(inst, MetricID::Temperature, ++seq));
+
+  auto st = gw.stats();
+  EXPECT_EQ(st.inbox_conflated, 10u);
+  EXPECT_EQ(st.inbox_dropped, 5u);
+
+  // nach dem Aufholen: jeder Schlüssel einmal, mit dem neuesten Wert
+  std::vector<MetricRecord> got;
+  ASSERT_TRUE(wait_for([&] {
+    gw.run_once(1);
+    pollfd pfd{fd, POLLIN, 0};
+    if (::poll(&pfd, 1, 0) > 0) {
+      const auto recs = read_batch(fd, 100);
+      got.insert(got.end(), recs.begin(), recs.end());
+    }
+    return got.size() >= 8;
+  }));
+  ASSERT_EQ(got.size(), 8u);
+  const uint32_t latest[4] = {17, 18, 15, 16};   // letzte Updates aus seq 9..18
+  for (const auto& r : got) {
+    if (r.instance_id < 4) EXPECT_EQ(r.seq, latest[r.instance_id]) << r.instance_id;
+    else                   EXPECT_EQ(r.seq, r.instance_id + 1);
+  }
+
+  // Inbox wieder frei: neue Schlüssel kommen durch
+  bus.publish(mk(200, MetricID::Temperature, ++seq));
+  EXPECT_EQ(gw.stats().inbox_dropped, 5u);
+  ::close(fd);
+}
+
+TEST(Gateway, FullInbox_KeepsEveryAlarmEdge) {
+  MetricBus bus;
+  Gateway::Config cfg;
+  cfg.unix_path      = sock_path("alarm");
+  cfg.max_inbox      = 8;
+  cfg.max_latency_ms = 1;
+  Gateway gw(bus, cfg);
+  ASSERT_TRUE(gw.start());
+
+  const int fd = connect_unix(cfg.unix_path);
+  ASSERT_GE(fd, 0);
+  send_filter(fd, {{proto::kAnyMetric, 0, proto::kAnyInstance}});
+  ASSERT_TRUE(wait_for([&] { gw.run_once(1); return gw.stats().clients == 1; }));
+  gw.run_once(5);
+
+  // Inbox voll, dann Alarm an/aus und Health auf demselben Schlüssel
+  uint32_t seq = 0;
+  for (uint32_t inst = 0; inst < 8; ++inst) bus.publish(mk(inst, MetricID::Temperature, ++seq));
+  bus.publish(Metric::Make(9001, MetricID::Alarm, true, 100, 101, {}));
+  bus.publish(Metric::Make(9001, MetricID::Alarm, false, 101, 102, {}));
+  bus.publish(Metric::Make(7, MetricID::Health, int32_t{1}, 102, 103, {}));
+  bus.publish(Metric::Make(7, MetricID::Health, int32_t{0}, 103, 104, {}));
+  bus.publish(mk(100, MetricID::Temperature, ++seq));   // neuer Schlüssel: verworfen
+  EXPECT_EQ(gw.stats().inbox_dropped, 1u);
+  EXPECT_EQ(gw.stats().inbox_conflated, 0u);
+
+  std::vector<uint32_t> high;
+  std::size_t total = 0;
+  ASSERT_TRUE(wait_for([&] {
+    gw.run_once(1);
+    pollfd pfd{fd, POLLIN, 0};
+    if (::poll(&pfd, 1, 0) > 0) {
+      for (const auto& r : read_batch(fd, 100)) {
+        ++total;
+        if (r.seq > 100) high.push_back(r.seq);
+      }
+    }
+    return total >= 12;
+  }));
+  EXPECT_EQ(total, 12u);
+  EXPECT_EQ(high, (std::vector<uint32_t>{101, 102, 103, 104}));   // beide Flanken, in Reihenfolge
+  ::close(fd);
+}
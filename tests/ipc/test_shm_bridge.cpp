@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <ipc/shm_bridge.h>
+#include <core/metric_bus.h>
+#include <core/metric.h>
+#include <core/ids.h>
+
+using namespace core;
+using namespace ipc;
+
+namespace {
+// eindeutiger Segmentname pro Test-Prozess
+inline std::string seg_name(const char* tag) {
+  return std::string("caravan_test_") + tag + "_" + std::to_string(::getpid());
+}
+
+inline Metric mk(uint32_t seq) {
+  Metric::PropMap p;
+  p.emplace(PropertyKey::Unit, static_cast<uint8_t>(Unit::Degree));
+  return Metric::Make(5, MetricID::TiltAngle, static_cast<float>(seq) * 0.5f, 1000 + seq, seq, p);
+}
+} // namespace
+
+TEST(ShmBridge, MirrorsBusIntoLocalBus) {
+  MetricBus hub;
+  std::string err;
+  auto w = ShmBridgeWriter::create(hub, seg_name("mirror"), 64, &err);
+  ASSERT_TRUE(w) << err;
+  auto r = ShmBridgeReader::open(w->name(), ShmBridgeReader::Start::Tail, &err);
+  ASSERT_TRUE(r) << err;
+
+  MetricBus local;
+  std::vector<Metric> got;
+  auto sub = local.subscribe([&](const Metric& m) { got.push_back(m); });
+  ShmBusAdapter adapter(*r, local);
+
+  for (uint32_t i = 1; i <= 10; ++i) hub.publish(mk(i));
+  EXPECT_EQ(adapter.pump(), 10u);
+
+  ASSERT_EQ(got.size(), 10u);
+  EXPECT_TRUE(got[9] == mk(10));
+  EXPECT_EQ(r->overruns(), 0u);
+  EXPECT_EQ(adapter.pump(), 0u);
+}
+
+TEST(ShmBridge, DetectsOverrun) {
+  MetricBus hub;
+  std::string err;
+  auto w = ShmBridgeWriter::create(hub, seg_name("overrun"), 16, &err);
+  ASSERT_TRUE(w) << err;
+  ASSERT_EQ(w->capacity(), 16u);
+  auto r = ShmBridgeReader::open(w->name(), ShmBridgeReader::Start::Tail, &err);
+  ASSERT_TRUE(r) << err;
+
+  for (uint32_t i = 1; i <= 40; ++i) hub.publish(mk(i));
+
+  MetricRecord rec;
+  ASSERT_TRUE(r->read(rec));
+  EXPECT_EQ(rec.seq, 25u);             // die ältesten 24 sind überschrieben
+  EXPECT_EQ(r->overruns(), 24u);
+
+  uint64_t n = 1;
+  while (r->read(rec)) ++n;
+  EXPECT_EQ(n, 16u);
+  EXPECT_EQ(rec.seq, 40u);
+}
+
+TEST(ShmBridge, MultipleReadersAndStartOldest) {
+  MetricBus hub;
+  std::string err;
+  auto w = ShmBridgeWriter::create(hub, seg_name("multi"), 32, &err);
+  ASSERT_TRUE(w) << err;
+
+  for (uint32_t i = 1; i <= 5; ++i) hub.publish(mk(i));
+
+  auto tail   = ShmBridgeReader::open(w->name(), ShmBridgeReader::Start::Tail);
+  auto oldest = ShmBridgeReader::open(w->name(), ShmBridgeReader::Start::Oldest);
+  ASSERT_TRUE(tail && oldest);
+
+  hub.publish(mk(6));
+
+  MetricRecord rec;
+  std::vector<uint32_t> a, b;
+  while (tail->read(rec))   a.push_back(rec.seq);
+  while (oldest->read(rec)) b.push_back(rec.seq);
+  EXPECT_EQ(a, (std::vector<uint32_t>{6}));
+  EXPECT_EQ(b, (std::vector<uint32_t>{1, 2, 3, 4, 5, 6}));
+}
+
+TEST(ShmBridge, ConcurrentWriterAndReader_InOrder) {
+  MetricBus hub;
+  std::string err;
+  auto w = ShmBridgeWriter::create(hub, seg_name("conc"), 1024, &err);
+  ASSERT_TRUE(w) << err;
+  auto r = ShmBridgeReader::open(w->name());
+  ASSERT_TRUE(r);
+
+  constexpr uint32_t kN = 20000;
+  std::thread pub([&] { for (uint32_t i = 1; i <= kN; ++i) hub.publish(mk(i)); });
+
+  MetricRecord rec;
+  uint32_t last = 0;
+  bool ordered = true;
+  while (last < kN) {
+    if (!r->read(rec)) { std::this_thread::yield(); continue; }
+    if (rec.seq <= last) ordered = false;
+    last = rec.seq;
+  }
+  pub.join();
+
+  EXPECT_TRUE(ordered);
+  EXPECT_EQ(r->received() + r->overruns(), kN);
+}
+
+TEST(ShmBridge, SecondWriterFailsUnlessTakeover) {
+  MetricBus hub;
+  std::string err;
+  auto w1 = ShmBridgeWriter::create(hub, seg_name("excl"), 16, &err);
+  ASSERT_TRUE(w1) << err;
+  auto r1 = ShmBridgeReader::open(w1->name(), ShmBridgeReader::Start::Tail, &err);
+  ASSERT_TRUE(r1) << err;
+  hub.publish(mk(1));
+
+  // zweiter Schreiber darf das Segment nicht neu initialisieren
+  EXPECT_FALSE(ShmBridgeWriter::create(hub, seg_name("excl"), 16, &err));
+  EXPECT_NE(err.find("exists"), std::string::npos) << err;
+  MetricRecord rec;
+  ASSERT_TRUE(r1->read(rec));
+  EXPECT_EQ(rec.seq, 1u);
+
+  // bewusste Übernahme: neues Segment, der alte Schreiber entfernt es nicht
+  MetricBus hub2;
+  auto w2 = ShmBridgeWriter::create(hub2, seg_name("excl"), 16, &err, ShmBridgeWriter::Create::Takeover);
+  ASSERT_TRUE(w2) << err;
+  w1.reset();
+  auto r2 = ShmBridgeReader::open(w2->name(), ShmBridgeReader::Start::Tail, &err);
+  ASSERT_TRUE(r2) << err;
+  hub2.publish(mk(2));
+  ASSERT_TRUE(r2->read(rec));
+  EXPECT_EQ(rec.seq, 2u);
+  EXPECT_FALSE(r1->read(rec));   // altes Segment bekommt nichts mehr
+}
+
+TEST(ShmBridge, OpenMissingSegmentFails) {
+  std::string err;
+  EXPECT_FALSE(ShmBridgeReader::open(seg_name("missing"), ShmBridgeReader::Start::Tail, &err));
+  EXPECT_FALSE(err.empty());
+}